@@ -28,6 +28,10 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/timestepping/SimulatorReport.cpp
   opm/simulators/flow/MissingFeatures.cpp
   opm/simulators/linalg/ExtractParallelGridInformationToISTL.cpp
+  opm/simulators/linalg/bda/BdaBridge.cpp
+  opm/simulators/linalg/bda/cpuSolverBackend.cpp
+  opm/simulators/linalg/bda/MultisegmentWellContribution.cpp
+  opm/simulators/linalg/bda/WellContributions.cpp
   opm/simulators/timestepping/TimeStepControl.cpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.cpp
   opm/simulators/timestepping/SimulatorTimer.cpp
@@ -36,19 +40,21 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/utils/gatherDeferredLogger.cpp
   opm/simulators/utils/moduleVersion.cpp
   opm/simulators/utils/ParallelRestart.cpp
+  opm/simulators/utils/TimingRegistry.cpp
   opm/simulators/wells/VFPProdProperties.cpp
   opm/simulators/wells/VFPInjProperties.cpp
+  opm/simulators/wells/GroupRates.cpp
+  opm/simulators/wells/GroupTree.cpp
   opm/simulators/wells/WellGroupHelpers.cpp
   )
 
 if(CUDA_FOUND)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/cusparseSolverBackend.cu)
   list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/WellContributions.cu)
-  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/MultisegmentWellContribution.cpp)
-  list (APPEND MAIN_SOURCE_FILES opm/simulators/linalg/bda/BdaBridge.cpp)
 endif()
 if(MPI_FOUND)
-  list(APPEND MAIN_SOURCE_FILES opm/simulators/utils/ParallelEclipseState.cpp
+  list(APPEND MAIN_SOURCE_FILES opm/simulators/utils/DeckCache.cpp
+                                opm/simulators/utils/ParallelEclipseState.cpp
                                 opm/simulators/utils/ParallelSerialization.cpp)
 endif()
 
@@ -59,16 +65,22 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_ecl_output.cc
   tests/test_blackoil_amg.cpp
   tests/test_convergencereport.cpp
+  tests/test_cpusolverbackend.cpp
   tests/test_flexiblesolver.cpp
   tests/test_preconditionerfactory.cpp
   tests/test_graphcoloring.cpp
   tests/test_vfpproperties.cpp
   tests/test_milu.cpp
   tests/test_multmatrixtransposed.cpp
+  tests/test_mswellhelpers.cpp
   tests/test_nncsorter.cpp
+  tests/test_blackoilmodel.cpp
   tests/test_wellmodel.cpp
+  tests/test_wellcoloring.cpp
   tests/test_deferredlogger.cpp
   tests/test_timer.cpp
+  tests/test_timingregistry.cpp
+  tests/test_regionaggregator.cpp
   tests/test_invert.cpp
   tests/test_stoppedwells.cpp
   tests/test_relpermdiagnostics.cpp
@@ -77,12 +89,13 @@ list (APPEND TEST_SOURCE_FILES
   )
 
 if(MPI_FOUND)
-  list(APPEND TEST_SOURCE_FILES tests/test_parallelistlinformation.cpp
-                                tests/test_ParallelRestart.cpp)
+  list(APPEND TEST_SOURCE_FILES tests/test_ParallelRestart.cpp
+                                tests/test_deckcache.cpp)
 endif()
 
 list (APPEND TEST_DATA_FILES
   tests/SUMMARY_DECK_NON_CONSTANT_POROSITY.DATA
+  tests/DRSDT_CHOP.DATA
   tests/equil_base.DATA
   tests/equil_capillary.DATA
   tests/equil_capillary_overlap.DATA
@@ -108,6 +121,7 @@ list (APPEND TEST_DATA_FILES
   tests/wells_manager_data_expanded.data
   tests/wells_manager_data_wellSTOP.data
   tests/wells_group.data
+  tests/wells_group_tree.data
   tests/wells_stopped.data
   tests/relpermDiagnostics.DATA
   tests/norne_pvt.data
@@ -143,6 +157,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/aquifers/BlackoilAquiferModel_impl.hpp
   opm/simulators/linalg/bda/BdaBridge.hpp
   opm/simulators/linalg/bda/BdaResult.hpp
+  opm/simulators/linalg/bda/cpuSolverBackend.hpp
   opm/simulators/linalg/bda/cuda_header.hpp
   opm/simulators/linalg/bda/cusparseSolverBackend.hpp
   opm/simulators/linalg/bda/MultisegmentWellContribution.hpp
@@ -154,6 +169,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/ExtractParallelGridInformationToISTL.hpp
   opm/simulators/linalg/FlexibleSolver.hpp
   opm/simulators/linalg/FlowLinearSolverParameters.hpp
+  opm/simulators/linalg/GlobalDotProducts.hpp
   opm/simulators/linalg/GraphColoring.hpp
   opm/simulators/linalg/ISTLSolverEbos.hpp
   opm/simulators/linalg/ISTLSolverEbosFlexible.hpp
@@ -164,10 +180,12 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/linalg/ParallelOverlappingILU0.hpp
   opm/simulators/linalg/ParallelRestrictedAdditiveSchwarz.hpp
   opm/simulators/linalg/ParallelIstlInformation.hpp
+  opm/simulators/linalg/PipelinedBiCGSTABSolver.hpp
   opm/simulators/linalg/PressureSolverPolicy.hpp
   opm/simulators/linalg/PressureTransferPolicy.hpp
   opm/simulators/linalg/PreconditionerFactory.hpp
   opm/simulators/linalg/PreconditionerWithUpdate.hpp
+  opm/simulators/linalg/SStepGMResSolver.hpp
   opm/simulators/linalg/WriteSystemMatrixHelper.hpp
   opm/simulators/linalg/findOverlapRowsAndColumns.hpp
   opm/simulators/linalg/getQuasiImpesWeights.hpp
@@ -182,6 +200,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/timestepping/SimulatorTimerInterface.hpp
   opm/simulators/timestepping/gatherConvergenceReport.hpp
   opm/simulators/utils/ParallelFileMerger.hpp
+  opm/simulators/utils/DeckCache.hpp
   opm/simulators/utils/DeferredLoggingErrorHelpers.hpp
   opm/simulators/utils/DeferredLogger.hpp
   opm/simulators/utils/gatherDeferredLogger.hpp
@@ -189,16 +208,21 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/utils/ParallelEclipseState.hpp
   opm/simulators/utils/ParallelRestart.hpp
   opm/simulators/utils/PropsCentroidsDataHandle.hpp
+  opm/simulators/utils/RegionAggregator.hpp
+  opm/simulators/utils/TimingRegistry.hpp
   opm/simulators/wells/PerforationData.hpp
   opm/simulators/wells/RateConverter.hpp
   opm/simulators/wells/SimFIBODetails.hpp
   opm/simulators/wells/TargetCalculator.hpp
+  opm/simulators/wells/WellColoring.hpp
   opm/simulators/wells/WellConnectionAuxiliaryModule.hpp
   opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp
   opm/simulators/wells/VFPProperties.hpp
   opm/simulators/wells/VFPHelpers.hpp
   opm/simulators/wells/VFPInjProperties.hpp
   opm/simulators/wells/VFPProdProperties.hpp
+  opm/simulators/wells/GroupRates.hpp
+  opm/simulators/wells/GroupTree.hpp
   opm/simulators/wells/WellGroupHelpers.hpp
   opm/simulators/wells/WellHelpers.hpp
   opm/simulators/wells/WellInterface.hpp
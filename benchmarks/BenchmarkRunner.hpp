@@ -0,0 +1,241 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BENCHMARKRUNNER_HEADER_INCLUDED
+#define OPM_BENCHMARKRUNNER_HEADER_INCLUDED
+
+#include <opm/simulators/utils/moduleVersion.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Opm
+{
+
+    /// Driver of the micro-benchmarks of the simulator kernels.
+    ///
+    /// Every benchmark is run for a list of problem sizes. A kernel is
+    /// called once to warm up and then repeatedly until both the minimum
+    /// number of repetitions and the minimum time are reached. The
+    /// processes are synchronized before every call and the slowest
+    /// process determines the time of a call. The results are printed
+    /// as a table and written as JSON, one object per benchmark and size.
+    ///
+    /// Command line options:
+    ///   --sizes=10,20,40     problem sizes, the meaning depends on the benchmark
+    ///   --repetitions=N      minimum number of timed calls (default 5)
+    ///   --min-time=T         minimum total time in seconds (default 0.5)
+    ///   --filter=STR         only run benchmarks whose name contains STR
+    ///   --output=FILE        JSON output file (default <suite>.json)
+    class BenchmarkRunner
+    {
+    public:
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+        BenchmarkRunner(const std::string& suite, const std::vector<int>& defaultSizes,
+                        int argc, char** argv)
+            : suite_(suite)
+            , comm_(Dune::MPIHelper::getCollectiveCommunication())
+            , sizes_(defaultSizes)
+            , repetitions_(5)
+            , min_time_(0.5)
+            , output_(suite + ".json")
+        {
+            for (int i = 1; i < argc; ++i) {
+                const std::string arg = argv[i];
+                const auto pos = arg.find('=');
+                const std::string key = arg.substr(0, pos);
+                const std::string value = pos == std::string::npos ? "" : arg.substr(pos + 1);
+                if (key == "--sizes") {
+                    sizes_.clear();
+                    std::istringstream is(value);
+                    std::string size;
+                    while (std::getline(is, size, ',')) {
+                        sizes_.push_back(std::atoi(size.c_str()));
+                    }
+                }
+                else if (key == "--repetitions") {
+                    repetitions_ = std::max(1, std::atoi(value.c_str()));
+                }
+                else if (key == "--min-time") {
+                    min_time_ = std::atof(value.c_str());
+                }
+                else if (key == "--filter") {
+                    filter_ = value;
+                }
+                else if (key == "--output") {
+                    output_ = value;
+                }
+                else {
+                    unknown_.push_back(arg);
+                }
+            }
+
+            if (comm_.rank() == 0) {
+                std::cout << std::left << std::setw(32) << "Benchmark"
+                          << std::right << std::setw(8) << "Size"
+                          << std::setw(10) << "Calls"
+                          << std::setw(14) << "Min [s]"
+                          << std::setw(14) << "Median [s]"
+                          << std::setw(14) << "Mean [s]" << std::endl;
+            }
+        }
+
+        /// The problem sizes to run.
+        const std::vector<int>& sizes() const { return sizes_; }
+
+        /// Arguments not understood by the runner, e.g. simulator parameters.
+        const std::vector<std::string>& unknownArguments() const { return unknown_; }
+
+        const Communication& comm() const { return comm_; }
+
+        /// Whether the benchmark is selected by --filter.
+        bool enabled(const std::string& name) const
+        {
+            return name.find(filter_) != std::string::npos;
+        }
+
+        /// Time kernel() for the given size.
+        /// \param unknowns  number of unknowns or evaluations per call, reported
+        ///                  for computing throughputs
+        template <class Kernel>
+        void run(const std::string& name, int size, std::size_t unknowns, Kernel&& kernel)
+        {
+            if (!enabled(name)) {
+                return;
+            }
+
+            kernel();
+
+            std::vector<double> times;
+            double total = 0.0;
+            while (static_cast<int>(times.size()) < repetitions_ || total < min_time_) {
+                comm_.barrier();
+                const auto start = std::chrono::steady_clock::now();
+                kernel();
+                const auto stop = std::chrono::steady_clock::now();
+                double seconds = std::chrono::duration<double>(stop - start).count();
+                seconds = comm_.max(seconds);
+                times.push_back(seconds);
+                total += seconds;
+            }
+
+            Result result;
+            result.name = name;
+            result.size = size;
+            result.unknowns = unknowns;
+            result.repetitions = times.size();
+            std::sort(times.begin(), times.end());
+            result.min = times.front();
+            result.median = times[times.size() / 2];
+            result.mean = total / times.size();
+            results_.push_back(result);
+
+            if (comm_.rank() == 0) {
+                std::cout << std::left << std::setw(32) << name
+                          << std::right << std::setw(8) << size
+                          << std::setw(10) << result.repetitions
+                          << std::scientific << std::setprecision(3)
+                          << std::setw(14) << result.min
+                          << std::setw(14) << result.median
+                          << std::setw(14) << result.mean << std::endl;
+            }
+        }
+
+        /// Write the results collected so far to the JSON file.
+        void write() const
+        {
+            if (comm_.rank() != 0) {
+                return;
+            }
+
+            int threads = 1;
+#ifdef _OPENMP
+            threads = omp_get_max_threads();
+#endif
+            char date[32];
+            const std::time_t now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            std::ofstream os(output_);
+            os << "{\n"
+               << "  \"suite\": \"" << suite_ << "\",\n"
+               << "  \"context\": {\"date\": \"" << date << "\", "
+               << "\"version\": \"" << moduleVersion() << "\", "
+               << "\"processes\": " << comm_.size() << ", "
+               << "\"threads\": " << threads << "},\n"
+               << "  \"benchmarks\": [";
+            const char* separator = "\n";
+            for (const auto& result : results_) {
+                os << separator
+                   << "    {\"name\": \"" << result.name << "\", "
+                   << "\"size\": " << result.size << ", "
+                   << "\"unknowns\": " << result.unknowns << ", "
+                   << "\"repetitions\": " << result.repetitions << ", "
+                   << std::scientific << std::setprecision(6)
+                   << "\"min_time\": " << result.min << ", "
+                   << "\"median_time\": " << result.median << ", "
+                   << "\"mean_time\": " << result.mean << ", "
+                   << "\"time_unit\": \"s\"}";
+                separator = ",\n";
+            }
+            os << "\n  ]\n}\n";
+            std::cout << "Wrote " << output_ << std::endl;
+        }
+
+    private:
+        struct Result
+        {
+            std::string name;
+            int size;
+            std::size_t unknowns;
+            std::size_t repetitions;
+            double min;
+            double median;
+            double mean;
+        };
+
+        std::string suite_;
+        Communication comm_;
+        std::vector<int> sizes_;
+        int repetitions_;
+        double min_time_;
+        std::string filter_;
+        std::string output_;
+        std::vector<std::string> unknown_;
+        std::vector<Result> results_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_BENCHMARKRUNNER_HEADER_INCLUDED
@@ -0,0 +1,149 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmarks of the preconditioners of the linear solver on the matrix of
+// a three-phase problem on a structured n x n x n grid.
+
+#include <config.h>
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/simulators/linalg/BlackoilAmg.hpp>
+#include <opm/simulators/linalg/CPRPreconditioner.hpp>
+#include <opm/simulators/linalg/ParallelOverlappingILU0.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include <memory>
+
+namespace {
+
+constexpr int blockSize = 3;
+using MatrixBlock = Dune::FieldMatrix<double, blockSize, blockSize>;
+using Matrix = Dune::BCRSMatrix<MatrixBlock>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, blockSize>>;
+
+// Seven point stencil with a strongly coupled pressure (first unknown)
+// and weakly coupled, diagonally dominant saturations.
+void setupMatrix(Matrix& A, int n)
+{
+    const int N = n * n * n;
+    A.setSize(N, N, 7 * N);
+    A.setBuildMode(Matrix::row_wise);
+    const int offsets[3] = {1, n, n * n};
+    for (auto row = A.createbegin(); row != A.createend(); ++row) {
+        const int i = row.index();
+        const int ijk[3] = {i % n, (i / n) % n, i / (n * n)};
+        for (int d = 2; d >= 0; --d) {
+            if (ijk[d] > 0) {
+                row.insert(i - offsets[d]);
+            }
+        }
+        row.insert(i);
+        for (int d = 0; d < 3; ++d) {
+            if (ijk[d] < n - 1) {
+                row.insert(i + offsets[d]);
+            }
+        }
+    }
+
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            MatrixBlock& block = *col;
+            block = 0.0;
+            if (col.index() == row.index()) {
+                for (int k = 0; k < blockSize; ++k) {
+                    for (int l = 0; l < blockSize; ++l) {
+                        block[k][l] = (k == l) ? 6.0 + 0.1 * ((row.index() + k) % 5) : 0.1;
+                    }
+                }
+            }
+            else {
+                block[0][0] = -1.0;
+                for (int k = 1; k < blockSize; ++k) {
+                    block[k][k] = -0.1;
+                    block[k][0] = 0.05;
+                }
+            }
+        }
+    }
+}
+
+void fill(Vector& v)
+{
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        for (int k = 0; k < blockSize; ++k) {
+            v[i][k] = 1.0 + 0.1 * ((i * blockSize + k) % 7);
+        }
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    Opm::BenchmarkRunner runner("bench_linearsolver", {20, 40, 60}, argc, argv);
+
+    using ILU = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector>;
+    using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    using CouplingMetric = Opm::Amg::Element<0, 0>;
+    using Criterion = Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<Matrix, CouplingMetric>>;
+    using AMG = typename Opm::ISTLUtility::BlackoilAmgSelector<Matrix, Vector, Vector,
+                                                              Dune::Amg::SequentialInformation,
+                                                              Criterion, 0, 0>::AMG;
+
+    for (const int n : runner.sizes()) {
+        Matrix A;
+        setupMatrix(A, n);
+        const std::size_t unknowns = A.N() * blockSize;
+        Vector d(A.N()), v(A.N());
+        fill(d);
+
+        for (const bool levels : {false, true}) {
+            const std::string variant = levels ? "_levels" : "";
+            ILU ilu(A, 0, 1.0, Opm::MILU_VARIANT::ILU, false, true, levels);
+            runner.run("ilu0_update" + variant, n, unknowns, [&]() {
+                ilu.update();
+            });
+            runner.run("ilu0_apply" + variant, n, unknowns, [&]() {
+                v = 0.0;
+                ilu.apply(v, d);
+            });
+        }
+
+        Operator op(A);
+        Dune::Amg::SequentialInformation info;
+        Opm::CPRParameter param;
+        Vector weights(A.N());
+        weights = 1.0;
+        runner.run("blackoil_amg_setup", n, unknowns, [&]() {
+            std::unique_ptr<AMG> amg;
+            Opm::ISTLUtility::createAMGPreconditionerPointer<Criterion>(op, 1.0, info, amg, param, weights);
+        });
+    }
+
+    runner.write();
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmarks of simulator kernels which need a complete simulator setup.
+// The case is generated: a three-phase model on an n x n x n grid with a
+// regular pattern of vertical wells perforating all layers, once with
+// standard wells only and once with multisegment wells only. Additional
+// simulator parameters, e.g. --threads-per-process, may be given on the
+// command line. Run with mpirun to include the communication.
+
+#include <config.h>
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/simulators/flow/FlowMainEbos.hpp>
+#include <opm/simulators/flow/BlackoilModelEbos.hpp>
+
+#include <ebos/collecttoiorank.hh>
+#include <ebos/ecltransmissibility.hh>
+
+#include <opm/output/data/Groups.hpp>
+#include <opm/output/data/Solution.hpp>
+#include <opm/output/data/Wells.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+namespace {
+
+using TypeTag = TTAG(EclFlowProblem);
+using Simulator = GET_PROP_TYPE(TypeTag, Simulator);
+using Vanguard = GET_PROP_TYPE(TypeTag, Vanguard);
+using WellModel = GET_PROP_TYPE(TypeTag, EclWellModel);
+
+const char* const deckFileName = "BENCH_SIMULATOR.DATA";
+
+void writeDeck(std::ostream& os, int n, bool multisegment)
+{
+    const int cells = n * n * n;
+    const double top = 2000.0;
+    const double dz = 10.0;
+
+    // vertical wells on every fourth column, producers and injectors alternating
+    struct Well { std::string name; int i; int j; bool producer; };
+    std::vector<Well> wells;
+    for (int i = 2; i <= n; i += 4) {
+        for (int j = 2; j <= n; j += 4) {
+            const bool producer = ((i + j) / 4) % 2 == 0;
+            wells.push_back({(producer ? "P" : "I") + std::to_string(wells.size() + 1), i, j, producer});
+        }
+    }
+    const int numWells = wells.size();
+
+    os << "RUNSPEC\n"
+       << "DIMENS\n " << n << " " << n << " " << n << " /\n"
+       << "OIL\nWATER\nGAS\nDISGAS\nMETRIC\n"
+       << "START\n 1 'JAN' 2020 /\n"
+       << "WELLDIMS\n " << numWells << " " << n << " 1 " << numWells << " /\n";
+    if (multisegment) {
+        os << "WSEGDIMS\n " << numWells << " " << n + 1 << " 1 /\n";
+    }
+
+    os << "GRID\n"
+       << "DX\n " << cells << "*100 /\n"
+       << "DY\n " << cells << "*100 /\n"
+       << "DZ\n " << cells << "*" << dz << " /\n"
+       << "TOPS\n " << n * n << "*" << top << " /\n"
+       << "PORO\n " << cells << "*0.2 /\n"
+       << "PERMX\n " << cells << "*100 /\n"
+       << "PERMY\n " << cells << "*100 /\n"
+       << "PERMZ\n " << cells << "*10 /\n";
+
+    os << "PROPS\n"
+       << "PVTW\n 200 1.0 4.0E-5 0.5 0 /\n"
+       << "ROCK\n 200 5.0E-5 /\n"
+       << "DENSITY\n 850 1000 0.9 /\n"
+       << "SWOF\n 0.2 0 1 0\n 1.0 1 0 0 /\n"
+       << "SGOF\n 0 0 1 0\n 0.8 1 0 0 /\n"
+       << "PVDG\n 50 0.02 0.015\n 150 0.007 0.02\n 300 0.004 0.025 /\n"
+       << "PVTO\n 20 50 1.10 1.2\n 150 1.09 1.3 /\n 60 150 1.20 1.0\n 250 1.19 1.1 /\n/\n";
+
+    os << "SOLUTION\n"
+       << "PRESSURE\n " << cells << "*200 /\n"
+       << "SWAT\n " << cells << "*0.25 /\n"
+       << "SGAS\n " << cells << "*0 /\n"
+       << "RS\n " << cells << "*20 /\n";
+
+    os << "SCHEDULE\n"
+       << "WELSPECS\n";
+    for (const auto& well : wells) {
+        os << " '" << well.name << "' 'G1' " << well.i << " " << well.j << " 1* '"
+           << (well.producer ? "OIL" : "WATER") << "' /\n";
+    }
+    os << "/\nCOMPDAT\n";
+    for (const auto& well : wells) {
+        os << " '" << well.name << "' 2* 1 " << n << " 'OPEN' 2* 0.2 /\n";
+    }
+    os << "/\n";
+
+    if (multisegment) {
+        // one segment per layer below a top segment at the top of the reservoir
+        os << "WELSEGS\n";
+        for (const auto& well : wells) {
+            os << " '" << well.name << "' " << top << " " << top << " 1.0e-5 'ABS' 'HFA' 'HO' /\n";
+            for (int k = 1; k <= n; ++k) {
+                const double depth = top + (k - 0.5) * dz;
+                os << " " << k + 1 << " " << k + 1 << " 1 " << k << " " << depth << " " << depth
+                   << " 0.15 0.0001 /\n";
+            }
+            os << "/\n";
+        }
+        os << "COMPSEGS\n";
+        for (const auto& well : wells) {
+            os << " '" << well.name << "' /\n";
+            for (int k = 1; k <= n; ++k) {
+                os << " " << well.i << " " << well.j << " " << k << " 1 "
+                   << top + (k - 1) * dz << " " << top + k * dz << " /\n";
+            }
+            os << "/\n";
+        }
+    }
+
+    os << "WCONPROD\n";
+    for (const auto& well : wells) {
+        if (well.producer) {
+            os << " '" << well.name << "' 'OPEN' 'BHP' 5* 150 /\n";
+        }
+    }
+    os << "/\nWCONINJE\n";
+    for (const auto& well : wells) {
+        if (!well.producer) {
+            os << " '" << well.name << "' 'WATER' 'OPEN' 'RATE' 500 1* 300 /\n";
+        }
+    }
+    os << "/\nTSTEP\n 1 /\nEND\n";
+}
+
+std::unique_ptr<Simulator> createSimulator(const Opm::BenchmarkRunner& runner, int n, bool multisegment)
+{
+    if (runner.comm().rank() == 0) {
+        std::ofstream os(deckFileName);
+        writeDeck(os, n, multisegment);
+    }
+    runner.comm().barrier();
+
+    auto simulator = std::make_unique<Simulator>(/*verbose=*/false);
+    simulator->model().applyInitialSolution();
+
+    // prepare the first time step like the simulator does, this assembles the wells
+    const double dt = 86400.0;
+    simulator->setEpisodeIndex(-1);
+    simulator->startNextEpisode(simulator->startTime(), dt);
+    simulator->setEpisodeIndex(0);
+    simulator->problem().beginEpisode();
+    simulator->setTimeStepSize(dt);
+    simulator->problem().beginTimeStep();
+    simulator->problem().beginIteration();
+    return simulator;
+}
+
+void benchmarkWells(Opm::BenchmarkRunner& runner, int n, bool multisegment)
+{
+    const std::string name = multisegment ? "multisegment_well_apply" : "standard_well_apply";
+    if (!runner.enabled(name)) {
+        return;
+    }
+
+    const auto simulator = createSimulator(runner, n, multisegment);
+    const auto& wellModel = simulator->problem().wellModel();
+    const std::size_t numCells = simulator->gridView().size(0);
+    typename WellModel::BVector x(numCells), Ax(numCells);
+    x = 1.0;
+    runner.run(name, n, numCells, [&]() {
+        Ax = 0.0;
+        wellModel.apply(x, Ax);
+    });
+}
+
+void benchmarkGrid(Opm::BenchmarkRunner& runner, int n)
+{
+    if (!runner.enabled("ecl_transmissibility_update") && !runner.enabled("collect_to_io_rank")) {
+        return;
+    }
+
+    const auto simulator = createSimulator(runner, n, /*multisegment=*/false);
+    const auto& vanguard = simulator->vanguard();
+    const std::size_t numCells = simulator->gridView().size(0);
+
+    Opm::EclTransmissibility<TypeTag> transmissibility(vanguard);
+    runner.run("ecl_transmissibility_update", n, numCells, [&]() {
+        transmissibility.update(/*global=*/true);
+    });
+
+    // the cell data typically written to a restart file
+    Opm::CollectDataToIORank<Vanguard> collectToIORank(vanguard);
+    Opm::data::Solution localCellData;
+    for (const auto& key : {"PRESSURE", "SWAT", "SGAS", "RS", "RV"}) {
+        localCellData.insert(key, Opm::UnitSystem::measure::identity,
+                             std::vector<double>(numCells, 1.0),
+                             Opm::data::TargetType::RESTART_SOLUTION);
+    }
+    const std::vector<int> blockSlots;
+    const std::vector<double> blockValues;
+    const Opm::data::Wells wellData;
+    const Opm::data::Group groupData;
+    runner.run("collect_to_io_rank", n, numCells, [&]() {
+        collectToIORank.collect(localCellData, blockSlots, blockValues, wellData, groupData);
+    });
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    Opm::BenchmarkRunner runner("bench_simulator", {10, 20, 40}, argc, argv);
+
+    std::vector<std::string> args = {argv[0], std::string("--ecl-deck-file-name=") + deckFileName,
+                                     "--enable-ecl-output=false"};
+    for (const auto& arg : runner.unknownArguments()) {
+        args.push_back(arg);
+    }
+    std::vector<char*> simulatorArgv;
+    for (auto& arg : args) {
+        simulatorArgv.push_back(&arg[0]);
+    }
+    if (Opm::FlowMainEbos<TypeTag>::setupParameters_(simulatorArgv.size(), simulatorArgv.data()) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    for (const int n : runner.sizes()) {
+        benchmarkGrid(runner, n);
+        benchmarkWells(runner, n, /*multisegment=*/false);
+        benchmarkWells(runner, n, /*multisegment=*/true);
+    }
+
+    runner.write();
+    if (runner.comm().rank() == 0) {
+        std::remove(deckFileName);
+    }
+    return 0;
+}
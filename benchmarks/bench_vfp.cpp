@@ -0,0 +1,134 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Benchmarks of the bhp interpolation in a VFPPROD table with n values
+// on every axis.
+
+#include <config.h>
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
+#include <opm/simulators/wells/VFPHelpers.hpp>
+#include <opm/simulators/wells/VFPProdProperties.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Number of bhp evaluations per timed call.
+const int numEvaluations = 10000;
+
+std::vector<double> axis(int n, double max)
+{
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) {
+        values[i] = max * i / (n - 1);
+    }
+    return values;
+}
+
+std::unique_ptr<Opm::VFPProdTable> makeTable(int n)
+{
+    const auto flo = axis(n, 1000.0);
+    const auto thp = axis(n, 100.0e5);
+    const auto wfr = axis(n, 1.0);
+    const auto gfr = axis(n, 500.0);
+    const auto alq = axis(n, 1.0);
+    Opm::VFPProdTable::array_type data(n * n * n * n * n);
+    unsigned long randx = 42;
+    for (auto& value : data) {
+        randx = randx * 1103515245 + 12345;
+        value = 100.0e5 + 1.0e5 * ((randx >> 16) % 1000) / 1000.0;
+    }
+    return std::make_unique<Opm::VFPProdTable>(1, 1000.0,
+                                               Opm::VFPProdTable::FLO_OIL,
+                                               Opm::VFPProdTable::WFR_WCT,
+                                               Opm::VFPProdTable::GFR_GOR,
+                                               Opm::VFPProdTable::ALQ_UNDEF,
+                                               flo, thp, wfr, gfr, alq, data);
+}
+
+// Surface rates of a producer, negative by convention.
+struct Rates
+{
+    double aqua;
+    double liquid;
+    double vapour;
+};
+
+Rates makeRates(double oil, double waterCut, double gasOilRatio)
+{
+    return { -oil * waterCut / (1.0 - waterCut), -oil, -oil * gasOilRatio };
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    Opm::BenchmarkRunner runner("bench_vfp", {5, 10, 20}, argc, argv);
+
+    for (const int n : runner.sizes()) {
+        const auto table = makeTable(n);
+        const Opm::VFPProdProperties properties(table.get());
+
+        // Rates drifting slowly at a fixed water cut and gas-oil ratio like
+        // those of a well during a Newton iteration, and rates, water cuts
+        // and gas-oil ratios jumping across the table, such that the
+        // slice of the table is rebuilt for almost every evaluation.
+        std::vector<Rates> smooth(numEvaluations), scattered(numEvaluations);
+        unsigned long randx = 7;
+        const auto random = [&randx]() {
+            randx = randx * 1103515245 + 12345;
+            return ((randx >> 16) % 1000) / 1000.0;
+        };
+        for (int i = 0; i < numEvaluations; ++i) {
+            smooth[i] = makeRates(400.0 + 100.0 * i / numEvaluations, 0.2, 100.0);
+            const double oil = 1000.0 * random();
+            const double wct = 0.95 * random();
+            const double gor = 500.0 * random();
+            scattered[i] = makeRates(oil, wct, gor);
+        }
+
+        double sum = 0.0;
+        for (const auto& series : {std::make_pair("smooth", &smooth), std::make_pair("scattered", &scattered)}) {
+            const auto& rates = *series.second;
+            runner.run(std::string("vfp_bhp_") + series.first, n, numEvaluations, [&]() {
+                for (const auto& r : rates) {
+                    sum += properties.bhp(1, r.aqua, r.liquid, r.vapour, 20.0e5, 0.0);
+                }
+            });
+            runner.run(std::string("vfp_bhp_slice_") + series.first, n, numEvaluations, [&]() {
+                Opm::detail::VFPProdSlice slice;
+                for (const auto& r : rates) {
+                    sum += properties.bhp(1, r.aqua, r.liquid, r.vapour, 20.0e5, 0.0, slice);
+                }
+            });
+        }
+        // keep the evaluations from being optimized away
+        if (sum == 0.0) {
+            std::cout << sum << std::endl;
+        }
+    }
+
+    runner.write();
+    return 0;
+}
@@ -34,13 +34,22 @@
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
 
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/Unused.hpp>
 
 #include <dune/grid/common/mcmgmapper.hh>
 
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <map>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace Opm {
 
@@ -294,6 +303,12 @@ public:
     CollectDataToIORank(const Vanguard& vanguard)
         : toIORankComm_()
     {
+        for (const auto& node: vanguard.summaryConfig()) {
+            if (node.category() == Opm::SummaryConfigNode::Category::Block)
+                blockKeys_.emplace_back(node.keyword(), node.number());
+        }
+        globalBlockSlots_.resize(blockKeys_.size(), nullptr);
+
         // index maps only have to be build when reordering is needed
         if (!needsReordering && !isParallel())
             return;
@@ -383,6 +398,7 @@ public:
 
             // insert send and recv linkage to communicator
             toIORankComm_.insertRequest(send, recv);
+            recvRanks_.assign(recv.begin(), recv.end());
 
             // need an index map for each rank
             indexMaps_.clear();
@@ -400,6 +416,16 @@ public:
         }
     }
 
+    ~CollectDataToIORank()
+    {
+#if HAVE_MPI
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (asyncComm_ != MPI_COMM_NULL && !finalized)
+            MPI_Comm_free(&asyncComm_);
+#endif
+    }
+
     class PackUnPackCellData : public P2PCommunicatorType::DataHandleInterface
     {
         const Opm::data::Solution& localCellData_;
@@ -589,15 +615,24 @@ public:
 
     class PackUnPackBlockData : public P2PCommunicatorType::DataHandleInterface
     {
-        const std::map<std::pair<std::string, int>, double>& localBlockData_;
+        const std::vector<int>& localBlockSlots_;
+        const std::vector<double>& localBlockValues_;
+        const std::vector<std::pair<std::string, int>>& blockKeys_;
         std::map<std::pair<std::string, int>, double>& globalBlockValues_;
+        std::vector<double*>& globalBlockSlots_;
 
     public:
-        PackUnPackBlockData(const std::map<std::pair<std::string, int>, double>& localBlockData,
+        PackUnPackBlockData(const std::vector<int>& localBlockSlots,
+                            const std::vector<double>& localBlockValues,
+                            const std::vector<std::pair<std::string, int>>& blockKeys,
                             std::map<std::pair<std::string, int>, double>& globalBlockValues,
+                            std::vector<double*>& globalBlockSlots,
                             bool isIORank)
-            : localBlockData_(localBlockData)
+            : localBlockSlots_(localBlockSlots)
+            , localBlockValues_(localBlockValues)
+            , blockKeys_(blockKeys)
             , globalBlockValues_(globalBlockValues)
+            , globalBlockSlots_(globalBlockSlots)
         {
             if (isIORank) {
                 MessageBufferType buffer;
@@ -616,13 +651,12 @@ public:
             if (link != 0)
                 throw std::logic_error("link in method pack is not 0 as expected");
 
-            // write all block data
-            unsigned int size = localBlockData_.size();
+            // write all block data as (slot, value) pairs
+            unsigned int size = localBlockValues_.size();
             buffer.write(size);
-            for (const auto& map : localBlockData_) {
-                buffer.write(map.first.first);
-                buffer.write(map.first.second);
-                buffer.write(map.second);
+            for (unsigned int i = 0; i < size; ++i) {
+                buffer.write(localBlockSlots_[i]);
+                buffer.write(localBlockValues_[i]);
             }
         }
 
@@ -633,13 +667,17 @@ public:
             unsigned int size = 0;
             buffer.read(size);
             for (size_t i = 0; i < size; ++i) {
-                std::string name;
-                int idx;
+                int slot;
                 double data;
-                buffer.read(name);
-                buffer.read(idx);
+                buffer.read(slot);
                 buffer.read(data);
-                globalBlockValues_[std::make_pair(name, idx)] = data;
+
+                // The owner of a block does not change, so the map entry
+                // of a slot is created the first time it is received.
+                double*& value = globalBlockSlots_[slot];
+                if (!value)
+                    value = &globalBlockValues_[blockKeys_[slot]];
+                *value = data;
             }
         }
 
@@ -647,12 +685,14 @@ public:
 
     // gather solution to rank 0 for EclipseWriter
     void collect(const Opm::data::Solution& localCellData,
-                 const std::map<std::pair<std::string, int>, double>& localBlockData,
+                 const std::vector<int>& localBlockSlots,
+                 const std::vector<double>& localBlockValues,
                  const Opm::data::Wells& localWellData,
                 const Opm::data::Group& localGroupData)
     {
+        finishCollect();
+
         globalCellData_ = {};
-        globalBlockData_.clear();
         globalWellData_.clear();
         globalGroupData_.clear();
 
@@ -685,8 +725,11 @@ public:
 
 
         PackUnPackBlockData
-            packUnpackBlockData(localBlockData,
+            packUnpackBlockData(localBlockSlots,
+                                localBlockValues,
+                                blockKeys_,
                                 globalBlockData_,
+                                globalBlockSlots_,
                                 isIORank());
 
         toIORankComm_.exchange(packUnpackCellData);
@@ -702,6 +745,134 @@ public:
 #endif
     }
 
+    // Start gathering to the I/O rank without waiting for the transfers.
+    // The data is copied, the arguments may be changed as soon as this
+    // returns. finishCollect() has to be called on all ranks before the
+    // global data is accessed.
+    void startCollect(const Opm::data::Solution& localCellData,
+                      const std::vector<int>& localBlockSlots,
+                      const std::vector<double>& localBlockValues,
+                      const Opm::data::Wells& localWellData,
+                      const Opm::data::Group& localGroupData)
+    {
+        finishCollect();
+
+        if (!isParallel()) {
+            collect(localCellData, localBlockSlots, localBlockValues, localWellData, localGroupData);
+            return;
+        }
+
+#if HAVE_MPI
+        // use a separate communicator such that the pending messages can
+        // never be matched by the exchanges of toIORankComm_
+        if (asyncComm_ == MPI_COMM_NULL)
+            MPI_Comm_dup(toIORankComm_, &asyncComm_);
+
+        globalCellData_ = {};
+        globalWellData_.clear();
+        globalGroupData_.clear();
+
+        int size = 0;
+        if (isIORank()) {
+            // the handles copy the data of the I/O rank itself, the copy
+            // of the cell data is kept as it determines the order of the
+            // fields received from the other ranks
+            pendingCellData_ = localCellData;
+            PackUnPackCellData cellHandle(pendingCellData_, globalCellData_, localIndexMap_, indexMaps_, numCells(), true);
+            PackUnPackWellData wellHandle(localWellData, globalWellData_, true);
+            PackUnPackGroupData groupHandle(localGroupData, globalGroupData_, true);
+            PackUnPackBlockData blockHandle(localBlockSlots, localBlockValues, blockKeys_,
+                                            globalBlockData_, globalBlockSlots_, true);
+        }
+        else {
+            sendBuffer_.clear();
+            PackUnPackCellData cellHandle(localCellData, globalCellData_, localIndexMap_, indexMaps_, numCells(), false);
+            PackUnPackWellData wellHandle(localWellData, globalWellData_, false);
+            PackUnPackGroupData groupHandle(localGroupData, globalGroupData_, false);
+            PackUnPackBlockData blockHandle(localBlockSlots, localBlockValues, blockKeys_,
+                                            globalBlockData_, globalBlockSlots_, false);
+            cellHandle.pack(0, sendBuffer_);
+            wellHandle.pack(0, sendBuffer_);
+            groupHandle.pack(0, sendBuffer_);
+            blockHandle.pack(0, sendBuffer_);
+            size = sendBuffer_.buffer().second;
+        }
+
+        std::vector<int> sizes(isIORank() ? toIORankComm_.size() : 0);
+        toIORankComm_.gather(&size, sizes.data(), 1, ioRank);
+
+        if (isIORank()) {
+            recvBuffers_.resize(recvRanks_.size());
+            requests_.resize(recvRanks_.size());
+            for (std::size_t link = 0; link < recvRanks_.size(); ++link) {
+                const int rank = recvRanks_[link];
+                auto& buffer = recvBuffers_[link];
+                buffer.clear();
+                buffer.resize(sizes[rank]);
+                MPI_Irecv(buffer.buffer().first, sizes[rank], MPI_BYTE, rank, 0, asyncComm_, &requests_[link]);
+            }
+        }
+        else {
+            requests_.resize(1);
+            MPI_Isend(sendBuffer_.buffer().first, size, MPI_BYTE, ioRank, 0, asyncComm_, &requests_[0]);
+        }
+        collectPending_ = true;
+#endif
+    }
+
+    // Let the transfers started by startCollect() progress. Most MPI
+    // implementations only move non-blocking messages while the process
+    // is inside an MPI call, so this should be called regularly while a
+    // collection is pending.
+    void progressCollect()
+    {
+        if (!collectPending_)
+            return;
+
+#if HAVE_MPI
+        int done = 0;
+        MPI_Testall(static_cast<int>(requests_.size()), requests_.data(), &done, MPI_STATUSES_IGNORE);
+#endif
+    }
+
+    // Wait for the transfers started by startCollect() and unpack the
+    // received data on the I/O rank.
+    void finishCollect()
+    {
+        if (!collectPending_)
+            return;
+
+        collectPending_ = false;
+#if HAVE_MPI
+        MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+
+        if (isIORank()) {
+            const Opm::data::Wells noWells;
+            const Opm::data::Group noGroups;
+            const std::vector<int> noSlots;
+            const std::vector<double> noValues;
+            PackUnPackCellData cellHandle(pendingCellData_, globalCellData_, localIndexMap_, indexMaps_, numCells(), false);
+            PackUnPackWellData wellHandle(noWells, globalWellData_, false);
+            PackUnPackGroupData groupHandle(noGroups, globalGroupData_, false);
+            PackUnPackBlockData blockHandle(noSlots, noValues, blockKeys_,
+                                            globalBlockData_, globalBlockSlots_, false);
+            for (std::size_t link = 0; link < recvBuffers_.size(); ++link) {
+                auto& buffer = recvBuffers_[link];
+                buffer.resetReadPosition();
+                cellHandle.unpack(link, buffer);
+                wellHandle.unpack(link, buffer);
+                groupHandle.unpack(link, buffer);
+                blockHandle.unpack(link, buffer);
+            }
+            pendingCellData_ = {};
+        }
+#endif
+    }
+
+    // True if a collection started by startCollect() has not been finished.
+    bool collectPending() const
+    { return collectPending_; }
+
     const std::map<std::pair<std::string, int>, double>& globalBlockData() const
     { return globalBlockData_; }
 
@@ -759,9 +930,23 @@ protected:
     std::vector<int> globalRanks_;
     Opm::data::Solution globalCellData_;
     std::map<std::pair<std::string, int>, double> globalBlockData_;
+    // keys of all block requests of the summary config, indexed by slot
+    std::vector<std::pair<std::string, int>> blockKeys_;
+    std::vector<double*> globalBlockSlots_;
     Opm::data::Wells globalWellData_;
     Opm::data::Group globalGroupData_;
     std::vector<int> localIdxToGlobalIdx_;
+    // ranks sending to the I/O rank in the order of the links
+    std::vector<int> recvRanks_;
+    // state of the non-blocking collection
+    bool collectPending_ = false;
+    Opm::data::Solution pendingCellData_;
+    MessageBufferType sendBuffer_;
+    std::vector<MessageBufferType> recvBuffers_;
+#if HAVE_MPI
+    MPI_Comm asyncComm_ = MPI_COMM_NULL;
+    std::vector<MPI_Request> requests_;
+#endif
 };
 
 } // end namespace Opm
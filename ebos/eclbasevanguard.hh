@@ -73,6 +73,7 @@ NEW_PROP_TAG(EclDeckFileName);
 NEW_PROP_TAG(EnableOpmRstFile);
 NEW_PROP_TAG(EclStrictParsing);
 NEW_PROP_TAG(SchedRestart);
+NEW_PROP_TAG(EclDeckCacheDir);
 NEW_PROP_TAG(EclOutputInterval);
 NEW_PROP_TAG(IgnoreKeywords);
 NEW_PROP_TAG(EdgeWeightsMethod);
@@ -84,6 +85,7 @@ SET_INT_PROP(EclBaseVanguard, EclOutputInterval, -1); // use the deck-provided v
 SET_BOOL_PROP(EclBaseVanguard, EnableOpmRstFile, false);
 SET_BOOL_PROP(EclBaseVanguard, EclStrictParsing, false);
 SET_BOOL_PROP(EclBaseVanguard, SchedRestart, false);
+SET_STRING_PROP(EclBaseVanguard, EclDeckCacheDir, "");
 SET_INT_PROP(EclBaseVanguard, EdgeWeightsMethod, 1);
 SET_BOOL_PROP(EclBaseVanguard, OwnerCellsFirst, true);
 
@@ -131,6 +133,8 @@ public:
                              "Use strict mode for parsing - all errors are collected before the applicaton exists.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, SchedRestart,
                              "When restarting: should we try to initialize wells and groups from historical SCHEDULE section.");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, EclDeckCacheDir,
+                             "Directory for caching the parsed deck between runs of an unchanged case. Empty disables the cache.");
         EWOMS_REGISTER_PARAM(TypeTag, int, EdgeWeightsMethod,
                              "Choose edge-weighing strategy: 0=uniform, 1=trans, 2=log(trans).");
         EWOMS_REGISTER_PARAM(TypeTag, bool, OwnerCellsFirst,
@@ -23,6 +23,10 @@
 
 #include <opm/simulators/utils/ParallelRestart.hpp>
 
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
 namespace Opm {
 
 /*! \brief Class for (de-)serializing and broadcasting data in parallel.
@@ -34,8 +38,12 @@ class EclMpiSerializer {
 public:
     //! \brief Constructor.
     //! \param comm The global communicator to broadcast using
-    explicit EclMpiSerializer(Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm) :
-        m_comm(comm)
+    //! \param chunkSize Size of the pieces broadcast() sends at a time.
+    //!                  A single value larger than this is sent as one piece.
+    explicit EclMpiSerializer(Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator> comm,
+                              size_t chunkSize = 64*1024*1024) :
+        m_comm(comm),
+        m_chunkSize(chunkSize)
     {}
 
     //! \brief (De-)serialization for simple types.
@@ -52,9 +60,9 @@ public:
           if (m_op == Operation::PACKSIZE)
               m_packSize += Mpi::packSize(data, m_comm);
           else if (m_op == Operation::PACK)
-              Mpi::pack(data, m_buffer, m_position, m_comm);
+              packItem(data);
           else if (m_op == Operation::UNPACK)
-              Mpi::unpack(const_cast<T&>(data), m_buffer, m_position, m_comm);
+              unpackItem(const_cast<T&>(data));
         }
     }
 
@@ -83,11 +91,11 @@ public:
             m_packSize += Mpi::packSize(data.size(), m_comm);
             handle(data);
         } else if (m_op == Operation::PACK) {
-            Mpi::pack(data.size(), m_buffer, m_position, m_comm);
+            packItem(data.size());
             handle(data);
         } else if (m_op == Operation::UNPACK) {
             size_t size;
-            Mpi::unpack(size, m_buffer, m_position, m_comm);
+            unpackItem(size);
             data.resize(size);
             handle(data);
         }
@@ -124,17 +132,17 @@ public:
                 handle(it.second);
             }
         } else if (m_op == Operation::PACK) {
-            Mpi::pack(data.size(), m_buffer, m_position, m_comm);
+            packItem(data.size());
             for (auto& it : data) {
-                Mpi::pack(it.first, m_buffer, m_position, m_comm);
+                packItem(it.first);
                 handle(it.second);
             }
         } else if (m_op == Operation::UNPACK) {
             size_t size;
-            Mpi::unpack(size, m_buffer, m_position, m_comm);
+            unpackItem(size);
             for (size_t i = 0; i < size; ++i) {
                 Key key;
-                Mpi::unpack(key, m_buffer, m_position, m_comm);
+                unpackItem(key);
                 Data entry;
                 handle(entry);
                 data.insert(std::make_pair(key, entry));
@@ -171,23 +179,64 @@ public:
     //! \brief Serialize and broadcast on root process, de-serialize on others.
     //! \tparam T Type of class to broadcast
     //! \param data Class to broadcast
+    //! \details The data is sent in chunks of about chunkSize bytes, each
+    //!          chunk is de-serialized as soon as it is received. Neither
+    //!          the root nor the other processes ever hold the complete
+    //!          serialized data.
     template<class T>
     void broadcast(T& data)
     {
         if (m_comm.size() == 1)
             return;
 
+        m_chunked = true;
+        m_position = 0;
         if (m_comm.rank() == 0) {
-            pack(data);
-            m_packSize = m_position;
-            m_comm.broadcast(&m_packSize, 1, 0);
-            m_comm.broadcast(m_buffer.data(), m_position, 0);
+            m_op = Operation::PACK;
+            m_buffer.resize(m_chunkSize);
+            data.serializeOp(*this);
+            sendChunk(true);
         } else {
-            m_comm.broadcast(&m_packSize, 1, 0);
-            m_buffer.resize(m_packSize);
-            m_comm.broadcast(m_buffer.data(), m_packSize, 0);
-            unpack(data);
+            m_op = Operation::UNPACK;
+            receiveChunk();
+            data.serializeOp(*this);
+            if (static_cast<size_t>(m_position) != m_chunkLength || !m_lastChunk)
+                throw std::logic_error("Broadcast data was not completely de-serialized");
+        }
+        m_chunked = false;
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+    }
+
+    //! \brief Serialize data and write it to a stream.
+    //! \tparam T Type of class to serialize
+    //! \param data Class to serialize
+    //! \param os Stream to write to
+    template<class T>
+    void write(T& data, std::ostream& os)
+    {
+        pack(data);
+        const size_t size = m_position;
+        os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        os.write(m_buffer.data(), size);
+    }
+
+    //! \brief Read data written by write() from a stream and de-serialize it.
+    //! \tparam T Type of class to de-serialize
+    //! \param data Class to de-serialize
+    //! \param is Stream to read from
+    template<class T>
+    void read(T& data, std::istream& is)
+    {
+        size_t size = 0;
+        is.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (is) {
+            m_buffer.resize(size);
+            is.read(m_buffer.data(), size);
         }
+        if (!is)
+            throw std::runtime_error("Unexpected end of serialized data");
+        unpack(data);
     }
 
     //! \brief Returns current position in buffer.
@@ -259,6 +308,53 @@ protected:
         constexpr static bool value = true;
     };
 
+    //! \brief Packs a single value, sending the current chunk first
+    //!        during broadcast() if the value does not fit into it.
+    template<class T>
+    void packItem(const T& data)
+    {
+        if (m_chunked) {
+            const size_t size = Mpi::packSize(data, m_comm);
+            if (m_position > 0 && m_position + size > m_chunkSize)
+                sendChunk(false);
+            if (m_position + size > m_buffer.size())
+                m_buffer.resize(m_position + size);
+        }
+        Mpi::pack(data, m_buffer, m_position, m_comm);
+    }
+
+    //! \brief Unpacks a single value, receiving the next chunk first
+    //!        during broadcast() if the current one is used up.
+    template<class T>
+    void unpackItem(T& data)
+    {
+        if (m_chunked && static_cast<size_t>(m_position) == m_chunkLength && !m_lastChunk)
+            receiveChunk();
+        Mpi::unpack(data, m_buffer, m_position, m_comm);
+    }
+
+    //! \brief Broadcasts the packed part of the buffer from the root process.
+    //! \param last Whether or not this is the last chunk
+    void sendChunk(bool last)
+    {
+        size_t header[2] = {static_cast<size_t>(m_position), last};
+        m_comm.broadcast(header, 2, 0);
+        m_comm.broadcast(m_buffer.data(), m_position, 0);
+        m_position = 0;
+    }
+
+    //! \brief Receives the next chunk sent by sendChunk().
+    void receiveChunk()
+    {
+        size_t header[2];
+        m_comm.broadcast(header, 2, 0);
+        m_chunkLength = header[0];
+        m_lastChunk = header[1] != 0;
+        m_buffer.resize(m_chunkLength);
+        m_comm.broadcast(m_buffer.data(), m_chunkLength, 0);
+        m_position = 0;
+    }
+
     //! \brief Handler for pairs.
     //! \details If data is POD or a string, we pass it to the underlying serializer,
     //!          if not we assume a complex type.
@@ -298,6 +394,10 @@ protected:
     size_t m_packSize = 0; //!< Required buffer size after PACKSIZE has been done
     int m_position = 0; //!< Current position in buffer
     std::vector<char> m_buffer; //!< Buffer for serialized data
+    size_t m_chunkSize; //!< Size of the chunks sent by broadcast()
+    bool m_chunked = false; //!< True while broadcasting in chunks
+    size_t m_chunkLength = 0; //!< Length of the last received chunk
+    bool m_lastChunk = false; //!< True if the last received chunk is the final one
 };
 
 }
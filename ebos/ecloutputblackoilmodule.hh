@@ -40,9 +40,12 @@
 #include <opm/output/eclipse/EclipseIO.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <opm/simulators/utils/RegionAggregator.hpp>
+
 #include <dune/common/fvector.hh>
 
 #include <type_traits>
+#include <unordered_map>
 
 BEGIN_PROPERTIES
 
@@ -184,13 +187,43 @@ public:
         // Summary output is for all steps
         const Opm::SummaryConfig summaryConfig = simulator_.vanguard().summaryConfig();
 
-        // Initialize block output
+        // Initialize block output. The requests are numbered in the order
+        // of the summary config, this number is used as the slot when the
+        // values are collected on the I/O rank.
+        std::unordered_map<int, std::vector<int>> blockEntriesOfCell;
+        int blockSlot = 0;
         for (const auto& node: summaryConfig) {
-            if (node.category() == SummaryConfigNode::Category::Block) {
-                if (collectToIORank.isGlobalIdxOnThisRank(node.number() - 1)) {
-                    std::pair<std::string, int> key = std::make_pair(node.keyword(), node.number());
-                    blockData_[key] = 0.0;
+            if (node.category() != SummaryConfigNode::Category::Block)
+                continue;
+
+            if (collectToIORank.isGlobalIdxOnThisRank(node.number() - 1)) {
+                std::pair<std::string, int> key = std::make_pair(node.keyword(), node.number());
+                const auto quantity = blockQuantity_(node.keyword());
+                if (quantity == BlockQuantity::Unhandled) {
+                    std::string logstring = "Keyword '";
+                    logstring.append(node.keyword());
+                    logstring.append("' is unhandled for output to file.");
+                    Opm::OpmLog::warning("Unhandled output keyword", logstring);
                 }
+
+                blockEntriesOfCell[node.number() - 1].push_back(blockSlots_.size());
+                blockSlots_.push_back(blockSlot);
+                blockQuantities_.push_back(quantity);
+                blockValues_.push_back(0.0);
+                blockDataValues_.push_back(&(blockData_[key] = 0.0));
+            }
+            ++blockSlot;
+        }
+
+        // Map the local cells to their block entries.
+        if (!blockEntriesOfCell.empty()) {
+            const auto& globalCell = simulator_.vanguard().grid().globalCell();
+            blockCellStart_.assign(1, 0);
+            for (const auto cartesianIdx : globalCell) {
+                const auto it = blockEntriesOfCell.find(cartesianIdx);
+                if (it != blockEntriesOfCell.end())
+                    blockCellEntries_.insert(blockCellEntries_.end(), it->second.begin(), it->second.end());
+                blockCellStart_.push_back(blockCellEntries_.size());
             }
         }
 
@@ -687,40 +720,10 @@ public:
 
             // Adding block data
             const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-            for (auto& val: blockData_) {
-                const auto& key = val.first;
-                int cartesianIdxBlock = key.second - 1;
-                if (cartesianIdx == cartesianIdxBlock) {
-                    if (key.first == "BWSAT")
-                        val.second = Opm::getValue(fs.saturation(waterPhaseIdx));
-                    else if (key.first == "BGSAT")
-                        val.second = Opm::getValue(fs.saturation(gasPhaseIdx));
-                    else if (key.first == "BOSAT")
-                        val.second = 1. - Opm::getValue(fs.saturation(gasPhaseIdx)) - Opm::getValue(fs.saturation(waterPhaseIdx));
-                    else if (key.first == "BPR")
-                        val.second = Opm::getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BWKR" || key.first == "BKRW")
-                        val.second = Opm::getValue(intQuants.relativePermeability(waterPhaseIdx));
-                    else if (key.first == "BGKR" || key.first == "BKRG")
-                        val.second = Opm::getValue(intQuants.relativePermeability(gasPhaseIdx));
-                    else if (key.first == "BOKR" || key.first == "BKRO")
-                        val.second = Opm::getValue(intQuants.relativePermeability(oilPhaseIdx));
-                    else if (key.first == "BWPC")
-                        val.second = Opm::getValue(fs.pressure(oilPhaseIdx)) - Opm::getValue(fs.pressure(waterPhaseIdx));
-                    else if (key.first == "BGPC")
-                        val.second = Opm::getValue(fs.pressure(gasPhaseIdx)) - Opm::getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BVWAT" || key.first == "BWVIS")
-                        val.second = Opm::getValue(fs.viscosity(waterPhaseIdx));
-                    else if (key.first == "BVGAS" || key.first == "BGVIS")
-                        val.second = Opm::getValue(fs.viscosity(gasPhaseIdx));
-                    else if (key.first == "BVOIL" || key.first == "BOVIS")
-                        val.second = Opm::getValue(fs.viscosity(oilPhaseIdx));
-                    else {
-                        std::string logstring = "Keyword '";
-                        logstring.append(key.first);
-                        logstring.append("' is unhandled for output to file.");
-                        Opm::OpmLog::warning("Unhandled output keyword", logstring);
-                    }
+            if (!blockCellStart_.empty()) {
+                for (int i = blockCellStart_[globalDofIdx]; i < blockCellStart_[globalDofIdx + 1]; ++i) {
+                    const int entry = blockCellEntries_[i];
+                    blockValues_[entry] = blockValue_(blockQuantities_[entry], fs, intQuants);
                 }
             }
 
@@ -1025,10 +1028,36 @@ public:
         }
         ntFip = comm.max(ntFip);
 
-        // sum values over each region
+        // sum the fip values and the pressure weights over each region in
+        // one sweep and one reduction
+        enum { PressurePv = FipDataType::numFipValues, PvHydrocarbon, PressurePvHydrocarbon, numFields };
+        const ScalarBuffer* cellFields[numFields];
+        for (int i = 0; i < FipDataType::numFipValues; i++)
+            cellFields[i] = &fip_[i];
+        cellFields[PressurePv] = &pressureTimesPoreVolume_;
+        cellFields[PvHydrocarbon] = &hydrocarbonPoreVolume_;
+        cellFields[PressurePvHydrocarbon] = &pressureTimesHydrocarbonVolume_;
+
+        // the cells which are not attributed to any region are ignored
+        std::vector<int> cellRegions(fipnum_.size());
+        for (size_t j = 0; j < fipnum_.size(); ++j)
+            cellRegions[j] = fipnum_[j] - 1;
+
+        Opm::RegionAggregator aggregator(numFields);
+        const int fipnumMap = aggregator.addRegionMap(std::move(cellRegions), ntFip);
+        aggregator.accumulate(fipnum_.size(), [&cellFields](size_t cellIdx, double* values) {
+            for (int i = 0; i < numFields; i++)
+                values[i] = cellFields[i]->empty() ? 0.0 : (*cellFields[i])[cellIdx];
+        });
+        aggregator.reduce(comm);
+        const auto regionSums = [&aggregator, fipnumMap](int field) {
+            const auto sums = aggregator.sums(fipnumMap, field);
+            return ScalarBuffer(sums.begin(), sums.end());
+        };
+
         ScalarBuffer regionFipValues[FipDataType::numFipValues];
         for (int i = 0; i < FipDataType::numFipValues; i++) {
-            regionFipValues[i] = computeFipForRegions_(fip_[i], fipnum_, ntFip);
+            regionFipValues[i] = regionSums(i);
             if (isIORank_() && origRegionValues_[i].empty())
                 origRegionValues_[i] = regionFipValues[i];
         }
@@ -1043,9 +1072,9 @@ public:
         }
 
         // compute the hydrocarbon averaged pressure over the regions.
-        ScalarBuffer regPressurePv = computeFipForRegions_(pressureTimesPoreVolume_, fipnum_, ntFip);
-        ScalarBuffer regPvHydrocarbon = computeFipForRegions_(hydrocarbonPoreVolume_, fipnum_, ntFip);
-        ScalarBuffer regPressurePvHydrocarbon = computeFipForRegions_(pressureTimesHydrocarbonVolume_, fipnum_, ntFip);
+        ScalarBuffer regPressurePv = regionSums(PressurePv);
+        ScalarBuffer regPvHydrocarbon = regionSums(PvHydrocarbon);
+        ScalarBuffer regPressurePvHydrocarbon = regionSums(PressurePvHydrocarbon);
 
         ScalarBuffer fieldPressurePv = computeFipForRegions_(regPressurePv, fieldNum, 1, comunicateSum);
         ScalarBuffer fieldPvHydrocarbon = computeFipForRegions_(regPvHydrocarbon, fieldNum, 1, comunicateSum);
@@ -1645,10 +1674,114 @@ public:
         return 0;
     }
 
+    /*!
+     * \brief Return the block data keyed by summary keyword and cell number.
+     *
+     * The values of the last call to processElement() are copied into
+     * the map on every call.
+     */
     const std::map<std::pair<std::string, int>, double>& getBlockData()
-    { return blockData_; }
+    {
+        for (size_t entry = 0; entry < blockValues_.size(); ++entry)
+            *blockDataValues_[entry] = blockValues_[entry];
+
+        return blockData_;
+    }
+
+    /*!
+     * \brief The block data values of this process in a contiguous buffer.
+     *
+     * The position of each value in the list of block requests of the
+     * summary config is given by blockSlots().
+     */
+    const std::vector<double>& blockValues() const
+    { return blockValues_; }
+
+    const std::vector<int>& blockSlots() const
+    { return blockSlots_; }
 
 private:
+    enum class BlockQuantity {
+        Pressure,
+        WaterSaturation,
+        GasSaturation,
+        OilSaturation,
+        WaterRelPerm,
+        GasRelPerm,
+        OilRelPerm,
+        WaterCapPressure,
+        GasCapPressure,
+        WaterViscosity,
+        GasViscosity,
+        OilViscosity,
+        Unhandled
+    };
+
+    static BlockQuantity blockQuantity_(const std::string& keyword)
+    {
+        if (keyword == "BWSAT")
+            return BlockQuantity::WaterSaturation;
+        else if (keyword == "BGSAT")
+            return BlockQuantity::GasSaturation;
+        else if (keyword == "BOSAT")
+            return BlockQuantity::OilSaturation;
+        else if (keyword == "BPR")
+            return BlockQuantity::Pressure;
+        else if (keyword == "BWKR" || keyword == "BKRW")
+            return BlockQuantity::WaterRelPerm;
+        else if (keyword == "BGKR" || keyword == "BKRG")
+            return BlockQuantity::GasRelPerm;
+        else if (keyword == "BOKR" || keyword == "BKRO")
+            return BlockQuantity::OilRelPerm;
+        else if (keyword == "BWPC")
+            return BlockQuantity::WaterCapPressure;
+        else if (keyword == "BGPC")
+            return BlockQuantity::GasCapPressure;
+        else if (keyword == "BVWAT" || keyword == "BWVIS")
+            return BlockQuantity::WaterViscosity;
+        else if (keyword == "BVGAS" || keyword == "BGVIS")
+            return BlockQuantity::GasViscosity;
+        else if (keyword == "BVOIL" || keyword == "BOVIS")
+            return BlockQuantity::OilViscosity;
+        else
+            return BlockQuantity::Unhandled;
+    }
+
+    template <class FluidState, class IntensiveQuantities>
+    static double blockValue_(const BlockQuantity quantity,
+                              const FluidState& fs,
+                              const IntensiveQuantities& intQuants)
+    {
+        switch (quantity) {
+        case BlockQuantity::Pressure:
+            return Opm::getValue(fs.pressure(oilPhaseIdx));
+        case BlockQuantity::WaterSaturation:
+            return Opm::getValue(fs.saturation(waterPhaseIdx));
+        case BlockQuantity::GasSaturation:
+            return Opm::getValue(fs.saturation(gasPhaseIdx));
+        case BlockQuantity::OilSaturation:
+            return 1. - Opm::getValue(fs.saturation(gasPhaseIdx)) - Opm::getValue(fs.saturation(waterPhaseIdx));
+        case BlockQuantity::WaterRelPerm:
+            return Opm::getValue(intQuants.relativePermeability(waterPhaseIdx));
+        case BlockQuantity::GasRelPerm:
+            return Opm::getValue(intQuants.relativePermeability(gasPhaseIdx));
+        case BlockQuantity::OilRelPerm:
+            return Opm::getValue(intQuants.relativePermeability(oilPhaseIdx));
+        case BlockQuantity::WaterCapPressure:
+            return Opm::getValue(fs.pressure(oilPhaseIdx)) - Opm::getValue(fs.pressure(waterPhaseIdx));
+        case BlockQuantity::GasCapPressure:
+            return Opm::getValue(fs.pressure(gasPhaseIdx)) - Opm::getValue(fs.pressure(oilPhaseIdx));
+        case BlockQuantity::WaterViscosity:
+            return Opm::getValue(fs.viscosity(waterPhaseIdx));
+        case BlockQuantity::GasViscosity:
+            return Opm::getValue(fs.viscosity(gasPhaseIdx));
+        case BlockQuantity::OilViscosity:
+            return Opm::getValue(fs.viscosity(oilPhaseIdx));
+        case BlockQuantity::Unhandled:
+            break;
+        }
+        return 0.0;
+    }
 
     bool isIORank_() const
     {
@@ -2142,6 +2275,14 @@ private:
     ScalarBuffer pressureTimesPoreVolume_;
     ScalarBuffer pressureTimesHydrocarbonVolume_;
     std::map<std::pair<std::string, int>, double> blockData_;
+    // block entries of this process, blockDataValues_ points into blockData_
+    std::vector<int> blockSlots_;
+    std::vector<BlockQuantity> blockQuantities_;
+    std::vector<double> blockValues_;
+    std::vector<double*> blockDataValues_;
+    // entries of local cell c are blockCellEntries_[blockCellStart_[c]] to blockCellEntries_[blockCellStart_[c+1]-1]
+    std::vector<int> blockCellStart_;
+    std::vector<int> blockCellEntries_;
     std::map<size_t, Scalar> oilConnectionPressures_;
     std::map<size_t, Scalar> waterConnectionSaturations_;
     std::map<size_t, Scalar> gasConnectionSaturations_;
@@ -65,6 +65,7 @@
 #include "vtkecltracermodule.hh"
 
 #include <opm/models/utils/pffgridvector.hh>
+#include <opm/models/parallel/threadedentityiterator.hh>
 #include <opm/models/blackoil/blackoilmodel.hh>
 #include <opm/models/discretization/ecfv/ecfvdiscretization.hh>
 
@@ -311,6 +312,9 @@ SET_BOOL_PROP(EclBaseProblem, EnableEclOutput, true);
 // If available, write the ECL output in a non-blocking manner
 SET_BOOL_PROP(EclBaseProblem, EnableAsyncEclOutput, true);
 
+// Gather the restart data in a blocking manner by default
+SET_BOOL_PROP(EclBaseProblem, EnableAsyncEclCollect, false);
+
 // By default, use single precision for the ECL formated results
 SET_BOOL_PROP(EclBaseProblem, EclOutputDoublePrecision, false);
 
@@ -841,12 +845,11 @@ public:
             tuningEvent = true;
         }
 
-        const bool invalidateFromHyst = updateHysteresis_();
-        const bool invalidateFromMaxOilSat = updateMaxOilSaturation_();
-        const bool doInvalidate = invalidateFromHyst || invalidateFromMaxOilSat;
-
-        if (GET_PROP_VALUE(TypeTag, EnablePolymer))
-            updateMaxPolymerAdsorption_();
+        // the hysteresis parameters, the maximum oil saturation and the maximum
+        // polymer adsorption are updated together with the other history
+        // dependent quantities at the beginning of the first time step of the
+        // episode
+        episodeStartUpdatePending_ = true;
 
         // set up the wells for the next episode.
         wellModel_.beginEpisode();
@@ -863,9 +866,6 @@ public:
             // if TUNING is enabled, also limit the time step size after a tuning event to TSINIT
             dt = std::min(dt, initialTimeStepSize_);
         simulator.setTimeStepSize(dt);
-
-        if (doInvalidate)
-            this->model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
     }
 
     /*!
@@ -901,11 +901,12 @@ public:
             for (size_t pvtRegionIdx = 0; pvtRegionIdx < maxDRv_.size(); ++pvtRegionIdx)
                 maxDRv_[pvtRegionIdx] = oilVaporizationControl.getMaxDRVDT(pvtRegionIdx)*this->simulator().timeStepSize();
 
-        // update maximum water saturation and minimum pressure
-        // used when ROCKCOMP is activated
-        const bool invalidateFromMaxWaterSat = updateMaxWaterSaturation_();
-        const bool invalidateFromMinPressure = updateMinPressure_();
-        invalidateIntensiveQuantities = invalidateFromMaxWaterSat || invalidateFromMinPressure;
+        // update maximum water saturation and minimum pressure used when ROCKCOMP
+        // is activated and, at the start of an episode, the hysteresis
+        // parameters, the maximum oil saturation and the maximum polymer
+        // adsorption
+        invalidateIntensiveQuantities = updateCellStateHistory_(episodeStartUpdatePending_);
+        episodeStartUpdatePending_ = false;
 
         if (invalidateIntensiveQuantities)
             this->model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
@@ -946,6 +947,8 @@ public:
         wellModel_.endIteration();
         if (enableAquifers_)
             aquiferModel_.endIteration();
+        if (enableEclOutput_)
+            eclWriter_->progressOutput();
     }
 
     /*!
@@ -1185,6 +1188,19 @@ public:
     Scalar thresholdPressure(unsigned elem1Idx, unsigned elem2Idx) const
     { return thresholdPressures_.thresholdPressure(elem1Idx, elem2Idx); }
 
+    /*!
+     * \brief Return the threshold pressure for the face between the center element
+     *        of a context and one of its neighbours.
+     */
+    template <class Context>
+    Scalar thresholdPressure(const Context& context,
+                             unsigned OPM_OPTIM_UNUSED fromDofLocalIdx,
+                             unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx).thresholdPressure;
+    }
+
     const EclThresholdPressure<TypeTag>& thresholdPressure() const
     { return thresholdPressures_; }
 
@@ -1581,6 +1597,8 @@ public:
         // this point, because determining the threshold pressures may require to access
         // the initial solution.
         thresholdPressures_.finishInit();
+        // the threshold pressures are also stored with the face data
+        updatePffDofData_();
 
         updateCompositionChangeLimits_();
 
@@ -2076,93 +2094,85 @@ private:
         }
     }
 
-    bool updateMaxOilSaturation_()
+    // update the history dependent quantities of all cells in a single thread
+    // parallel sweep over the grid. Where possible, the intensive quantities are
+    // taken from the cache which was filled by the last linearization instead of
+    // being recomputed. Returns true if the intensive quantities need to be
+    // invalidated because of the update.
+    bool updateCellStateHistory_(bool episodeStart)
     {
         const auto& simulator = this->simulator();
 
-        // we use VAPPARS
-        if (vapparsActive()) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = iq.fluidState();
-
-                Scalar So = Opm::decay<Scalar>(fs.saturation(oilPhaseIdx));
-
-                maxOilSaturation_[compressedDofIdx] = std::max(maxOilSaturation_[compressedDofIdx], So);
-            }
-
-            // we need to invalidate the intensive quantities cache here because the
-            // derivatives of Rs and Rv will most likely have changed
-            return true;
-        }
-
-        return false;
-    }
-
-    bool updateMaxWaterSaturation_()
-    {
+        // the hysteresis parameters, the maximum oil saturation (VAPPARS) and the
+        // maximum polymer adsorption are only updated at the start of an episode
+        const bool updateHysteresis = episodeStart && materialLawManager_->enableHysteresis();
+        const bool updateMaxOilSaturation = episodeStart && vapparsActive();
+        const bool updateMaxPolymerAdsorption = episodeStart && GET_PROP_VALUE(TypeTag, EnablePolymer);
         // water compaction is activated in ROCKCOMP
-        if (maxWaterSaturation_.size()== 0)
-            return false;
-
-        maxWaterSaturation_[/*timeIdx=*/1] = maxWaterSaturation_[/*timeIdx=*/0];
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
+        const bool updateMaxWaterSaturation = !maxWaterSaturation_.empty();
+        // IRREVERS option is used in ROCKCOMP
+        const bool updateMinPressure = !minOilPressure_.empty();
 
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        if (!updateHysteresis && !updateMaxOilSaturation && !updateMaxPolymerAdsorption
+            && !updateMaxWaterSaturation && !updateMinPressure)
+            return false;
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+        if (updateMaxWaterSaturation)
+            maxWaterSaturation_[/*timeIdx=*/1] = maxWaterSaturation_[/*timeIdx=*/0];
 
-            Scalar Sw = Opm::decay<Scalar>(fs.saturation(waterPhaseIdx));
-            maxWaterSaturation_[compressedDofIdx] = std::max(maxWaterSaturation_[compressedDofIdx], Sw);
-        }
+        // we need to update the data for _all_ elements (i.e., not just the
+        // interior ones) to avoid desynchronization of the processes in the
+        // parallel case!
+        const auto& model = this->model();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator);
+            Opm::ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+            for (auto elemIt = threadedElemIt.beginParallel();
+                 !threadedElemIt.isFinished(elemIt);
+                 elemIt = threadedElemIt.increment())
+            {
+                const Element& elem = *elemIt;
+                const unsigned compressedDofIdx = model.dofMapper().index(elem);
 
-        return true;
-    }
+                const IntensiveQuantities* iqPtr = model.cachedIntensiveQuantities(compressedDofIdx, /*timeIdx=*/0);
+                if (!iqPtr) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    iqPtr = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                }
+                const auto& iq = *iqPtr;
+                const auto& fs = iq.fluidState();
 
-    bool updateMinPressure_()
-    {
-        // IRREVERS option is used in ROCKCOMP
-        if (minOilPressure_.empty())
-            return false;
+                if (updateHysteresis)
+                    materialLawManager_->updateHysteresis(fs, compressedDofIdx);
 
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
+                if (updateMaxOilSaturation) {
+                    Scalar So = Opm::decay<Scalar>(fs.saturation(oilPhaseIdx));
+                    maxOilSaturation_[compressedDofIdx] = std::max(maxOilSaturation_[compressedDofIdx], So);
+                }
 
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                if (updateMaxPolymerAdsorption)
+                    maxPolymerAdsorption_[compressedDofIdx] = std::max(maxPolymerAdsorption_[compressedDofIdx],
+                                                                       Opm::scalarValue(iq.polymerAdsorption()));
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& fs = iq.fluidState();
+                if (updateMaxWaterSaturation) {
+                    Scalar Sw = Opm::decay<Scalar>(fs.saturation(waterPhaseIdx));
+                    maxWaterSaturation_[compressedDofIdx] = std::max(maxWaterSaturation_[compressedDofIdx], Sw);
+                }
 
-            minOilPressure_[compressedDofIdx] =
-                std::min(minOilPressure_[compressedDofIdx],
-                         Opm::getValue(fs.pressure(oilPhaseIdx)));
+                if (updateMinPressure)
+                    minOilPressure_[compressedDofIdx] =
+                        std::min(minOilPressure_[compressedDofIdx],
+                                 Opm::getValue(fs.pressure(oilPhaseIdx)));
+            }
         }
 
-        return true;
+        // in the VAPPARS case we need to invalidate the intensive quantities cache
+        // because the derivatives of Rs and Rv will most likely have changed
+        return updateHysteresis || updateMaxOilSaturation || updateMaxWaterSaturation || updateMinPressure;
     }
 
     void readRockParameters_()
@@ -2734,53 +2744,6 @@ private:
         }
     }
 
-    // update the hysteresis parameters of the material laws for the whole grid
-    bool updateHysteresis_()
-    {
-        if (!materialLawManager_->enableHysteresis())
-            return false;
-
-        // we need to update the hysteresis data for _all_ elements (i.e., not just the
-        // interior ones) to avoid desynchronization of the processes in the parallel case!
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            materialLawManager_->updateHysteresis(intQuants.fluidState(), compressedDofIdx);
-        }
-        return true;
-    }
-
-    void updateMaxPolymerAdsorption_()
-    {
-        // we need to update the max polymer adsoption data for all elements
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-
-            maxPolymerAdsorption_[compressedDofIdx] = std::max(maxPolymerAdsorption_[compressedDofIdx] , Opm::scalarValue(intQuants.polymerAdsorption()));
-        }
-    }
-
     template<class T>
     void updateNum(const std::string& name, std::vector<T>& numbers)
     {
@@ -2824,6 +2787,7 @@ private:
     {
         Opm::ConditionalStorage<enableEnergy, Scalar> thermalHalfTrans;
         Scalar transmissibility;
+        Scalar thresholdPressure;
     };
 
     // update the prefetch friendly data object
@@ -2841,6 +2805,7 @@ private:
             if (localDofIdx != 0) {
                 unsigned globalCenterElemIdx = elementMapper.index(stencil.entity(/*dofIdx=*/0));
                 dofData.transmissibility = transmissibilities_.transmissibility(globalCenterElemIdx, globalElemIdx);
+                dofData.thresholdPressure = thresholdPressures_.thresholdPressure(globalCenterElemIdx, globalElemIdx);
 
                 if (enableEnergy)
                     *dofData.thermalHalfTrans = transmissibilities_.thermalHalfTrans(globalCenterElemIdx, globalElemIdx);
@@ -3071,6 +3036,7 @@ private:
     std::vector<Scalar> maxWaterSaturation_;
     std::vector<Scalar> overburdenPressure_;
     std::vector<Scalar> minOilPressure_;
+    bool episodeStartUpdatePending_ = false;
 
     std::vector<TabulatedTwoDFunction> rockCompPoroMult_;
     std::vector<TabulatedTwoDFunction> rockCompTransMult_;
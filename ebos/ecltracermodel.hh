@@ -38,6 +38,7 @@
 
 #include <dune/common/version.hh>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -83,6 +84,15 @@ class EclTracerModel
 
     typedef Dune::BCRSMatrix<Dune::FieldMatrix<Scalar, 1, 1>> TracerMatrix;
     typedef Dune::BlockVector<Dune::FieldVector<Scalar,1>> TracerVector;
+    typedef Dune::SeqILU< TracerMatrix, TracerVector, TracerVector  > TracerPreconditioner;
+
+    // The Jacobian of the tracer equations only depends on the flow field of
+    // the tracer phase, so all tracers of a phase are solved together.
+    struct TracerBatch
+    {
+        int phaseIdx;
+        std::vector<int> tracerIdx;
+    };
 
 public:
     EclTracerModel(Simulator& simulator)
@@ -167,12 +177,22 @@ public:
             ++tracerIdx;
         }
 
+        // group the tracers by phase
+        for (tracerIdx = 0; tracerIdx < numTracers; ++tracerIdx) {
+            const int phaseIdx = tracerPhaseIdx_[tracerIdx];
+            auto batchIt = std::find_if(tracerBatches_.begin(), tracerBatches_.end(),
+                                        [phaseIdx](const TracerBatch& batch)
+                                        { return batch.phaseIdx == phaseIdx; });
+            if (batchIt == tracerBatches_.end()) {
+                tracerBatches_.push_back(TracerBatch{phaseIdx, {}});
+                batchIt = tracerBatches_.end() - 1;
+            }
+            batchIt->tracerIdx.push_back(tracerIdx);
+        }
+
         // initial tracer concentration
         tracerConcentrationInitial_ = tracerConcentration_;
 
-        // residual of tracers
-        tracerResidual_.resize(numGridDof);
-
         // allocate matrix for storing the Jacobian of the tracer residual
         tracerMatrix_ = new TracerMatrix(numGridDof, numGridDof, TracerMatrix::random);
 
@@ -280,17 +300,29 @@ public:
         if (numTracers()==0)
             return;
 
-        for (int tracerIdx = 0; tracerIdx < numTracers(); ++ tracerIdx){
+        const size_t numGridDof = simulator_.model().numGridDof();
+        for (const auto& batch : tracerBatches_) {
+            // the tracers of the batch which have not converged yet
+            std::vector<int> activeTracers = batch.tracerIdx;
 
-            TracerVector dx(tracerResidual_.size());
             // Newton step (currently the system is linear, converge in one iteration)
-            for (int iter = 0; iter < 5; ++ iter){
-                linearize_(tracerIdx);
+            for (int iter = 0; iter < 5 && !activeTracers.empty(); ++ iter){
+                tracerResidual_.resize(activeTracers.size());
+                for (auto& residual : tracerResidual_)
+                    residual.resize(numGridDof);
+                std::vector<TracerVector> dx(activeTracers.size(), TracerVector(numGridDof));
+
+                linearize_(activeTracers);
                 linearSolve_(*tracerMatrix_, dx, tracerResidual_);
-                tracerConcentration_[tracerIdx] -= dx;
 
-                if (dx.two_norm()<1e-2)
-                    break;
+                std::vector<int> unconvergedTracers;
+                for (size_t k = 0; k < activeTracers.size(); ++k) {
+                    tracerConcentration_[activeTracers[k]] -= dx[k];
+
+                    if (!(dx[k].two_norm()<1e-2))
+                        unconvergedTracers.push_back(activeTracers[k]);
+                }
+                activeTracers.swap(unconvergedTracers);
             }
         }
     }
@@ -376,13 +408,13 @@ protected:
 
     }
 
-    bool linearSolve_(const TracerMatrix& M, TracerVector& x, TracerVector& b)
+    // solve M*x[k] = b[k] for all right hand sides using a single ILU0 factorization of M
+    bool linearSolve_(const TracerMatrix& M, std::vector<TracerVector>& x, std::vector<TracerVector>& b)
     {
 #if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,7)
         Dune::FMatrixPrecision<Scalar>::set_singular_limit(1.e-30);
         Dune::FMatrixPrecision<Scalar>::set_absolute_limit(1.e-30);
 #endif
-        x = 0.0;
         Scalar tolerance = 1e-2;
         int maxIter = 100;
 
@@ -390,7 +422,6 @@ protected:
         typedef Dune::BiCGSTABSolver<TracerVector> TracerSolver;
         typedef Dune::MatrixAdapter<TracerMatrix, TracerVector , TracerVector > TracerOperator;
         typedef Dune::SeqScalarProduct< TracerVector > TracerScalarProduct ;
-        typedef Dune::SeqILU< TracerMatrix, TracerVector, TracerVector  > TracerPreconditioner;
 
         TracerOperator tracerOperator(M);
         TracerScalarProduct tracerScalarProduct;
@@ -400,17 +431,26 @@ protected:
                              tracerPreconditioner, tolerance, maxIter,
                              verbosity);
 
-        Dune::InverseOperatorResult result;
-        solver.apply(x, b, result);
+        bool converged = true;
+        for (size_t k = 0; k < b.size(); ++k) {
+            x[k] = 0.0;
+            Dune::InverseOperatorResult result;
+            solver.apply(x[k], b[k], result);
+            converged = converged && result.converged;
+        }
 
         // return the result of the solver
-        return result.converged;
+        return converged;
     }
 
-    void linearize_(int tracerIdx)
+    // assemble the common Jacobian and the residuals of a set of tracers of
+    // the same phase in a single sweep over the grid. The residual of
+    // tracerIndices[k] is stored in tracerResidual_[k].
+    void linearize_(const std::vector<int>& tracerIndices)
     {
         (*tracerMatrix_) = 0.0;
-        tracerResidual_ = 0.0;
+        for (auto& residual : tracerResidual_)
+            residual = 0.0;
 
         size_t numGridDof =  simulator_.model().numGridDof();
         std::vector<double> volumes(numGridDof, 0.0);
@@ -432,28 +472,37 @@ protected:
 
             size_t I = elemCtx.globalSpaceIndex(/*dofIdx=*/ 0, /*timIdx=*/0);
             volumes[I] = scvVolume;
-            TracerEvaluation localStorage;
-            TracerEvaluation storageOfTimeIndex0;
-            Scalar storageOfTimeIndex1;
-            computeStorage_(storageOfTimeIndex0, elemCtx, 0, /*timIdx=*/0, tracerIdx);
-            if (elemCtx.enableStorageCache())
-                storageOfTimeIndex1 = storageOfTimeIndex1_[tracerIdx][I];
-            else
-                computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
-
-            localStorage = (storageOfTimeIndex0 - storageOfTimeIndex1) * scvVolume/dt;
-            tracerResidual_[I][0] += localStorage.value(); //residual + flux
-            (*tracerMatrix_)[I][I][0][0] = localStorage.derivative(0);
+            for (size_t k = 0; k < tracerIndices.size(); ++k) {
+                const int tracerIdx = tracerIndices[k];
+                TracerEvaluation localStorage;
+                TracerEvaluation storageOfTimeIndex0;
+                Scalar storageOfTimeIndex1;
+                computeStorage_(storageOfTimeIndex0, elemCtx, 0, /*timIdx=*/0, tracerIdx);
+                if (elemCtx.enableStorageCache())
+                    storageOfTimeIndex1 = storageOfTimeIndex1_[tracerIdx][I];
+                else
+                    computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timIdx=*/1, tracerIdx);
+
+                localStorage = (storageOfTimeIndex0 - storageOfTimeIndex1) * scvVolume/dt;
+                tracerResidual_[k][I][0] += localStorage.value(); //residual + flux
+                // the derivatives do not depend on the tracer
+                if (k == 0)
+                    (*tracerMatrix_)[I][I][0][0] = localStorage.derivative(0);
+            }
             size_t numInteriorFaces = elemCtx.numInteriorFaces(/*timIdx=*/0);
             for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
-                TracerEvaluation flux;
                 const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
                 unsigned j = face.exteriorIndex();
                 unsigned J = elemCtx.globalSpaceIndex(/*dofIdx=*/ j, /*timIdx=*/0);
-                computeFlux_(flux, elemCtx, scvfIdx, 0, tracerIdx);
-                tracerResidual_[I][0] += flux.value(); //residual + flux
-                (*tracerMatrix_)[J][I][0][0] = -flux.derivative(0);
-                (*tracerMatrix_)[I][J][0][0] = flux.derivative(0);
+                for (size_t k = 0; k < tracerIndices.size(); ++k) {
+                    TracerEvaluation flux;
+                    computeFlux_(flux, elemCtx, scvfIdx, 0, tracerIndices[k]);
+                    tracerResidual_[k][I][0] += flux.value(); //residual + flux
+                    if (k == 0) {
+                        (*tracerMatrix_)[J][I][0][0] = -flux.derivative(0);
+                        (*tracerMatrix_)[I][J][0][0] = flux.derivative(0);
+                    }
+                }
             }
 
         }
@@ -466,7 +515,10 @@ protected:
             if (well.getStatus() == Opm::Well::Status::SHUT)
                 continue;
 
-            const double wtracer = well.getTracerProperties().getConcentration(tracerNames_[tracerIdx]);
+            std::vector<double> wtracer(tracerIndices.size());
+            for (size_t k = 0; k < tracerIndices.size(); ++k)
+                wtracer[k] = well.getTracerProperties().getConcentration(tracerNames_[tracerIndices[k]]);
+
             std::array<int, 3> cartesianCoordinate;
             for (auto& connection : well.getConnections()) {
 
@@ -478,11 +530,13 @@ protected:
                 cartesianCoordinate[2] = connection.getK();
                 const size_t cartIdx = simulator_.vanguard().cartesianIndex(cartesianCoordinate);
                 const int I = cartToGlobal_[cartIdx];
-                Scalar rate = simulator_.problem().wellModel().well(well.name())->volumetricSurfaceRateForConnection(I, tracerPhaseIdx_[tracerIdx]);
-                if (rate > 0)
-                    tracerResidual_[I][0] -= rate*wtracer;
-                else if (rate < 0)
-                    tracerResidual_[I][0] -= rate*tracerConcentration_[tracerIdx][I];
+                Scalar rate = simulator_.problem().wellModel().well(well.name())->volumetricSurfaceRateForConnection(I, tracerPhaseIdx_[tracerIndices[0]]);
+                for (size_t k = 0; k < tracerIndices.size(); ++k) {
+                    if (rate > 0)
+                        tracerResidual_[k][I][0] -= rate*wtracer[k];
+                    else if (rate < 0)
+                        tracerResidual_[k][I][0] -= rate*tracerConcentration_[tracerIndices[k]][I];
+                }
             }
         }
     }
@@ -493,8 +547,9 @@ protected:
     std::vector<int> tracerPhaseIdx_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> tracerConcentration_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> tracerConcentrationInitial_;
+    std::vector<TracerBatch> tracerBatches_;
     TracerMatrix *tracerMatrix_;
-    TracerVector tracerResidual_;
+    std::vector<TracerVector> tracerResidual_;
     std::vector<int> cartToGlobal_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> storageOfTimeIndex1_;
 
@@ -51,9 +51,12 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
 #include <array>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 #include <vector>
-#include <unordered_map>
 
 namespace Opm {
 
@@ -81,8 +84,6 @@ class EclTransmissibility
     typedef Dune::FieldMatrix<Scalar, dimWorld, dimWorld> DimMatrix;
     typedef Dune::FieldVector<Scalar, dimWorld> DimVector;
 
-    static const unsigned elemIdxShift = 32; // bits
-
 public:
 
     EclTransmissibility(const Vanguard& vanguard)
@@ -166,22 +167,8 @@ public:
                     axisCentroids[axisIdx][elemIdx][dimIdx] = centroid[dimIdx];
         }
 
-        // reserving some space in the hashmap upfront saves quite a bit of time because
-        // resizes are costly for hashmaps and there would be quite a few of them if we
-        // would not have a rough idea of how large the final map will be (the rough idea
-        // is a conforming Cartesian grid).
-        trans_.clear();
-        trans_.reserve(numElements*3*1.05);
-
-        transBoundary_.clear();
-
-        // if energy is enabled, let's do the same for the "thermal half transmissibilities"
-        if (enableEnergy) {
-            thermalHalfTrans_->clear();
-            thermalHalfTrans_->reserve(numElements*6*1.05);
-
-            thermalHalfTransBoundary_.clear();
-        }
+        // set up the flat storage of the face quantities
+        buildFaceStructure_(gridView, elemMapper);
 
         // The MULTZ needs special case if the option is ALL
         // Then the smallest multiplier is applied.
@@ -230,7 +217,7 @@ public:
                     // normally there would be two half-transmissibilities that would be
                     // averaged. on the grid boundary there only is the half
                     // transmissibility of the interior element.
-                    transBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] = transBoundaryIs;
+                    transBoundary_[boundaryStart_[elemIdx] + boundaryIsIdx] = transBoundaryIs;
 
                     // for boundary intersections we also need to compute the thermal
                     // half transmissibilities
@@ -244,7 +231,7 @@ public:
                         // the transmissibility with the face area here
                         Scalar thermalHalfTrans = std::abs(n*d)/(d*d);
 
-                        thermalHalfTransBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] =
+                        thermalHalfTransBoundary_[boundaryStart_[elemIdx] + boundaryIsIdx] =
                             thermalHalfTrans;
                     }
 
@@ -269,7 +256,7 @@ public:
                     const auto& outPos = intersection.geometry().center();
                     const auto& d = outPos - inPos;
 
-                    (*thermalHalfTrans_)[directionalIsId_(elemIdx, outsideElemIdx)] =
+                    (*thermalHalfTrans_)[faceIndex_(elemIdx, outsideElemIdx)] =
                         A * (n*d)/(d*d);
                 }
 
@@ -290,7 +277,7 @@ public:
                     // NNC. Set zero transmissibility, as it will be
                     // *added to* by applyNncToGridTrans_() later.
                     assert(outsideFaceIdx == -1);
-                    trans_[isId_(elemIdx, outsideElemIdx)] = 0.0;
+                    transRef_(elemIdx, outsideElemIdx) = 0.0;
                     continue;
                 }
 
@@ -377,7 +364,7 @@ public:
                                                        outsideCartElemIdx,
                                                        faceDir);
 
-                trans_[isId_(elemIdx, outsideElemIdx)] = trans;
+                transRef_(elemIdx, outsideElemIdx) = trans;
             }
         }
 
@@ -402,6 +389,9 @@ public:
 
         //remove very small non-neighbouring transmissibilities
         removeSmallNonCartesianTransmissibilities_();
+
+        // make the transmissibilities available from both sides of each face
+        symmetrizeTrans_();
     }
 
     /*!
@@ -414,13 +404,16 @@ public:
      * \brief Return the transmissibility for the intersection between two elements.
      */
     Scalar transmissibility(unsigned elemIdx1, unsigned elemIdx2) const
-    { return trans_.at(isId_(elemIdx1, elemIdx2)); }
+    { return trans_[existingFaceIndex_(elemIdx1, elemIdx2)]; }
 
     /*!
      * \brief Return the transmissibility for a given boundary segment.
      */
     Scalar transmissibilityBoundary(unsigned elemIdx, unsigned boundaryFaceIdx) const
-    { return transBoundary_.at(std::make_pair(elemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryStart_[elemIdx] + boundaryFaceIdx < boundaryStart_[elemIdx + 1]);
+        return transBoundary_[boundaryStart_[elemIdx] + boundaryFaceIdx];
+    }
 
     /*!
      * \brief Return the thermal "half transmissibility" for the intersection between two
@@ -437,30 +430,153 @@ public:
      * cell and the center of the intersection.
      */
     Scalar thermalHalfTrans(unsigned insideElemIdx, unsigned outsideElemIdx) const
-    { return thermalHalfTrans_->at(directionalIsId_(insideElemIdx, outsideElemIdx)); }
+    { return (*thermalHalfTrans_)[existingFaceIndex_(insideElemIdx, outsideElemIdx)]; }
 
     Scalar thermalHalfTransBoundary(unsigned insideElemIdx, unsigned boundaryFaceIdx) const
-    { return thermalHalfTransBoundary_.at(std::make_pair(insideElemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryStart_[insideElemIdx] + boundaryFaceIdx < boundaryStart_[insideElemIdx + 1]);
+        return thermalHalfTransBoundary_[boundaryStart_[insideElemIdx] + boundaryFaceIdx];
+    }
 
 private:
 
+    /*!
+     * \brief Set up the flat storage of the face quantities.
+     *
+     * The faces of each element are stored contiguously in the order of its
+     * intersections, i.e., in the order of the element's stencil. The
+     * neighbours of element e are neighbors_[neighborStart_[e]] to
+     * neighbors_[neighborStart_[e+1]-1], and its boundary intersections have the
+     * indices boundaryStart_[e] to boundaryStart_[e+1]-1.
+     */
+    void buildFaceStructure_(const GridView& gridView, const ElementMapper& elemMapper)
+    {
+        unsigned numElements = elemMapper.size();
+        neighborStart_.assign(numElements + 1, 0);
+        boundaryStart_.assign(numElements + 1, 0);
+
+        // count the intersections of each element
+        const auto& elemEndIt = gridView.template end</*codim=*/ 0>();
+        for (auto elemIt = gridView.template begin</*codim=*/ 0>(); elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = elemMapper.index(elem);
+            const auto& isEndIt = gridView.iend(elem);
+            for (auto isIt = gridView.ibegin(elem); isIt != isEndIt; ++ isIt) {
+                if (isIt->boundary())
+                    ++ boundaryStart_[elemIdx + 1];
+                else if (isIt->neighbor())
+                    ++ neighborStart_[elemIdx + 1];
+            }
+        }
+        std::partial_sum(neighborStart_.begin(), neighborStart_.end(), neighborStart_.begin());
+        std::partial_sum(boundaryStart_.begin(), boundaryStart_.end(), boundaryStart_.begin());
+
+        // collect the neighbours. two elements may share several intersections,
+        // each pair of elements only gets a single entry.
+        neighbors_.resize(neighborStart_.back());
+        std::vector<unsigned> numNeighbors(numElements, 0);
+        for (auto elemIt = gridView.template begin</*codim=*/ 0>(); elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = elemMapper.index(elem);
+            auto rowBegin = neighbors_.begin() + neighborStart_[elemIdx];
+            const auto& isEndIt = gridView.iend(elem);
+            for (auto isIt = gridView.ibegin(elem); isIt != isEndIt; ++ isIt) {
+                if (isIt->boundary() || !isIt->neighbor())
+                    continue;
+
+                unsigned outsideElemIdx = elemMapper.index(isIt->outside());
+                auto rowEnd = rowBegin + numNeighbors[elemIdx];
+                if (std::find(rowBegin, rowEnd, outsideElemIdx) == rowEnd) {
+                    *rowEnd = outsideElemIdx;
+                    ++ numNeighbors[elemIdx];
+                }
+            }
+        }
+
+        // remove the gaps left by duplicate intersections
+        unsigned numFaces = 0;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            unsigned rowStart = neighborStart_[elemIdx];
+            neighborStart_[elemIdx] = numFaces;
+            for (unsigned i = 0; i < numNeighbors[elemIdx]; ++i)
+                neighbors_[numFaces++] = neighbors_[rowStart + i];
+        }
+        neighborStart_[numElements] = numFaces;
+        neighbors_.resize(numFaces);
+        neighbors_.shrink_to_fit();
+
+        trans_.assign(numFaces, 0.0);
+        transBoundary_.assign(boundaryStart_.back(), 0.0);
+        if (enableEnergy) {
+            thermalHalfTrans_->assign(numFaces, 0.0);
+            thermalHalfTransBoundary_.assign(boundaryStart_.back(), 0.0);
+        }
+    }
+
+    /*!
+     * \brief Return the index of the face between two elements in the storage of
+     *        the first one, or -1 if the elements are not neighbours.
+     */
+    int faceIndex_(unsigned elemIdx1, unsigned elemIdx2) const
+    {
+        for (unsigned i = neighborStart_[elemIdx1]; i < neighborStart_[elemIdx1 + 1]; ++i)
+            if (neighbors_[i] == elemIdx2)
+                return i;
+
+        return -1;
+    }
+
+    unsigned existingFaceIndex_(unsigned elemIdx1, unsigned elemIdx2) const
+    {
+        int faceIdx = faceIndex_(elemIdx1, elemIdx2);
+        if (faceIdx < 0)
+            throw std::out_of_range("No intersection between elements "
+                                    + std::to_string(elemIdx1) + " and "
+                                    + std::to_string(elemIdx2));
+
+        return faceIdx;
+    }
+
+    /*!
+     * \brief The transmissibility of a face while it is being computed.
+     *
+     * Until symmetrizeTrans_() is called, the transmissibility of a face is only
+     * valid in the storage of the element with the lower index.
+     */
+    Scalar& transRef_(unsigned elemIdx1, unsigned elemIdx2)
+    { return trans_[existingFaceIndex_(std::min(elemIdx1, elemIdx2), std::max(elemIdx1, elemIdx2))]; }
+
+    void symmetrizeTrans_()
+    {
+        unsigned numElements = neighborStart_.size() - 1;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            for (unsigned i = neighborStart_[elemIdx]; i < neighborStart_[elemIdx + 1]; ++i) {
+                if (neighbors_[i] > elemIdx)
+                    trans_[faceIndex_(neighbors_[i], elemIdx)] = trans_[i];
+            }
+        }
+    }
+
     void removeSmallNonCartesianTransmissibilities_()
     {
         const auto& cartMapper = vanguard_.cartesianIndexMapper();
         const auto& cartDims = cartMapper.cartesianDimensions();
-        for (auto&& trans: trans_) {
-            if (trans.second < transmissibilityThreshold_) {
-                const auto& id = trans.first;
-                const auto& elements = isIdReverse_(id);
-                int gc1 = std::min(cartMapper.cartesianIndex(elements.first), cartMapper.cartesianIndex(elements.second));
-                int gc2 = std::max(cartMapper.cartesianIndex(elements.first), cartMapper.cartesianIndex(elements.second));
+        unsigned numElements = neighborStart_.size() - 1;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            for (unsigned i = neighborStart_[elemIdx]; i < neighborStart_[elemIdx + 1]; ++i) {
+                unsigned outsideElemIdx = neighbors_[i];
+                if (outsideElemIdx < elemIdx || trans_[i] >= transmissibilityThreshold_)
+                    continue;
+
+                int gc1 = std::min(cartMapper.cartesianIndex(elemIdx), cartMapper.cartesianIndex(outsideElemIdx));
+                int gc2 = std::max(cartMapper.cartesianIndex(elemIdx), cartMapper.cartesianIndex(outsideElemIdx));
 
                 // only adjust the NNCs
                 if (gc2 - gc1 == 1 || gc2 - gc1 == cartDims[0] || gc2 - gc1 == cartDims[0]*cartDims[1])
                     continue;
 
                 //remove transmissibilities less than the threshold (by default 1e-6 in the deck's unit system)
-                trans.second = 0.0;
+                trans_[i] = 0.0;
             }
         }
     }
@@ -525,7 +641,7 @@ private:
                 if (c1 > c2)
                     continue; // we only need to handle each connection once, thank you.
 
-                auto isId = isId_(c1, c2);
+                Scalar& trans = transRef_(c1, c2);
 
                 int gc1 = std::min(cartMapper.cartesianIndex(c1), cartMapper.cartesianIndex(c2));
                 int gc2 = std::max(cartMapper.cartesianIndex(c1), cartMapper.cartesianIndex(c2));
@@ -533,26 +649,26 @@ private:
                 if (gc2 - gc1 == 1) {
                     if (tranx_deckAssigned)
                         // set simulator internal transmissibilities to values from inputTranx
-                        trans_[isId] = inputTranxData[c1];
+                        trans = inputTranxData[c1];
                     else
                         // Scale transmissibilities with scale factor from inputTranx
-                        trans_[isId] *= inputTranxData[c1];
+                        trans *= inputTranxData[c1];
                 }
                 else if (gc2 - gc1 == cartDims[0]) {
                     if (trany_deckAssigned)
                         // set simulator internal transmissibilities to values from inputTrany
-                        trans_[isId] = inputTranyData[c1];
+                        trans = inputTranyData[c1];
                     else
                         // Scale transmissibilities with scale factor from inputTrany
-                        trans_[isId] *= inputTranyData[c1];
+                        trans *= inputTranyData[c1];
                 }
                 else if (gc2 - gc1 == cartDims[0]*cartDims[1]) {
                     if (tranz_deckAssigned)
                         // set simulator internal transmissibilities to values from inputTranz
-                        trans_[isId] = inputTranzData[c1];
+                        trans = inputTranzData[c1];
                     else
                         // Scale transmissibilities with scale factor from inputTranz
-                        trans_[isId] *= inputTranzData[c1];
+                        trans *= inputTranzData[c1];
                 }
                 //else.. We don't support modification of NNC at the moment.
             }
@@ -645,9 +761,9 @@ private:
                 continue;
             }
 
-            auto candidate = trans_.find(isId_(low, high));
+            int faceIdx = faceIndex_(low, high);
 
-            if (candidate == trans_.end())
+            if (faceIdx < 0)
                 // This NNC is not resembled by the grid. Save it for later
                 // processing with local cell values
                 unprocessedNnc.push_back({c1, c2, nncEntry.trans});
@@ -655,7 +771,7 @@ private:
                 // NNC is represented by the grid and might be a neighboring connection
                 // In this case the transmissibilty is added to the value already
                 // set or computed.
-                candidate->second += nncEntry.trans;
+                trans_[faceIdx] += nncEntry.trans;
                 processedNnc.push_back({c1, c2, nncEntry.trans});
             }
         }
@@ -682,8 +798,8 @@ private:
             if (low > high)
                 std::swap(low, high);
 
-            auto candidate = trans_.find(isId_(low, high));
-            if (candidate == trans_.end()) {
+            int faceIdx = (low < 0) ? -1 : faceIndex_(low, high);
+            if (faceIdx < 0) {
                 std::ostringstream sstr;
                 sstr << "Cannot edit NNC from " << c1 << " to " << c2
                      << " as it does not exist";
@@ -693,7 +809,7 @@ private:
             else {
                 // NNC exists
                 while (nnc!= end && c1==nnc->cell1 && c2==nnc->cell2) {
-                    candidate->second *= nnc->trans;
+                    trans_[faceIdx] *= nnc->trans;
                     ++nnc;
                 }
             }
@@ -740,30 +856,6 @@ private:
                                    "(The PERM{X,Y,Z} keywords are missing)");
     }
 
-    std::uint64_t isId_(std::uint32_t elemIdx1, std::uint32_t elemIdx2) const
-    {
-        std::uint32_t elemAIdx = std::min(elemIdx1, elemIdx2);
-        std::uint64_t elemBIdx = std::max(elemIdx1, elemIdx2);
-
-        return (elemBIdx<<elemIdxShift) + elemAIdx;
-    }
-
-    std::pair<std::uint32_t, std::uint32_t> isIdReverse_(const std::uint64_t& id) const
-    {
-        // Assigning an unsigned integer to a narrower type discards the most significant bits.
-        // See "The C programming language", section A.6.2.
-        // NOTE that the ordering of element A and B may have changed
-        std::uint32_t elemAIdx = id;
-        std::uint32_t elemBIdx = (id - elemAIdx) >> elemIdxShift;
-
-        return std::make_pair(elemAIdx, elemBIdx);
-    }
-
-    std::uint64_t directionalIsId_(std::uint32_t elemIdx1, std::uint32_t elemIdx2) const
-    {
-        return (std::uint64_t(elemIdx1)<<elemIdxShift) + elemIdx2;
-    }
-
     void computeHalfTrans_(Scalar& halfTrans,
                            const DimVector& areaNormal,
                            int faceIdx, // in the reference element that contains the intersection
@@ -859,11 +951,14 @@ private:
     const Vanguard& vanguard_;
     Scalar transmissibilityThreshold_;
     std::vector<DimMatrix> permeability_;
-    std::unordered_map<std::uint64_t, Scalar> trans_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> transBoundary_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> thermalHalfTransBoundary_;
+    std::vector<unsigned> neighborStart_;
+    std::vector<unsigned> neighbors_;
+    std::vector<unsigned> boundaryStart_;
+    std::vector<Scalar> trans_;
+    std::vector<Scalar> transBoundary_;
+    std::vector<Scalar> thermalHalfTransBoundary_;
     Opm::ConditionalStorage<enableEnergy,
-                            std::unordered_map<std::uint64_t, Scalar> > thermalHalfTrans_;
+                            std::vector<Scalar> > thermalHalfTrans_;
 };
 
 } // namespace Opm
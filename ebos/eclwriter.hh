@@ -48,6 +48,7 @@
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
 #include <opm/simulators/utils/ParallelRestart.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/grid/GridHelpers.hpp>
 #include <opm/grid/utility/cartesianToCompressed.hpp>
 
@@ -56,7 +57,9 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <exception>
 #include <list>
+#include <memory>
 #include <utility>
 #include <string>
 #include <chrono>
@@ -69,6 +72,7 @@ BEGIN_PROPERTIES
 
 NEW_PROP_TAG(EnableEclOutput);
 NEW_PROP_TAG(EnableAsyncEclOutput);
+NEW_PROP_TAG(EnableAsyncEclCollect);
 NEW_PROP_TAG(EclOutputDoublePrecision);
 
 END_PROPERTIES
@@ -174,6 +178,8 @@ public:
 
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncEclOutput,
                              "Write the ECL-formated results in a non-blocking way (i.e., using a separate thread).");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncEclCollect,
+                             "Gather the restart data to the I/O rank while the next time step is computed.");
     }
 
     // The Simulator object should preferably have been const - the
@@ -198,10 +204,16 @@ public:
         if (enableAsyncOutput && collectToIORank_.isIORank())
             numWorkerThreads = 1;
         taskletRunner_.reset(new TaskletRunner(numWorkerThreads));
+
+        asyncCollect_ = EWOMS_GET_PARAM(TypeTag, bool, EnableAsyncEclCollect) && collectToIORank_.isParallel();
     }
 
     ~EclWriter()
-    { }
+    {
+        // the output of the last report step might still be in flight
+        if (std::uncaught_exceptions() == 0)
+            finishPendingOutput_();
+    }
 
     const Opm::EclipseIO& eclIO() const
     {
@@ -230,8 +242,23 @@ public:
      * \brief collect and pass data and pass it to eclIO writer
      */
 
+    /*!
+     * \brief Let a pending collection of restart data progress.
+     *
+     * Called after each Newton iteration when the restart data is
+     * gathered while the next time step runs.
+     */
+    void progressOutput()
+    {
+        if (asyncCollect_)
+            collectToIORank_.progressCollect();
+    }
+
     void evalSummaryState(bool isSubStep)
     {
+        OPM_TIMEBLOCK(summary);
+        finishPendingOutput_();
+
         int reportStepNum = simulator_.episodeIndex() + 1;
         /*
           The summary data is not evaluated for timestep 0, that is
@@ -279,7 +306,7 @@ public:
         }
 
         if (collectToIORank_.isParallel())
-            collectToIORank_.collect({}, eclOutputModule_.getBlockData(), localWellData, localGroupData);
+            collectToIORank_.collect({}, eclOutputModule_.blockSlots(), eclOutputModule_.blockValues(), localWellData, localGroupData);
 
         std::map<std::string, double> miscSummaryData;
         std::map<std::string, std::vector<double>> regionData;
@@ -341,6 +368,8 @@ public:
 
     void writeOutput(bool isSubStep)
     {
+        finishPendingOutput_();
+
         int reportStepNum = simulator_.episodeIndex() + 1;
         Scalar curTime = simulator_.time() + simulator_.timeStepSize();
         Scalar nextStepSize = simulator_.problem().nextTimeStepSize();
@@ -374,41 +403,37 @@ public:
         if (!isSubStep)
             eclOutputModule_.addRftDataToWells(localWellData, reportStepNum);
 
-        if (collectToIORank_.isParallel())
-            collectToIORank_.collect(localCellData, eclOutputModule_.getBlockData(), localWellData, localGroupData);
+        if (asyncCollect_) {
+            // the restart data is written when the transfers are finished,
+            // i.e., at the start of the next output
+            collectToIORank_.startCollect(localCellData, eclOutputModule_.blockSlots(), eclOutputModule_.blockValues(), localWellData, localGroupData);
+            if (collectToIORank_.isIORank())
+                pendingOutput_.reset(new PendingOutput{summaryState(),
+                                                       reportStepNum,
+                                                       isSubStep,
+                                                       curTime,
+                                                       nextStepSize,
+                                                       simulator_.problem().thresholdPressure().data()});
+            return;
+        }
 
+        if (collectToIORank_.isParallel()) {
+            OPM_TIMEBLOCK(output_collect);
+            collectToIORank_.collect(localCellData, eclOutputModule_.blockSlots(), eclOutputModule_.blockValues(), localWellData, localGroupData);
+        }
 
-        if (collectToIORank_.isIORank()) {
-            const auto& eclState = simulator_.vanguard().eclState();
-            const auto& simConfig = eclState.getSimulationConfig();
 
-            bool enableDoublePrecisionOutput = EWOMS_GET_PARAM(TypeTag, bool, EclOutputDoublePrecision);
+        if (collectToIORank_.isIORank()) {
             const Opm::data::Solution& cellData = collectToIORank_.isParallel() ? collectToIORank_.globalCellData() : localCellData;
             const Opm::data::Wells& wellData = collectToIORank_.isParallel() ? collectToIORank_.globalWellData() : localWellData;
-            Opm::RestartValue restartValue(cellData, wellData);
-
-            if (simConfig.useThresholdPressure())
-                restartValue.addExtra("THRESHPR", Opm::UnitSystem::measure::pressure, simulator_.problem().thresholdPressure().data());
-
-            // Add suggested next timestep to extra data.
-            if (!isSubStep)
-                restartValue.addExtra("OPMEXTRA", std::vector<double>(1, nextStepSize));
-
-            // first, create a tasklet to write the data for the current time step to disk
-            auto eclWriteTasklet = std::make_shared<EclWriteTasklet>(summaryState(),
-                                                                     *eclIO_,
-                                                                     reportStepNum,
-                                                                     isSubStep,
-                                                                     curTime,
-                                                                     restartValue,
-                                                                     enableDoublePrecisionOutput);
-
-            // then, make sure that the previous I/O request has been completed and the
-            // number of incomplete tasklets does not increase between time steps
-            taskletRunner_->barrier();
-
-            // finally, start a new output writing job
-            taskletRunner_->dispatch(eclWriteTasklet);
+            dispatchWrite_(summaryState(),
+                           reportStepNum,
+                           isSubStep,
+                           curTime,
+                           nextStepSize,
+                           cellData,
+                           wellData,
+                           simulator_.problem().thresholdPressure().data());
         }
     }
 
@@ -685,6 +710,76 @@ private:
         return ret;
     }
 
+    // the data of an output which waits for its transfers to the I/O rank
+    struct PendingOutput
+    {
+        Opm::SummaryState summaryState;
+        int reportStepNum;
+        bool isSubStep;
+        Scalar curTime;
+        Scalar nextStepSize;
+        std::vector<Scalar> thresholdPressure;
+    };
+
+    void finishPendingOutput_()
+    {
+        if (!collectToIORank_.collectPending())
+            return;
+
+        collectToIORank_.finishCollect();
+        if (collectToIORank_.isIORank()) {
+            assert(pendingOutput_);
+            dispatchWrite_(pendingOutput_->summaryState,
+                           pendingOutput_->reportStepNum,
+                           pendingOutput_->isSubStep,
+                           pendingOutput_->curTime,
+                           pendingOutput_->nextStepSize,
+                           collectToIORank_.globalCellData(),
+                           collectToIORank_.globalWellData(),
+                           pendingOutput_->thresholdPressure);
+            pendingOutput_.reset();
+        }
+    }
+
+    void dispatchWrite_(const Opm::SummaryState& st,
+                        int reportStepNum,
+                        bool isSubStep,
+                        Scalar curTime,
+                        Scalar nextStepSize,
+                        const Opm::data::Solution& cellData,
+                        const Opm::data::Wells& wellData,
+                        const std::vector<Scalar>& thresholdPressure)
+    {
+        const auto& eclState = simulator_.vanguard().eclState();
+        const auto& simConfig = eclState.getSimulationConfig();
+
+        bool enableDoublePrecisionOutput = EWOMS_GET_PARAM(TypeTag, bool, EclOutputDoublePrecision);
+        Opm::RestartValue restartValue(cellData, wellData);
+
+        if (simConfig.useThresholdPressure())
+            restartValue.addExtra("THRESHPR", Opm::UnitSystem::measure::pressure, thresholdPressure);
+
+        // Add suggested next timestep to extra data.
+        if (!isSubStep)
+            restartValue.addExtra("OPMEXTRA", std::vector<double>(1, nextStepSize));
+
+        // first, create a tasklet to write the data for the current time step to disk
+        auto eclWriteTasklet = std::make_shared<EclWriteTasklet>(st,
+                                                                 *eclIO_,
+                                                                 reportStepNum,
+                                                                 isSubStep,
+                                                                 curTime,
+                                                                 restartValue,
+                                                                 enableDoublePrecisionOutput);
+
+        // then, make sure that the previous I/O request has been completed and the
+        // number of incomplete tasklets does not increase between time steps
+        taskletRunner_->barrier();
+
+        // finally, start a new output writing job
+        taskletRunner_->dispatch(eclWriteTasklet);
+    }
+
     struct EclWriteTasklet
         : public TaskletInterface
     {
@@ -739,6 +834,8 @@ private:
     std::unique_ptr<Opm::EclipseIO> eclIO_;
     std::unique_ptr<TaskletRunner> taskletRunner_;
     Scalar restartTimeStepSize_;
+    bool asyncCollect_;
+    std::unique_ptr<PendingOutput> pendingOutput_;
 
 
 };
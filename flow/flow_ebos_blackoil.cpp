@@ -47,7 +47,7 @@ void flowEbosBlackoilSetDeck(double setupTime, Deck *deck, EclipseState& eclStat
 }
 
 std::unique_ptr<Opm::FlowMainEbos<TTAG(EclFlowProblem)>>
-flowEbosBlackoilMainInit(int argc, char** argv)
+flowEbosBlackoilMainInit(int argc, char** argv, bool outputCout, bool outputFiles)
 {
     // we always want to use the default locale, and thus spare us the trouble
     // with incorrect locale settings.
@@ -59,13 +59,14 @@ flowEbosBlackoilMainInit(int argc, char** argv)
     Dune::MPIHelper::instance(argc, argv);
 #endif
 
-    return std::make_unique<Opm::FlowMainEbos<TTAG(EclFlowProblem)>>();
+    return std::make_unique<Opm::FlowMainEbos<TTAG(EclFlowProblem)>>(
+        argc, argv, outputCout, outputFiles);
 }
 
 // ----------------- Main program -----------------
 int flowEbosBlackoilMain(int argc, char** argv, bool outputCout, bool outputFiles)
 {
-    auto mainfunc = flowEbosBlackoilMainInit(argc, argv);
+    auto mainfunc = flowEbosBlackoilMainInit(argc, argv, outputCout, outputFiles);
     return mainfunc->execute(argc, argv, outputCout, outputFiles);
 }
 
@@ -38,6 +38,7 @@
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/common/ErrorMacros.hpp>
@@ -195,9 +196,25 @@ namespace Opm {
         {
             // update the solution variables in ebos
             if ( timer.lastStepFailed() ) {
-                ebosSimulator_.model().updateFailed();
+                if (param_.enable_step_checkpoint_) {
+                    restoreStepStart_();
+                }
+                else {
+                    ebosSimulator_.model().updateFailed();
+                }
             } else {
                 ebosSimulator_.model().advanceTimeLevel();
+                // With DRSDT, DRVDT or pore volume multipliers the intensive
+                // quantities also depend on the time step size and on the
+                // previous step, the copies of the checkpoint and the cache
+                // entries of the unchanged cells would be stale after a chop.
+                checkpoint_int_quants_.clear();
+                if (param_.enable_step_checkpoint_ && ebosSimulator_.problem().recycleFirstIterationStorage()) {
+                    checkpoint_slot_.assign(ebosSimulator_.model().numGridDof(), unchangedSlot_);
+                }
+                else {
+                    checkpoint_slot_.clear();
+                }
             }
 
             // set the timestep size and episode index for ebos explicitly. ebos needs to
@@ -212,6 +229,19 @@ namespace Opm {
             wasSwitched_.resize(numDof);
             std::fill(wasSwitched_.begin(), wasSwitched_.end(), false);
 
+            // the extrapolation needs the solution at the start of the step
+            // to be the last one stored
+            prediction_pending_ = false;
+            if (!history_times_.empty()) {
+                const double t0 = history_times_.front();
+                if (std::abs(t0 - timer.simulationTimeElapsed()) > 1e-6 * timer.currentStepLength()) {
+                    clearHistory_();
+                }
+                else {
+                    prediction_pending_ = history_times_.size() > 1;
+                }
+            }
+
             if (param_.update_equations_scaling_) {
                 std::cout << "equation scaling not suported yet" << std::endl;
                 //updateEquationsScaling();
@@ -251,6 +281,7 @@ namespace Opm {
             report.total_linearizations = 1;
 
             try {
+                OPM_TIMEBLOCK(assembly);
                 report += assembleReservoir(timer, iteration);
                 report.assemble_time += perfTimer.stop();
             }
@@ -265,8 +296,11 @@ namespace Opm {
             perfTimer.reset();
             perfTimer.start();
             // the step is not considered converged until at least minIter iterations is done
+            bool residual_converged = false;
             {
+                OPM_TIMEBLOCK(convergence);
                 auto convrep = getConvergence(timer, iteration,residual_norms);
+                residual_converged = convrep.converged();
                 report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
                 ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
                 convergence_reports_.back().report.push_back(std::move(convrep));
@@ -280,6 +314,57 @@ namespace Opm {
             }
             report.update_time += perfTimer.stop();
             residual_norms_history_.push_back(residual_norms);
+
+            // Try the extrapolated initial guess once the residual of the
+            // solution of the previous step is known. The trial belongs to this
+            // iteration, if it is rejected the linearization of the previous
+            // solution is used again.
+            if (iteration == 0 && prediction_pending_ && !residual_converged) {
+                OPM_TIMEBLOCK(prediction);
+                prediction_pending_ = false;
+                perfTimer.reset();
+                perfTimer.start();
+                saveLinearization_();
+                applyPrediction_(timer, residual_norms);
+                report.update_time += perfTimer.stop();
+
+                perfTimer.reset();
+                perfTimer.start();
+                report.total_linearizations += 1;
+                try {
+                    // assembled like a later iteration, the wells are already
+                    // prepared for the time step
+                    report += assembleReservoir(timer, /*iterationIdx=*/1);
+                    report.assemble_time += perfTimer.stop();
+                }
+                catch (...) {
+                    report.assemble_time += perfTimer.stop();
+                    failureReport_ += report;
+                    throw;
+                }
+
+                perfTimer.reset();
+                perfTimer.start();
+                std::vector<double> trial_norms;
+                auto convrep = getConvergence(timer, iteration, trial_norms);
+                const bool trial_converged = convrep.converged();
+                const bool accepted = convrep.severityOfWorstFailure() < ConvergenceReport::Severity::TooLarge
+                    && acceptPrediction(trial_converged, trial_norms, prediction_residual_);
+                if (accepted) {
+                    report.converged = trial_converged && iteration > nonlinear_solver.minIter();
+                    convergence_reports_.back().report.back() = std::move(convrep);
+                    residual_norms = trial_norms;
+                    residual_norms_history_.back() = trial_norms;
+                }
+                else {
+                    rejectPrediction_();
+                    restoreLinearization_();
+                    residual_norms_history_.push_back(residual_norms);
+                    wellModel().reassemble(timer.currentStepLength());
+                }
+                report.update_time += perfTimer.stop();
+            }
+
             if (!report.converged) {
                 perfTimer.reset();
                 perfTimer.start();
@@ -294,12 +379,16 @@ namespace Opm {
 
                 // apply the Schur compliment of the well model to the reservoir linearized
                 // equations
-                wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
-                                      ebosSimulator().model().linearizer().residual());
+                {
+                    OPM_TIMEBLOCK(well_linearize);
+                    wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
+                                          ebosSimulator().model().linearizer().residual());
+                }
 
                 // Solve the linear system.
                 linear_solve_setup_time_ = 0.0;
                 try {
+                    OPM_TIMEBLOCK(linear_solve);
                     solveJacobianSystem(x);
                     report.linear_solve_setup_time += linear_solve_setup_time_;
                     report.linear_solve_time += perfTimer.stop();
@@ -341,7 +430,10 @@ namespace Opm {
 
                 // Apply the update, with considering model-dependent limitations and
                 // chopping of the update.
-                updateSolution(x);
+                {
+                    OPM_TIMEBLOCK(update);
+                    updateSolution(x);
+                }
 
                 report.update_time += perfTimer.stop();
             }
@@ -359,9 +451,24 @@ namespace Opm {
         /// Called once after each time step.
         /// In this class, this function does nothing.
         /// \param[in] timer                  simulation timer
-        void afterStep(const SimulatorTimerInterface& timer OPM_UNUSED)
+        void afterStep(const SimulatorTimerInterface& timer)
         {
             ebosSimulator_.problem().endTimeStep();
+
+            // keep the converged solution for extrapolating the next initial guess
+            const int order = param_.initial_guess_extrapolation_order_;
+            if (order > 0) {
+                const auto& model = ebosSimulator_.model();
+                history_solutions_.insert(history_solutions_.begin(), model.solution(/*timeIdx=*/0));
+                history_well_states_.insert(history_well_states_.begin(), wellModel().wellState());
+                history_times_.insert(history_times_.begin(),
+                                      timer.simulationTimeElapsed() + timer.currentStepLength());
+                if (static_cast<int>(history_times_.size()) > order + 1) {
+                    history_solutions_.pop_back();
+                    history_well_states_.pop_back();
+                    history_times_.pop_back();
+                }
+            }
         }
 
         /// Assemble the residual and Jacobian of the nonlinear system.
@@ -374,7 +481,10 @@ namespace Opm {
             // -------- Mass balance equations --------
             ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
             ebosSimulator_.problem().beginIteration();
-            ebosSimulator_.model().linearizer().linearizeDomain();
+            {
+                OPM_TIMEBLOCK(linearize_domain);
+                ebosSimulator_.model().linearizer().linearizeDomain();
+            }
             ebosSimulator_.problem().endIteration();
 
             return wellModel().lastReport();
@@ -485,7 +595,10 @@ namespace Opm {
             auto& ebosSolver = ebosSimulator_.model().newtonMethod().linearSolver();
             Dune::Timer perfTimer;
             perfTimer.start();
-            ebosSolver.prepare(ebosJac, ebosResid);
+            {
+                OPM_TIMEBLOCK(linear_setup);
+                ebosSolver.prepare(ebosJac, ebosResid);
+            }
             linear_solve_setup_time_ = perfTimer.stop();
             ebosSolver.setResidual(ebosResid);
             // actually, the error needs to be calculated after setResidual in order to
@@ -504,6 +617,11 @@ namespace Opm {
             auto& ebosNewtonMethod = ebosSimulator_.model().newtonMethod();
             SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
 
+            const bool trackChanges = param_.enable_step_checkpoint_ && checkpoint_slot_.size() == solution.size();
+            if (trackChanges) {
+                solution_before_update_ = solution;
+            }
+
             ebosNewtonMethod.update_(/*nextSolution=*/solution,
                                      /*curSolution=*/solution,
                                      /*update=*/dx,
@@ -512,7 +630,218 @@ namespace Opm {
                                                     // residual
 
             // if the solution is updated, the intensive quantities need to be recalculated
-            ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            if (trackChanges) {
+                invalidateChangedCells_();
+            }
+            else {
+                ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            }
+        }
+
+        /// Invalidate the cached intensive quantities of the cells whose
+        /// primary variables were changed by the last update. The cached
+        /// values of a cell changed for the first time in the time step are
+        /// those of the start of the step, they are copied to the checkpoint
+        /// before.
+        void invalidateChangedCells_()
+        {
+            const auto& model = ebosSimulator_.model();
+            const SolutionVector& solution = model.solution(/*timeIdx=*/0);
+            const unsigned numDof = solution.size();
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                if (samePrimaryVariables_(solution[dofIdx], solution_before_update_[dofIdx])) {
+                    continue;
+                }
+                if (checkpoint_slot_[dofIdx] == unchangedSlot_) {
+                    const auto* intQuants = model.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/0);
+                    if (intQuants) {
+                        checkpoint_slot_[dofIdx] = checkpoint_int_quants_.size();
+                        checkpoint_int_quants_.push_back(*intQuants);
+                    }
+                    else {
+                        checkpoint_slot_[dofIdx] = uncachedSlot_;
+                    }
+                }
+                model.setIntensiveQuantitiesCacheEntryValidity(dofIdx, /*timeIdx=*/0, false);
+            }
+        }
+
+        /// Go back to the solution of the start of the time step. Only the
+        /// cells changed since then are touched, their intensive quantities
+        /// are taken from the checkpoint.
+        void restoreStepStart_()
+        {
+            auto& model = ebosSimulator_.model();
+            SolutionVector& solution = model.solution(/*timeIdx=*/0);
+            const SolutionVector& start = model.solution(/*timeIdx=*/1);
+            const unsigned numDof = solution.size();
+            if (checkpoint_slot_.size() != numDof) {
+                model.updateFailed();
+                return;
+            }
+
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                const int slot = checkpoint_slot_[dofIdx];
+                if (slot == unchangedSlot_) {
+                    continue;
+                }
+                solution[dofIdx] = start[dofIdx];
+                if (slot == uncachedSlot_) {
+                    model.setIntensiveQuantitiesCacheEntryValidity(dofIdx, /*timeIdx=*/0, false);
+                }
+                else {
+                    model.updateCachedIntensiveQuantities(checkpoint_int_quants_[slot], dofIdx, /*timeIdx=*/0);
+                }
+            }
+        }
+
+        static bool samePrimaryVariables_(const PrimaryVariables& a, const PrimaryVariables& b)
+        {
+            if (a.primaryVarsMeaning() != b.primaryVarsMeaning()) {
+                return false;
+            }
+            for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                if (a[pvIdx] != b[pvIdx]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Lagrange weights of the states at the given times for the
+        /// polynomial through all of them evaluated at time t.
+        static std::vector<double> extrapolationWeights(const std::vector<double>& times,
+                                                        const double t)
+        {
+            const int numStates = times.size();
+            std::vector<double> weights(numStates, 1.0);
+            for (int i = 0; i < numStates; ++i) {
+                for (int j = 0; j < numStates; ++j) {
+                    if (j != i) {
+                        weights[i] *= (t - times[j]) / (times[i] - times[j]);
+                    }
+                }
+            }
+            return weights;
+        }
+
+        /// Whether the extrapolated initial guess is kept after its residual
+        /// has been assembled. It is rejected if it is not converged and its
+        /// largest residual norm is larger than the one of the solution of
+        /// the previous time step.
+        static bool acceptPrediction(const bool residual_converged,
+                                     const std::vector<Scalar>& residual_norms,
+                                     const Scalar previous_residual)
+        {
+            return residual_converged || maxNorm_(residual_norms) <= previous_residual;
+        }
+
+        /// Replace the solution of the previous time step by a polynomial
+        /// extrapolation of the stored converged solutions to the end of
+        /// the current step. The change is applied as a Newton update, i.e.,
+        /// it is chopped like one. Cells where the primary variables of the
+        /// stored solutions have a different meaning keep their values.
+        void applyPrediction_(const SimulatorTimerInterface& timer,
+                              const std::vector<Scalar>& residual_norms)
+        {
+            const int numStates = history_times_.size();
+            const double t = timer.simulationTimeElapsed() + timer.currentStepLength();
+            const std::vector<double> weights = extrapolationWeights(history_times_, t);
+
+            const SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const unsigned numDof = solution.size();
+            BVector dx(numDof);
+            dx = 0.0;
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                const auto meaning = solution[dofIdx].primaryVarsMeaning();
+                bool sameMeaning = true;
+                for (const auto& state : history_solutions_) {
+                    sameMeaning = sameMeaning && state[dofIdx].primaryVarsMeaning() == meaning;
+                }
+                if (!sameMeaning) {
+                    continue;
+                }
+                for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    Scalar predicted = 0.0;
+                    for (int i = 0; i < numStates; ++i) {
+                        predicted += weights[i] * history_solutions_[i][dofIdx][pvIdx];
+                    }
+                    // the Newton update is subtracted from the solution
+                    dx[dofIdx][pvIdx] = solution[dofIdx][pvIdx] - predicted;
+                }
+            }
+
+            prediction_residual_ = maxNorm_(residual_norms);
+            unpredicted_well_state_ = wellModel().wellState();
+            updateSolution(dx);
+
+            std::vector<const WellState*> wellStates;
+            for (const auto& state : history_well_states_) {
+                wellStates.push_back(&state);
+            }
+            wellModel().extrapolateWellState(wellStates, weights);
+        }
+
+        /// Keep a copy of the linearization of the reservoir equations for
+        /// the case that the extrapolated initial guess is rejected.
+        void saveLinearization_()
+        {
+            auto& linearizer = ebosSimulator_.model().linearizer();
+            saved_jacobian_ = linearizer.jacobian().istlMatrix();
+            saved_residual_ = linearizer.residual();
+        }
+
+        /// Copy the saved linearization back. Only the values are copied, the
+        /// matrix keeps its storage.
+        void restoreLinearization_()
+        {
+            auto& linearizer = ebosSimulator_.model().linearizer();
+            Mat& jacobian = linearizer.jacobian().istlMatrix();
+            auto savedRow = saved_jacobian_.begin();
+            for (auto row = jacobian.begin(); row != jacobian.end(); ++row, ++savedRow) {
+                auto savedCol = savedRow->begin();
+                for (auto col = row->begin(); col != row->end(); ++col, ++savedCol) {
+                    *col = *savedCol;
+                }
+            }
+            linearizer.residual() = saved_residual_;
+        }
+
+        /// Go back to the solution of the previous time step.
+        void rejectPrediction_()
+        {
+            if (param_.enable_step_checkpoint_) {
+                restoreStepStart_();
+            }
+            else {
+                auto& model = ebosSimulator_.model();
+                model.solution(/*timeIdx=*/0) = model.solution(/*timeIdx=*/1);
+                model.invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            }
+            wellModel().resetWellState(unpredicted_well_state_);
+            residual_norms_history_.clear();
+
+            // start collecting anew, the solution is apparently not smooth
+            clearHistory_();
+            if (terminalOutputEnabled()) {
+                OpmLog::debug("    Extrapolated initial guess increased the residual, using the previous solution");
+            }
+        }
+
+        void clearHistory_()
+        {
+            history_solutions_.clear();
+            history_well_states_.clear();
+            history_times_.clear();
+        }
+
+        static Scalar maxNorm_(const std::vector<Scalar>& norms)
+        {
+            Scalar result = 0.0;
+            for (const auto& norm : norms) {
+                result = std::max(result, norm);
+            }
+            return result;
         }
 
         /// Return true if output to cout is wanted.
@@ -899,6 +1228,30 @@ namespace Opm {
         double current_relaxation_;
         BVector dx_old_;
 
+        // converged solutions of the last time steps, newest first, for the
+        // extrapolated initial guess
+        std::vector<SolutionVector> history_solutions_;
+        std::vector<WellState> history_well_states_;
+        std::vector<double> history_times_;
+        WellState unpredicted_well_state_;
+        Scalar prediction_residual_ = 0.0;
+        bool prediction_pending_ = false;
+        // linearization of the solution of the previous step while the
+        // extrapolated initial guess is tried
+        Mat saved_jacobian_;
+        BVector saved_residual_;
+
+        // Copy-on-write checkpoint of the start of the time step. The intensive
+        // quantities of a cell are copied when its primary variables change for
+        // the first time in the step, the slot of a cell is the index of its
+        // copy or one of the values below.
+        static constexpr int unchangedSlot_ = -1;
+        static constexpr int uncachedSlot_ = -2;
+        typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
+        std::vector<int> checkpoint_slot_;
+        std::vector<IntensiveQuantities> checkpoint_int_quants_;
+        SolutionVector solution_before_update_;
+
         std::vector<StepReport> convergence_reports_;
     public:
         /// return the StandardWells object
@@ -46,6 +46,9 @@ NEW_PROP_TAG(UpdateEquationsScaling);
 NEW_PROP_TAG(UseUpdateStabilization);
 NEW_PROP_TAG(MatrixAddWellContributions);
 NEW_PROP_TAG(EnableWellOperabilityCheck);
+NEW_PROP_TAG(UseThreadedWells);
+NEW_PROP_TAG(InitialGuessExtrapolationOrder);
+NEW_PROP_TAG(EnableStepCheckpoint);
 
 // parameters for multisegment wells
 NEW_PROP_TAG(TolerancePressureMsWells);
@@ -80,6 +83,9 @@ SET_INT_PROP(FlowModelParameters, MaxInnerIterMsWells, 100);
 SET_INT_PROP(FlowModelParameters, StrictInnerIterMsWells, 40);
 SET_SCALAR_PROP(FlowModelParameters, RegularizationFactorMsw, 1);
 SET_BOOL_PROP(FlowModelParameters, EnableWellOperabilityCheck, true);
+SET_BOOL_PROP(FlowModelParameters, UseThreadedWells, false);
+SET_INT_PROP(FlowModelParameters, InitialGuessExtrapolationOrder, 0);
+SET_BOOL_PROP(FlowModelParameters, EnableStepCheckpoint, false);
 
 SET_SCALAR_PROP(FlowModelParameters, RelaxedFlowTolInnerIterMsw, 1);
 SET_SCALAR_PROP(FlowModelParameters, RelaxedPressureTolInnerIterMsw, 0.5e5);
@@ -173,6 +179,21 @@ namespace Opm
         // Whether to add influences of wells between cells to the matrix and preconditioner matrix
         bool matrix_add_well_contributions_;
 
+        /// Whether to distribute the well assembly and the well contributions to the
+        /// linear operator over the OpenMP threads of the process
+        bool use_threaded_wells_;
+
+        /// Order of the polynomial extrapolation of the converged solutions of the
+        /// previous time steps used as initial guess of the Newton method, 0 disables it
+        int initial_guess_extrapolation_order_;
+
+        /// Keep copies of the intensive quantities of the start of a time
+        /// step and restore them if the step is chopped. This trades memory
+        /// for the intensive quantities of the changed cells and a copy of
+        /// the solution for fewer recomputations after chops. It is not
+        /// used with DRSDT, DRVDT or pore volume multipliers.
+        bool enable_step_checkpoint_;
+
         /// Construct from user parameters or defaults.
         BlackoilModelParametersEbos()
         {
@@ -200,6 +221,9 @@ namespace Opm
             update_equations_scaling_ = EWOMS_GET_PARAM(TypeTag, bool, UpdateEquationsScaling);
             use_update_stabilization_ = EWOMS_GET_PARAM(TypeTag, bool, UseUpdateStabilization);
             matrix_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
+            use_threaded_wells_ = EWOMS_GET_PARAM(TypeTag, bool, UseThreadedWells);
+            initial_guess_extrapolation_order_ = EWOMS_GET_PARAM(TypeTag, int, InitialGuessExtrapolationOrder);
+            enable_step_checkpoint_ = EWOMS_GET_PARAM(TypeTag, bool, EnableStepCheckpoint);
 
             deck_file_name_ = EWOMS_GET_PARAM(TypeTag, std::string, EclDeckFileName);
         }
@@ -231,6 +255,9 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseUpdateStabilization, "Try to detect and correct oscillations or stagnation during the Newton method");
             EWOMS_REGISTER_PARAM(TypeTag, bool, MatrixAddWellContributions, "Explicitly specify the influences of wells between cells in the Jacobian and preconditioner matrices");
             EWOMS_REGISTER_PARAM(TypeTag, bool, EnableWellOperabilityCheck, "Enable the well operability checking");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseThreadedWells, "Distribute the assembly and application of the well equations over the OpenMP threads");
+            EWOMS_REGISTER_PARAM(TypeTag, int, InitialGuessExtrapolationOrder, "Order of the extrapolation of the solutions of previous time steps used as initial guess of the Newton method (0: previous solution, 1: linear, 2: quadratic)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, EnableStepCheckpoint, "Restore the intensive quantities of the cells changed during a time step from copies if the step is chopped instead of recomputing them for all cells. Needs memory for the copies, not used with DRSDT, DRVDT or pore volume multipliers");
         }
     };
 } // namespace Opm
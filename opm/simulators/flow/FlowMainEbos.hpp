@@ -79,6 +79,18 @@ namespace Opm
 
         typedef Opm::SimulatorFullyImplicitBlackoilEbos<TypeTag> Simulator;
 
+        FlowMainEbos() = default;
+
+        // The arguments are stored for executeInitStep(), which is used when the
+        // simulation is advanced one report step at a time.
+        FlowMainEbos(int argc, char** argv, bool output_cout, bool output_files)
+            : argc_(argc)
+            , argv_(argv)
+            , output_cout_(output_cout)
+            , output_files_(output_files)
+        {
+        }
+
         // Read the command line parameters. Throws an exception if something goes wrong.
         static int setupParameters_(int argc, char** argv)
         {
@@ -297,6 +309,54 @@ namespace Opm
                 &FlowMainEbos::runSimulator, /*cleanup=*/true);
         }
 
+        /// Set up the simulation like execute(), but return before the first report
+        /// step. The simulation is then advanced by executeStep() and finished by
+        /// executeStepsCleanup(). The arguments given to the constructor are used.
+        int executeInitStep()
+        {
+            return execute_(argc_, argv_, output_cout_, output_files_,
+                &FlowMainEbos::runSimulatorInit, /*cleanup=*/false);
+        }
+
+        /// Run the next report step after executeInitStep().
+        /// \return EXIT_SUCCESS, or the exit status if the simulation was stopped by
+        ///         an EXIT keyword.
+        int executeStep()
+        {
+            if (done())
+                return EXIT_SUCCESS;
+
+            if (!simulator_->runStep(*simtimer_)) {
+                stepsStopped_ = true;
+                return schedule().exitStatus().value();
+            }
+            return EXIT_SUCCESS;
+        }
+
+        /// Finish a simulation run by executeStep().
+        int executeStepsCleanup()
+        {
+            int exitCode = EXIT_SUCCESS;
+            if (stepsInitialized_) {
+                SimulatorReport report = simulator_->finalize();
+                runSimulatorAfterSim_(output_cout_, report);
+                exitCode = report.success.exit_status;
+                stepsInitialized_ = false;
+            }
+            executeCleanup_(output_files_);
+            return exitCode;
+        }
+
+        /// Whether there are no more report steps to run by executeStep().
+        bool done() const
+        { return !stepsInitialized_ || stepsStopped_ || simtimer_->done(); }
+
+        EbosSimulator* getSimulatorPtr()
+        { return ebosSimulator_.get(); }
+
+        const SimulatorTimer* getSimTimer() const
+        { return simtimer_.get(); }
+
         // Print an ASCII-art header to the PRT and DEBUG files.
         // \return Whether unkown keywords were seen during parsing.
         static void printPRTHeader(bool output_cout)
@@ -528,7 +588,22 @@ namespace Opm
             return runSimulatorInitOrRun_(output_cout, &FlowMainEbos::runSimulatorRunCallback_);
         }
 
+        // Initialize the simulator without running any report step.
+        int runSimulatorInit(bool output_cout)
+        {
+            return runSimulatorInitOrRun_(output_cout, &FlowMainEbos::runSimulatorInitCallback_);
+        }
+
     private:
+        // Callback that will be called from runSimulatorInitOrRun_().
+        int runSimulatorInitCallback_(bool /* output_cout */)
+        {
+            simulator_->init(*simtimer_);
+            stepsInitialized_ = true;
+            stepsStopped_ = false;
+            return EXIT_SUCCESS;
+        }
+
         // Callback that will be called from runSimulatorInitOrRun_().
         int runSimulatorRunCallback_(bool output_cout)
         {
@@ -637,6 +712,14 @@ namespace Opm
         std::any parallel_information_;
         std::unique_ptr<Simulator> simulator_;
         std::unique_ptr<SimulatorTimer> simtimer_;
+
+        // Used when the simulation is run one report step at a time.
+        int argc_ = 0;
+        char** argv_ = nullptr;
+        bool output_cout_ = false;
+        bool output_files_ = false;
+        bool stepsInitialized_ = false;
+        bool stepsStopped_ = false;
     };
 } // namespace Opm
 
@@ -62,6 +62,7 @@
 #if HAVE_MPI
 #include <opm/simulators/utils/ParallelEclipseState.hpp>
 #include <opm/simulators/utils/ParallelSerialization.hpp>
+#include <opm/simulators/utils/DeckCache.hpp>
 #endif
 
 #include <string>
@@ -398,12 +399,41 @@ namespace Opm
 
                     Opm::FlowMainEbos<PreTypeTag>::printPRTHeader(outputCout_);
 
+                    const bool init_from_restart_file = !EWOMS_GET_PARAM(PreTypeTag, bool, SchedRestart);
+#if HAVE_MPI
+                    std::unique_ptr<Opm::DeckCache> deckCache;
+                    bool deckFromCache = false;
+#endif
                     if (mpiRank == 0) {
+#if HAVE_MPI
+                        const std::string deckCacheDir = EWOMS_GET_PARAM(PreTypeTag, std::string, EclDeckCacheDir);
+                        if (!deckCacheDir.empty() && !deck_ && !eclipseState_ && !schedule_ && !summaryConfig_) {
+                            const std::string options = "EclStrictParsing=" + std::to_string(EWOMS_GET_PARAM(PreTypeTag, bool, EclStrictParsing))
+                                + " SchedRestart=" + std::to_string(!init_from_restart_file);
+                            deckCache.reset(new Opm::DeckCache(deckCacheDir, deckFilename, options));
+
+                            auto deck = std::make_shared<Opm::Deck>();
+                            auto schedule = std::make_shared<Opm::Schedule>(python);
+                            auto summaryConfig = std::make_shared<Opm::SummaryConfig>();
+                            if (deckCache->load(*deck, *schedule, *summaryConfig)) {
+                                deck_ = deck;
+                                schedule_ = schedule;
+                                summaryConfig_ = summaryConfig;
+                                deckFromCache = true;
+                            }
+                        }
+#endif
                         if (!deck_)
                             deck_.reset( new Opm::Deck( parser.parseFile(deckFilename , parseContext, errorGuard)));
-                        Opm::MissingFeatures::checkKeywords(*deck_, parseContext, errorGuard);
-                        if ( outputCout_ )
-                            Opm::checkDeck(*deck_, parser, parseContext, errorGuard);
+#if HAVE_MPI
+                        // a cached deck has been checked by the run which stored it
+                        if (!deckFromCache)
+#endif
+                        {
+                            Opm::MissingFeatures::checkKeywords(*deck_, parseContext, errorGuard);
+                            if ( outputCout_ )
+                                Opm::checkDeck(*deck_, parser, parseContext, errorGuard);
+                        }
 
                         if (!eclipseState_) {
 #if HAVE_MPI
@@ -417,19 +447,18 @@ namespace Opm
                           restart file is not possible, but work is underways and it is
                           included here as a switch.
                         */
-                        const bool init_from_restart_file = !EWOMS_GET_PARAM(PreTypeTag, bool, SchedRestart);
                         const auto& init_config = eclipseState_->getInitConfig();
-                        if (init_config.restartRequested() && init_from_restart_file) {
-                            int report_step = init_config.getRestartStep();
-                            const auto& rst_filename = eclipseState_->getIOConfig().getRestartFileName( init_config.getRestartRootName(), report_step, false );
-                            Opm::EclIO::ERst rst_file(rst_filename);
-                            const auto& rst_state = Opm::RestartIO::RstState::load(rst_file, report_step);
-                            if (!schedule_)
+                        if (!schedule_) {
+                            if (init_config.restartRequested() && init_from_restart_file) {
+                                int report_step = init_config.getRestartStep();
+                                const auto& rst_filename = eclipseState_->getIOConfig().getRestartFileName( init_config.getRestartRootName(), report_step, false );
+                                Opm::EclIO::ERst rst_file(rst_filename);
+                                const auto& rst_state = Opm::RestartIO::RstState::load(rst_file, report_step);
                                 schedule_.reset(new Opm::Schedule(*deck_, *eclipseState_, parseContext, errorGuard, python, &rst_state) );
-                        }
-                        else {
-                            if (!schedule_)
+                            }
+                            else {
                                 schedule_.reset(new Opm::Schedule(*deck_, *eclipseState_, parseContext, errorGuard, python));
+                            }
                         }
                         setupMessageLimiter_(schedule_->getMessageLimits(), "STDOUT_LOGGER");
                         if (!summaryConfig_)
@@ -455,6 +484,17 @@ namespace Opm
 
                         throw std::runtime_error("Unrecoverable errors were encountered while loading input.");
                     }
+#if HAVE_MPI
+                    if (deckCache && !deckFromCache) {
+                        std::vector<std::string> extraFiles;
+                        const auto& init_config = eclipseState_->getInitConfig();
+                        if (init_config.restartRequested() && init_from_restart_file)
+                            extraFiles.push_back(eclipseState_->getIOConfig().getRestartFileName(init_config.getRestartRootName(),
+                                                                                                  init_config.getRestartStep(),
+                                                                                                  false));
+                        deckCache->store(*deck_, *schedule_, *summaryConfig_, extraFiles);
+                    }
+#endif
                 }
                 setupTime_ = externalSetupTimer.elapsed();
                 outputFiles_ = (outputMode != FileOutputMode::OUTPUT_NONE);
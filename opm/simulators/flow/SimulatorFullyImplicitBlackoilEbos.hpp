@@ -28,20 +28,29 @@
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/simulators/aquifers/BlackoilAquiferModel.hpp>
 #include <opm/simulators/utils/moduleVersion.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
 BEGIN_PROPERTIES
 
 NEW_PROP_TAG(EnableAdaptiveTimeStepping);
 NEW_PROP_TAG(EnableTuning);
+NEW_PROP_TAG(EnableTimingReport);
+NEW_PROP_TAG(EnableTimingTrace);
 
 SET_BOOL_PROP(EclFlowProblem, EnableTerminalOutput, true);
 SET_BOOL_PROP(EclFlowProblem, EnableAdaptiveTimeStepping, true);
 SET_BOOL_PROP(EclFlowProblem, EnableTuning, false);
+SET_BOOL_PROP(EclFlowProblem, EnableTimingReport, false);
+SET_BOOL_PROP(EclFlowProblem, EnableTimingTrace, false);
 
 END_PROPERTIES
 
@@ -119,6 +128,10 @@ public:
                              "Use adaptive time stepping between report steps");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTuning,
                              "Honor some aspects of the TUNING keyword.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTimingReport,
+                             "Print the hierarchical timings with minimum, average and maximum over all processes at the end of the run");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTimingTrace,
+                             "Write the timed blocks of each report step as a trace in the Chrome trace event format to the output directory");
     }
 
     /// Run the simulation.
@@ -128,170 +141,214 @@ public:
     /// \param[in,out] state       state of reservoir: pressure, fluxes
     /// \return                    simulation report, with timing data
     SimulatorReport run(SimulatorTimer& timer)
+    {
+        init(timer);
+        while (!timer.done()) {
+            if (!runStep(timer))
+                break;
+        }
+        return finalize();
+    }
+
+    /// Prepare the simulation, to be called once before the first runStep().
+    /// \param[in] timer           governs the requested reporting timesteps
+    void init(SimulatorTimer& timer)
     {
         ebosSimulator_.setEpisodeIndex(-1);
 
         // Create timers and file for writing timing info.
-        Opm::time::StopWatch solverTimer;
-        Opm::time::StopWatch totalTimer;
-        totalTimer.start();
+        totalTimer_.start();
+        report_ = SimulatorReport();
+
+        auto& timings = TimingRegistry::instance();
+        timings.clear();
+        timings.setTraceEnabled(EWOMS_GET_PARAM(TypeTag, bool, EnableTimingTrace));
+        traceStep_ = -1;
 
         // adaptive time stepping
-        const auto& events = schedule().getEvents();
-        std::unique_ptr<TimeStepper > adaptiveTimeStepping;
         bool enableAdaptive = EWOMS_GET_PARAM(TypeTag, bool, EnableAdaptiveTimeStepping);
         bool enableTUNING = EWOMS_GET_PARAM(TypeTag, bool, EnableTuning);
+        adaptiveTimeStepping_.reset();
         if (enableAdaptive) {
             if (enableTUNING) {
-                adaptiveTimeStepping.reset(new TimeStepper(schedule().getTuning(timer.currentStepNum()), terminalOutput_));
+                adaptiveTimeStepping_.reset(new TimeStepper(schedule().getTuning(timer.currentStepNum()), terminalOutput_));
             }
             else {
-                adaptiveTimeStepping.reset(new TimeStepper(terminalOutput_));
+                adaptiveTimeStepping_.reset(new TimeStepper(terminalOutput_));
             }
 
             if (isRestart()) {
                 // For restarts the ebosSimulator may have gotten some information
                 // about the next timestep size from the OPMEXTRA field
-                adaptiveTimeStepping->setSuggestedNextStep(ebosSimulator_.timeStepSize());
+                adaptiveTimeStepping_->setSuggestedNextStep(ebosSimulator_.timeStepSize());
             }
         }
+    }
 
-        SimulatorReport report;
-
-        // Main simulation loop.
-        while (!timer.done()) {
-            if (schedule().exitStatus().has_value()) {
-                if (terminalOutput_) {
-                    OpmLog::info("Stopping simulation since EXIT was triggered by an action keyword.");
-                }
-                report.success.exit_status = schedule().exitStatus().value();
-                break;
-            }
-
-            // Report timestep.
+    /// Run the current report step and advance the timer to the next one.
+    /// \param[in,out] timer       governs the requested reporting timesteps
+    /// \return                    false if the simulation was stopped by an
+    ///                            EXIT keyword instead of running the step
+    bool runStep(SimulatorTimer& timer)
+    {
+        if (schedule().exitStatus().has_value()) {
             if (terminalOutput_) {
-                std::ostringstream ss;
-                timer.report(ss);
-                OpmLog::debug(ss.str());
+                OpmLog::info("Stopping simulation since EXIT was triggered by an action keyword.");
             }
+            report_.success.exit_status = schedule().exitStatus().value();
+            return false;
+        }
 
-            if (terminalOutput_) {
-                std::ostringstream stepMsg;
-                boost::posix_time::time_facet* facet = new boost::posix_time::time_facet("%d-%b-%Y");
-                stepMsg.imbue(std::locale(std::locale::classic(), facet));
-                stepMsg << "\nReport step " << std::setw(2) <<timer.currentStepNum()
-                         << "/" << timer.numSteps()
-                         << " at day " << (double)unit::convert::to(timer.simulationTimeElapsed(), unit::day)
-                         << "/" << (double)unit::convert::to(timer.totalTime(), unit::day)
-                         << ", date = " << timer.currentDateTime();
-                OpmLog::info(stepMsg.str());
-            }
+        // the blocks of the previous report step are all closed now
+        writeTimingTrace_();
+        traceStep_ = timer.currentStepNum();
+        OPM_TIMEBLOCK(report_step);
 
-            // write the inital state at the report stage
-            if (timer.initialStep()) {
-                Dune::Timer perfTimer;
-                perfTimer.start();
+        // Report timestep.
+        if (terminalOutput_) {
+            std::ostringstream ss;
+            timer.report(ss);
+            OpmLog::debug(ss.str());
+        }
 
-                ebosSimulator_.setEpisodeIndex(-1);
-                ebosSimulator_.setEpisodeLength(0.0);
-                ebosSimulator_.setTimeStepSize(0.0);
+        if (terminalOutput_) {
+            std::ostringstream stepMsg;
+            boost::posix_time::time_facet* facet = new boost::posix_time::time_facet("%d-%b-%Y");
+            stepMsg.imbue(std::locale(std::locale::classic(), facet));
+            stepMsg << "\nReport step " << std::setw(2) <<timer.currentStepNum()
+                     << "/" << timer.numSteps()
+                     << " at day " << (double)unit::convert::to(timer.simulationTimeElapsed(), unit::day)
+                     << "/" << (double)unit::convert::to(timer.totalTime(), unit::day)
+                     << ", date = " << timer.currentDateTime();
+            OpmLog::info(stepMsg.str());
+        }
 
-                wellModel_().beginReportStep(timer.currentStepNum());
-                ebosSimulator_.problem().writeOutput();
+        // write the inital state at the report stage
+        if (timer.initialStep()) {
+            Dune::Timer perfTimer;
+            perfTimer.start();
 
-                report.success.output_write_time += perfTimer.stop();
-            }
+            ebosSimulator_.setEpisodeIndex(-1);
+            ebosSimulator_.setEpisodeLength(0.0);
+            ebosSimulator_.setTimeStepSize(0.0);
 
-            // Run a multiple steps of the solver depending on the time step control.
-            solverTimer.start();
-
-            auto solver = createSolver(wellModel_());
-
-            ebosSimulator_.startNextEpisode(ebosSimulator_.startTime() + schedule().getTimeMap().getTimePassedUntil(timer.currentStepNum()),
-                                            timer.currentStepLength());
-            ebosSimulator_.setEpisodeIndex(timer.currentStepNum());
-            solver->model().beginReportStep();
-
-            // If sub stepping is enabled allow the solver to sub cycle
-            // in case the report steps are too large for the solver to converge
-            //
-            // \Note: The report steps are met in any case
-            // \Note: The sub stepping will require a copy of the state variables
-            if (adaptiveTimeStepping) {
-                if (enableTUNING) {
-                    if (events.hasEvent(ScheduleEvents::TUNING_CHANGE,timer.currentStepNum())) {
-                        adaptiveTimeStepping->updateTUNING(schedule().getTuning(timer.currentStepNum()));
-                    }
-                }
+            wellModel_().beginReportStep(timer.currentStepNum());
+            OPM_TIMEBLOCK(output);
+            ebosSimulator_.problem().writeOutput();
+
+            report_.success.output_write_time += perfTimer.stop();
+        }
 
-                bool event = events.hasEvent(ScheduleEvents::NEW_WELL, timer.currentStepNum()) ||
-                        events.hasEvent(ScheduleEvents::PRODUCTION_UPDATE, timer.currentStepNum()) ||
-                        events.hasEvent(ScheduleEvents::INJECTION_UPDATE, timer.currentStepNum()) ||
-                        events.hasEvent(ScheduleEvents::WELL_STATUS_CHANGE, timer.currentStepNum());
-                auto stepReport = adaptiveTimeStepping->step(timer, *solver, event, nullptr);
-                report += stepReport;
-            } else {
-                // solve for complete report step
-                auto stepReport = solver->step(timer);
-                report += stepReport;
-                if (terminalOutput_) {
-                    std::ostringstream ss;
-                    stepReport.reportStep(ss);
-                    OpmLog::info(ss.str());
+        // Run a multiple steps of the solver depending on the time step control.
+        solverTimer_.start();
+
+        auto solver = createSolver(wellModel_());
+
+        ebosSimulator_.startNextEpisode(ebosSimulator_.startTime() + schedule().getTimeMap().getTimePassedUntil(timer.currentStepNum()),
+                                        timer.currentStepLength());
+        ebosSimulator_.setEpisodeIndex(timer.currentStepNum());
+        solver->model().beginReportStep();
+
+        // If sub stepping is enabled allow the solver to sub cycle
+        // in case the report steps are too large for the solver to converge
+        //
+        // \Note: The report steps are met in any case
+        // \Note: The sub stepping will require a copy of the state variables
+        if (adaptiveTimeStepping_) {
+            const auto& events = schedule().getEvents();
+            bool enableTUNING = EWOMS_GET_PARAM(TypeTag, bool, EnableTuning);
+            if (enableTUNING) {
+                if (events.hasEvent(ScheduleEvents::TUNING_CHANGE,timer.currentStepNum())) {
+                    adaptiveTimeStepping_->updateTUNING(schedule().getTuning(timer.currentStepNum()));
                 }
             }
 
-            // write simulation state at the report stage
-            Dune::Timer perfTimer;
-            perfTimer.start();
-            const double nextstep = adaptiveTimeStepping ? adaptiveTimeStepping->suggestedNextStep() : -1.0;
-            ebosSimulator_.problem().setNextTimeStepSize(nextstep);
-            ebosSimulator_.problem().writeOutput();
-            report.success.output_write_time += perfTimer.stop();
+            bool event = events.hasEvent(ScheduleEvents::NEW_WELL, timer.currentStepNum()) ||
+                    events.hasEvent(ScheduleEvents::PRODUCTION_UPDATE, timer.currentStepNum()) ||
+                    events.hasEvent(ScheduleEvents::INJECTION_UPDATE, timer.currentStepNum()) ||
+                    events.hasEvent(ScheduleEvents::WELL_STATUS_CHANGE, timer.currentStepNum());
+            auto stepReport = adaptiveTimeStepping_->step(timer, *solver, event, nullptr);
+            report_ += stepReport;
+        } else {
+            // solve for complete report step
+            auto stepReport = solver->step(timer);
+            report_ += stepReport;
+            if (terminalOutput_) {
+                std::ostringstream ss;
+                stepReport.reportStep(ss);
+                OpmLog::info(ss.str());
+            }
+        }
 
-            solver->model().endReportStep();
+        // write simulation state at the report stage
+        Dune::Timer perfTimer;
+        perfTimer.start();
+        const double nextstep = adaptiveTimeStepping_ ? adaptiveTimeStepping_->suggestedNextStep() : -1.0;
+        ebosSimulator_.problem().setNextTimeStepSize(nextstep);
+        {
+            OPM_TIMEBLOCK(output);
+            ebosSimulator_.problem().writeOutput();
+        }
+        report_.success.output_write_time += perfTimer.stop();
 
-            // take time that was used to solve system for this reportStep
-            solverTimer.stop();
+        solver->model().endReportStep();
 
-            // update timing.
-            report.success.solver_time += solverTimer.secsSinceStart();
+        // take time that was used to solve system for this reportStep
+        solverTimer_.stop();
 
-            // Increment timer, remember well state.
-            ++timer;
+        // update timing.
+        report_.success.solver_time += solverTimer_.secsSinceStart();
 
+        // Increment timer, remember well state.
+        ++timer;
 
-            if (terminalOutput_) {
-                if (!timer.initialStep()) {
-                    const std::string version = moduleVersionName();
-                    outputTimestampFIP(timer, version);
-                }
-            }
 
-            if (terminalOutput_) {
-                std::string msg =
-                    "Time step took " + std::to_string(solverTimer.secsSinceStart()) + " seconds; "
-                    "total solver time " + std::to_string(report.success.solver_time) + " seconds.";
-                OpmLog::debug(msg);
+        if (terminalOutput_) {
+            if (!timer.initialStep()) {
+                const std::string version = moduleVersionName();
+                outputTimestampFIP(timer, version);
             }
+        }
 
+        if (terminalOutput_) {
+            std::string msg =
+                "Time step took " + std::to_string(solverTimer_.secsSinceStart()) + " seconds; "
+                "total solver time " + std::to_string(report_.success.solver_time) + " seconds.";
+            OpmLog::debug(msg);
         }
 
+        return true;
+    }
+
+    /// Finish the simulation after the last runStep().
+    /// \return                    simulation report, with timing data
+    SimulatorReport finalize()
+    {
         // make sure all output is written to disk before run is finished
         {
             Dune::Timer finalOutputTimer;
             finalOutputTimer.start();
 
+            OPM_TIMEBLOCK(output);
             ebosSimulator_.problem().finalizeOutput();
-            report.success.output_write_time += finalOutputTimer.stop();
+            report_.success.output_write_time += finalOutputTimer.stop();
+        }
+
+        writeTimingTrace_();
+        if (EWOMS_GET_PARAM(TypeTag, bool, EnableTimingReport)) {
+            std::ostringstream ss;
+            ss << "\nTimings:\n";
+            TimingRegistry::instance().report(ss, Dune::MPIHelper::getCollectiveCommunication());
+            if (terminalOutput_)
+                OpmLog::info(ss.str());
         }
 
         // Stop timer and create timing report
-        totalTimer.stop();
-        report.success.total_time = totalTimer.secsSinceStart();
-        report.success.converged = true;
+        totalTimer_.stop();
+        report_.success.total_time = totalTimer_.secsSinceStart();
+        report_.success.converged = true;
 
-        return report;
+        return report_;
     }
 
     const Grid& grid() const
@@ -299,6 +356,30 @@ public:
 
 protected:
 
+    // Write the trace of the last report step which was run.
+    void writeTimingTrace_()
+    {
+        auto& timings = TimingRegistry::instance();
+        if (!timings.traceEnabled() || traceStep_ < 0)
+            return;
+
+        const auto& ioConfig = eclState().getIOConfig();
+        const int rank = Dune::MPIHelper::getCollectiveCommunication().rank();
+        std::ostringstream name;
+        name << ioConfig.getBaseName() << ".TRACE-" << std::setw(4) << std::setfill('0') << traceStep_
+             << "-" << std::setw(4) << rank << ".json";
+        const std::string fileName = ioConfig.getOutputDir() + "/" + name.str();
+        std::ofstream os(fileName);
+        traceStep_ = -1;
+        if (!os) {
+            // The trace is optional, stop recording it rather than the simulation.
+            OpmLog::warning("Could not open timing trace file " + fileName + ", no further traces are written");
+            timings.setTraceEnabled(false);
+            return;
+        }
+        timings.writeTrace(os, rank);
+    }
+
     std::unique_ptr<Solver> createSolver(WellModel& wellModel)
     {
         auto model = std::unique_ptr<Model>(new Model(ebosSimulator_,
@@ -353,6 +434,14 @@ protected:
     PhaseUsage phaseUsage_;
     // Misc. data
     bool terminalOutput_;
+
+    // State of a run, kept between the calls of init(), runStep() and finalize().
+    SimulatorReport report_;
+    Opm::time::StopWatch solverTimer_;
+    Opm::time::StopWatch totalTimer_;
+    std::unique_ptr<TimeStepper> adaptiveTimeStepping_;
+    // report step whose timing trace has not been written yet, -1 if none
+    int traceStep_ = -1;
 };
 
 } // namespace Opm
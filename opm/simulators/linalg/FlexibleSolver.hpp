@@ -22,6 +22,8 @@
 #define OPM_FLEXIBLE_SOLVER_HEADER_INCLUDED
 
 #include <opm/simulators/linalg/PreconditionerFactory.hpp>
+#include <opm/simulators/linalg/PipelinedBiCGSTABSolver.hpp>
+#include <opm/simulators/linalg/SStepGMResSolver.hpp>
 
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bcrsmatrix.hh>
@@ -143,8 +145,10 @@ private:
         scalarproduct_ = std::make_shared<Dune::SeqScalarProduct<VectorType>>();
     }
 
-    void initSolver(const boost::property_tree::ptree& prm, bool isMaster)
+    template <class Comm>
+    void initSolver(const boost::property_tree::ptree& prm, const Comm& comm)
     {
+        const bool isMaster = comm.communicator().rank() == 0;
         const double tol = prm.get<double>("tol", 1e-2);
         const int maxiter = prm.get<int>("maxiter", 200);
         const int verbosity = isMaster? prm.get<int>("verbosity", 0) : 0;
@@ -172,6 +176,24 @@ private:
                                                                         restart, // desired residual reduction factor
                                                                         maxiter, // maximum number of iterations
                                                                         verbosity));
+        } else if (solver_type == "pipelinedbicgstab") {
+            linsolver_.reset(new Dune::PipelinedBiCGSTABSolver<VectorType>(*linearoperator_,
+                                                                           *preconditioner_,
+                                                                           Dune::GlobalDotProducts(comm),
+                                                                           tol, // desired residual reduction factor
+                                                                           maxiter, // maximum number of iterations
+                                                                           verbosity));
+        } else if (solver_type == "sstepgmres") {
+            int restart = prm.get<int>("restart", 15);
+            int steps = prm.get<int>("steps", 3);
+            linsolver_.reset(new Dune::SStepGMResSolver<VectorType>(*linearoperator_,
+                                                                    *preconditioner_,
+                                                                    Dune::GlobalDotProducts(comm),
+                                                                    tol, // desired residual reduction factor
+                                                                    restart,
+                                                                    steps, // basis vectors per reduction
+                                                                    maxiter, // maximum number of iterations
+                                                                    verbosity));
 #if HAVE_SUITESPARSE_UMFPACK
         } else if (solver_type == "umfpack") {
             bool dummy = false;
@@ -190,7 +212,7 @@ private:
               const std::function<VectorTypeT()> weightsCalculator, const Comm& comm)
     {
         initOpPrecSp(matrix, prm, weightsCalculator, comm);
-        initSolver(prm, comm.communicator().rank()==0);
+        initSolver(prm, comm);
     }
 
     std::shared_ptr<AbstractOperatorType> linearoperator_;
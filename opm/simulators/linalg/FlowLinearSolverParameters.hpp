@@ -52,6 +52,8 @@ NEW_PROP_TAG(IluFillinLevel);
 NEW_PROP_TAG(MiluVariant);
 NEW_PROP_TAG(IluRedblack);
 NEW_PROP_TAG(IluReorderSpheres);
+NEW_PROP_TAG(IluLevelScheduling);
+NEW_PROP_TAG(PreconditionerSinglePrecision);
 NEW_PROP_TAG(UseGmres);
 NEW_PROP_TAG(LinearSolverRequireFullSparsityPattern);
 NEW_PROP_TAG(LinearSolverIgnoreConvergenceFailure);
@@ -68,6 +70,7 @@ NEW_PROP_TAG(CprReuseSetup);
 NEW_PROP_TAG(LinearSolverConfiguration);
 NEW_PROP_TAG(LinearSolverConfigurationJsonFile);
 NEW_PROP_TAG(UseGpu);
+NEW_PROP_TAG(UseBdaCpu);
 
 SET_SCALAR_PROP(FlowIstlSolverParams, LinearSolverReduction, 1e-2);
 SET_SCALAR_PROP(FlowIstlSolverParams, IluRelaxation, 0.9);
@@ -78,6 +81,8 @@ SET_INT_PROP(FlowIstlSolverParams, IluFillinLevel, 0);
 SET_STRING_PROP(FlowIstlSolverParams, MiluVariant, "ILU");
 SET_BOOL_PROP(FlowIstlSolverParams, IluRedblack, false);
 SET_BOOL_PROP(FlowIstlSolverParams, IluReorderSpheres, false);
+SET_BOOL_PROP(FlowIstlSolverParams, IluLevelScheduling, false);
+SET_BOOL_PROP(FlowIstlSolverParams, PreconditionerSinglePrecision, false);
 SET_BOOL_PROP(FlowIstlSolverParams, UseGmres, false);
 SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverRequireFullSparsityPattern, false);
 SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverIgnoreConvergenceFailure, false);
@@ -95,6 +100,7 @@ SET_INT_PROP(FlowIstlSolverParams, CprReuseSetup, 3);
 SET_STRING_PROP(FlowIstlSolverParams, LinearSolverConfiguration, "ilu0");
 SET_STRING_PROP(FlowIstlSolverParams, LinearSolverConfigurationJsonFile, "none");
 SET_BOOL_PROP(FlowIstlSolverParams, UseGpu, false);
+SET_BOOL_PROP(FlowIstlSolverParams, UseBdaCpu, false);
 
 
 
@@ -158,6 +164,8 @@ namespace Opm
         Opm::MILU_VARIANT   ilu_milu_;
         bool   ilu_redblack_;
         bool   ilu_reorder_sphere_;
+        bool   ilu_level_scheduling_;
+        bool   preconditioner_single_precision_;
         bool   newton_use_gmres_;
         bool   require_full_sparsity_pattern_;
         bool   ignoreConvergenceFailure_;
@@ -168,6 +176,7 @@ namespace Opm
         std::string linear_solver_configuration_;
         std::string linear_solver_configuration_json_file_;
         bool use_gpu_;
+        bool use_bda_cpu_;
 
         template <class TypeTag>
         void init()
@@ -182,6 +191,8 @@ namespace Opm
             ilu_milu_ = convertString2Milu(EWOMS_GET_PARAM(TypeTag, std::string, MiluVariant));
             ilu_redblack_ = EWOMS_GET_PARAM(TypeTag, bool, IluRedblack);
             ilu_reorder_sphere_ = EWOMS_GET_PARAM(TypeTag, bool, IluReorderSpheres);
+            ilu_level_scheduling_ = EWOMS_GET_PARAM(TypeTag, bool, IluLevelScheduling);
+            preconditioner_single_precision_ = EWOMS_GET_PARAM(TypeTag, bool, PreconditionerSinglePrecision);
             newton_use_gmres_ = EWOMS_GET_PARAM(TypeTag, bool, UseGmres);
             require_full_sparsity_pattern_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern);
             ignoreConvergenceFailure_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure);
@@ -197,6 +208,7 @@ namespace Opm
             linear_solver_configuration_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverConfiguration);
             linear_solver_configuration_json_file_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverConfigurationJsonFile);
             use_gpu_ = EWOMS_GET_PARAM(TypeTag, bool, UseGpu);
+            use_bda_cpu_ = EWOMS_GET_PARAM(TypeTag, bool, UseBdaCpu);
         }
 
         template <class TypeTag>
@@ -211,6 +223,8 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, std::string, MiluVariant, "Specify which variant of the modified-ILU preconditioner ought to be used. Possible variants are: ILU (default, plain ILU), MILU_1 (lump diagonal with dropped row entries), MILU_2 (lump diagonal with the sum of the absolute values of the dropped row  entries), MILU_3 (if diagonal is positive add sum of dropped row entrires. Otherwise substract them), MILU_4 (if diagonal is positive add sum of dropped row entrires. Otherwise do nothing");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluRedblack, "Use red-black partioning for the ILU preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluReorderSpheres, "Whether to reorder the entries of the matrix in the red-black ILU preconditioner in spheres starting at an edge. If false the original ordering is preserved in each color. Otherwise why try to ensure D4 ordering (in a 2D structured grid, the diagonal elements are consecutive).");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluLevelScheduling, "Apply the ILU preconditioner level by level using multiple threads. The result does not depend on the number of threads");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, PreconditionerSinglePrecision, "Store the factors of the ILU preconditioners and AMG smoothers in single precision. The Krylov solver still works in double precision");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseGmres, "Use GMRES as the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern, "Produce the full sparsity pattern for the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure, "Continue with the simulation like nothing happened after the linear solver did not converge");
@@ -222,10 +236,11 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, CprUseDrs, "Use dynamic row sum using weights");
             EWOMS_REGISTER_PARAM(TypeTag, int, CprMaxEllIter, "MaxIterations of the elliptic pressure part of the cpr solver");
             EWOMS_REGISTER_PARAM(TypeTag, int, CprEllSolvetype, "Solver type of elliptic pressure solve (0: bicgstab, 1: cg, 2: only amg preconditioner)");
-            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse Amg Setup");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprReuseSetup, "Reuse preconditioner setup (0: recreate every solve, 1: recreate in the first Newton iteration, 2: recreate if the last solve needed more than 10 iterations, 3: only update numerically, 4: adaptively keep, update numerically or recreate based on measured setup and solve times)");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverConfiguration, "Configuration of solver valid is: ilu0 (default), cpr_quasiimpes, cpr_trueimpes or file (specified in LinearSolverConfigurationJsonFile) ");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverConfigurationJsonFile, "Filename of JSON configuration for flexible linear solver system.");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseGpu, "Use GPU cusparseSolver as the linear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseBdaCpu, "Use the multithreaded block-CSR cpuSolver as the linear solver");
         }
 
         FlowLinearSolverParameters() { reset(); }
@@ -247,7 +262,10 @@ namespace Opm
             ilu_milu_                 = MILU_VARIANT::ILU;
             ilu_redblack_             = false;
             ilu_reorder_sphere_       = true;
+            ilu_level_scheduling_     = false;
+            preconditioner_single_precision_ = false;
             use_gpu_                  = false;
+            use_bda_cpu_              = false;
         }
     };
 
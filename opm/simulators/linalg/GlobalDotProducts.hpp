@@ -0,0 +1,148 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GLOBALDOTPRODUCTS_HEADER_INCLUDED
+#define OPM_GLOBALDOTPRODUCTS_HEADER_INCLUDED
+
+#include <dune/istl/paamg/pinfo.hh>
+#if HAVE_MPI
+#include <dune/istl/owneroverlapcopy.hh>
+#include <mpi.h>
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Dune
+{
+
+/// Dot products whose global sums are computed together.
+///
+/// The local parts of several dot products are computed with local()
+/// and stored in one buffer. start() begins a non-blocking sum of the
+/// whole buffer over all processes and finish() waits for it, so the
+/// communication can overlap with operator and preconditioner
+/// applications. Only the entries owned by the process are counted,
+/// which gives the same values as the scalar product of the
+/// overlapping solvers. As in OwnerOverlapCopyCommunication, entries
+/// missing in the index set count as owned.
+class GlobalDotProducts
+{
+public:
+    /// Dot products of a sequential solver.
+    explicit GlobalDotProducts(const Dune::Amg::SequentialInformation&)
+    {
+    }
+
+#if HAVE_MPI
+    /// Dot products of an overlapping solver using the owner entries
+    /// of the index set of comm.
+    template <class GlobalIdType, class LocalIdType>
+    explicit GlobalDotProducts(const Dune::OwnerOverlapCopyCommunication<GlobalIdType, LocalIdType>& comm)
+        : parallel_(true)
+        , communicator_(comm.communicator())
+    {
+        for (const auto& index : comm.indexSet()) {
+            if (index.local().attribute() != Dune::OwnerOverlapCopyAttributeSet::owner) {
+                notOwned_.push_back(index.local().local());
+            }
+        }
+    }
+#endif
+
+    /// The dot product of the owner entries of x and y on this process.
+    template <class Vector>
+    double local(const Vector& x, const Vector& y) const
+    {
+        double result = 0.0;
+        if (!parallel_) {
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                result += x[i] * y[i];
+            }
+        } else {
+            buildMask(x.size());
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                result += mask_[i] * (x[i] * y[i]);
+            }
+        }
+        return result;
+    }
+
+    /// Start summing values over all processes. The buffer must not be
+    /// accessed until finish() has returned.
+    void start(std::vector<double>& values)
+    {
+#if HAVE_MPI
+        assert(request_ == MPI_REQUEST_NULL);
+        if (parallel_) {
+            MPI_Iallreduce(MPI_IN_PLACE, values.data(), static_cast<int>(values.size()),
+                           MPI_DOUBLE, MPI_SUM, communicator_, &request_);
+        }
+#else
+        static_cast<void>(values);
+#endif
+    }
+
+    /// Wait for the sum started by start().
+    void finish()
+    {
+#if HAVE_MPI
+        if (request_ != MPI_REQUEST_NULL) {
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+        }
+#endif
+    }
+
+    /// Sum values over all processes.
+    void sum(std::vector<double>& values)
+    {
+        start(values);
+        finish();
+    }
+
+private:
+    /// Size the mask like the vectors, see
+    /// OwnerOverlapCopyCommunication::buildOwnerMask().
+    void buildMask(const std::size_t size) const
+    {
+        if (mask_.size() != size) {
+            mask_.assign(size, 1.0);
+            for (const auto index : notOwned_) {
+                if (index < size) {
+                    mask_[index] = 0.0;
+                }
+            }
+        }
+    }
+
+    bool parallel_ = false;
+    // Local indices of the entries not owned by this process.
+    std::vector<std::size_t> notOwned_;
+    // One entry per block, 0 for the entries not owned and 1 otherwise.
+    mutable std::vector<double> mask_;
+#if HAVE_MPI
+    MPI_Comm communicator_ = MPI_COMM_SELF;
+    MPI_Request request_ = MPI_REQUEST_NULL;
+#endif
+};
+
+} // namespace Dune
+
+#endif // OPM_GLOBALDOTPRODUCTS_HEADER_INCLUDED
@@ -34,6 +34,7 @@
 #include <opm/simulators/linalg/WriteSystemMatrixHelper.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <opm/material/fluidsystems/BlackOilDefaultIndexTraits.hpp>
 
@@ -46,12 +47,11 @@
 #include <dune/istl/solvers.hh>
 #include <dune/istl/owneroverlapcopy.hh>
 #include <dune/istl/paamg/amg.hh>
+#include <dune/common/timer.hh>
 
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
-#if HAVE_CUDA
 #include <opm/simulators/linalg/bda/BdaBridge.hpp>
-#endif
 
 BEGIN_PROPERTIES
 
@@ -134,7 +134,10 @@ public:
     A_.mv( x, y );
 
     // add well model modification to y
-    wellMod_.apply(x, y );
+    {
+      OPM_TIMEBLOCK(well_apply);
+      wellMod_.apply(x, y );
+    }
 
 #if HAVE_MPI
     if( comm_ )
@@ -148,7 +151,10 @@ public:
     A_.usmv(alpha,x,y);
 
     // add scaled well model modification to y
-    wellMod_.applyScaleAdd( alpha, x, y );
+    {
+      OPM_TIMEBLOCK(well_apply);
+      wellMod_.applyScaleAdd( alpha, x, y );
+    }
 
 #if HAVE_MPI
     if( comm_ )
@@ -271,6 +277,8 @@ protected:
         typedef typename GridView::template Codim<0>::Entity Element;
         typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
         using FlexibleSolverType = Dune::FlexibleSolver<Matrix, Vector>;
+        // How the preconditioner of the flexible solver is refreshed before a solve.
+        enum class PreconditionerUpdate { Stale, Numeric, Full };
         // Due to miscibility oil <-> gas the water eqn is the one we can replace with a pressure equation.
         static const bool waterEnabled = Indices::waterEnabled;
         static const int pindex = (waterEnabled) ? BlackOilDefaultIndexTraits::waterCompIdx : BlackOilDefaultIndexTraits::oilCompIdx;
@@ -278,9 +286,7 @@ protected:
         enum { pressureVarIndex = Indices::pressureSwitchIdx };
         static const int numEq = Indices::numEq;
 
-#if HAVE_CUDA
         std::unique_ptr<BdaBridge> bdaBridge;
-#endif
 
 #if HAVE_MPI
         typedef Dune::OwnerOverlapCopyCommunication<int,int> communication_type;
@@ -316,22 +322,25 @@ protected:
                 prm_ = setupPropertyTree<TypeTag>(parameters_);
             }
             const auto& gridForConn = simulator_.vanguard().grid();
-#if HAVE_CUDA
             bool use_gpu = EWOMS_GET_PARAM(TypeTag, bool, UseGpu);
+            bool use_bda_cpu = EWOMS_GET_PARAM(TypeTag, bool, UseBdaCpu);
+#if ! HAVE_CUDA
+            if (use_gpu) {
+                OPM_THROW(std::logic_error,"Error cannot use GPU solver since CUDA was not found during compilation");
+            }
+#endif
             if (gridForConn.comm().size() > 1 && use_gpu) {
                 OpmLog::warning("Warning cannot use GPU with MPI, GPU is disabled");
                 use_gpu = false;
             }
+            if (gridForConn.comm().size() > 1 && use_bda_cpu) {
+                OpmLog::warning("Warning cannot use cpuSolver with MPI, cpuSolver is disabled");
+                use_bda_cpu = false;
+            }
             const int maxit = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIter);
             const double tolerance = EWOMS_GET_PARAM(TypeTag, double, LinearSolverReduction);
             const int linear_solver_verbosity = parameters_.linear_solver_verbosity_;
-            bdaBridge.reset(new BdaBridge(use_gpu, linear_solver_verbosity, maxit, tolerance));
-#else
-            const bool use_gpu = EWOMS_GET_PARAM(TypeTag, bool, UseGpu);
-            if (use_gpu) {
-                OPM_THROW(std::logic_error,"Error cannot use GPU solver since CUDA was not found during compilation");
-            }
-#endif
+            bdaBridge.reset(new BdaBridge(use_gpu, use_bda_cpu, linear_solver_verbosity, maxit, tolerance));
             extractParallelGridInformationToISTL(simulator_.vanguard().grid(), parallelInformation_);
             useWellConn_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
 
@@ -345,16 +354,14 @@ protected:
             interiorCellNum_ = detail::numMatrixRowsToUseInSolver(simulator_.vanguard().grid(), ownersFirst_);
 
             if ( isParallel() && (!ownersFirst_ || parameters_.linear_solver_use_amg_  || useFlexible_ ) ) {
-                detail::setWellConnections(gridForConn, simulator_.vanguard().schedule().getWellsatEnd(), useWellConn_, wellConnectionsGraph_);
                 // For some reason simulator_.model().elementMapper() is not initialized at this stage
                 // Hence const auto& elemMapper = simulator_.model().elementMapper(); does not work.
                 // Set it up manually
                 using ElementMapper =
                     Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
                 ElementMapper elemMapper(simulator_.vanguard().gridView(), Dune::mcmgElementLayout());
-                detail::findOverlapAndInterior(gridForConn, elemMapper, overlapRows_, interiorRows_);
-                noGhostAdjacency();
-                setGhostsInNoGhost(*noGhostMat_);
+                std::vector<int> interiorRows;
+                detail::findOverlapAndInterior(gridForConn, elemMapper, overlapRows_, interiorRows);
                 if (ownersFirst_)
                     OpmLog::warning("OwnerCellsFirst option is true, but ignored.");
             }
@@ -388,30 +395,25 @@ protected:
             }
 #endif
 
-            // update matrix entries for solvers.
-            if (noGhostMat_)
+            if (firstcall)
             {
-                copyJacToNoGhost(M.istlMatrix(), *noGhostMat_);
+                // ebos will not change the matrix object. Hence simply store a pointer
+                // to the original one with a deleter that does nothing.
+                // Outch! We need to be able to scale the linear system! Hence const_cast
+                matrix_ = const_cast<Matrix*>(&M.istlMatrix());
             }
             else
             {
-                if (firstcall)
+                // Pointers should not change
+                if ( &(M.istlMatrix()) != matrix_ )
                 {
-                    // ebos will not change the matrix object. Hence simply store a pointer
-                    // to the original one with a deleter that does nothing.
-                    // Outch! We need to be able to scale the linear system! Hence const_cast
-                    matrix_ = const_cast<Matrix*>(&M.istlMatrix());
-                }
-                else
-                {
-                    // Pointers should not change
-                    if ( &(M.istlMatrix()) != matrix_ )
-                    {
-                        OPM_THROW(std::logic_error, "Matrix objects are expected to be reused when reassembling!"
-                                  <<" old pointer was " << matrix_ << ", new one is " << (&M.istlMatrix()) );
-                    }
+                    OPM_THROW(std::logic_error, "Matrix objects are expected to be reused when reassembling!"
+                              <<" old pointer was " << matrix_ << ", new one is " << (&M.istlMatrix()) );
                 }
             }
+            // The solvers that do not handle the ghost cells work on the
+            // assembled matrix with the overlap rows decoupled.
+            makeOverlapRowsInvalid(*matrix_);
             rhs_ = &b;
 
             if (useFlexible_)
@@ -490,8 +492,12 @@ protected:
             {
                 Dune::InverseOperatorResult res;
                 assert(flexibleSolver_);
+                Dune::Timer solveTimer;
                 flexibleSolver_->apply(x, *rhs_, res);
                 iterations_ = res.iterations;
+                if (parameters_.cpr_reuse_setup_ == 4) {
+                    recordFlexibleSolveTime(solveTimer.elapsed());
+                }
                 if (write_matrix) {
                     Opm::Helper::writeSystem(simulator_, //simulator is only used to get names
                                              getMatrix(),
@@ -516,9 +522,8 @@ protected:
                 else {
 
                     typedef WellModelMatrixAdapter< Matrix, Vector, Vector, WellModel, true > Operator;
-                    assert (noGhostMat_);
-                    copyJacToNoGhost(*matrix_, *noGhostMat_);
-                    Operator opA(*noGhostMat_, wellModel,
+                    assert(matrix_);
+                    Operator opA(*matrix_, wellModel,
                                  comm_ );
 
                     solve( opA, x, *rhs_, *comm_ );
@@ -622,10 +627,10 @@ protected:
 #endif
             {
                 // tries to solve linear system
-#if HAVE_CUDA
-                bool use_gpu = bdaBridge->getUseGpu();
-                if (use_gpu) {
-                    WellContributions wellContribs;
+                const bool use_gpu = bdaBridge->getUseGpu();
+                bool use_bda = use_gpu || bdaBridge->getUseCpu();
+                if (use_bda) {
+                    WellContributions wellContribs(use_gpu);
                     if (!useWellConn_) {
                         simulator_.problem().wellModel().getWellContributions(wellContribs);
                     }
@@ -636,26 +641,22 @@ protected:
                         bdaBridge->get_result(x);
                     } else {
                         // CPU fallback
-                        use_gpu = bdaBridge->getUseGpu();  // update value, BdaBridge might have disabled cusparseSolver
-                        if (use_gpu) {
-                            OpmLog::warning("cusparseSolver did not converge, now trying Dune to solve current linear system...");
+                        use_bda = bdaBridge->getUseGpu() || bdaBridge->getUseCpu();  // update value, BdaBridge might have disabled the solver
+                        if (use_bda) {
+                            OpmLog::warning(std::string(use_gpu ? "cusparseSolver" : "cpuSolver") + " did not converge, now trying Dune to solve current linear system...");
                         }
 
                         // call Dune
                         auto precond = constructPrecond(linearOperator, parallelInformation_arg);
                         solve(linearOperator, x, istlb, *sp, *precond, result);
                     }
-                } else { // gpu is not selected or disabled
+                } else { // BdaBridge is not selected or disabled
+                    // Construct preconditioner.
                     auto precond = constructPrecond(linearOperator, parallelInformation_arg);
+
+                    // Solve.
                     solve(linearOperator, x, istlb, *sp, *precond, result);
                 }
-#else
-                // Construct preconditioner.
-                auto precond = constructPrecond(linearOperator, parallelInformation_arg);
-
-                // Solve.
-                solve(linearOperator, x, istlb, *sp, *precond, result);
-#endif
             }
         }
 
@@ -677,7 +678,9 @@ protected:
             const MILU_VARIANT ilu_milu  = parameters_.ilu_milu_;
             const bool ilu_redblack = parameters_.ilu_redblack_;
             const bool ilu_reorder_spheres = parameters_.ilu_reorder_sphere_;
-            std::unique_ptr<SeqPreconditioner> precond(new SeqPreconditioner(opA.getmat(), ilu_fillin, relax, ilu_milu, ilu_redblack, ilu_reorder_spheres));
+            const bool ilu_level_scheduling = parameters_.ilu_level_scheduling_;
+            const bool single_precision = parameters_.preconditioner_single_precision_;
+            std::unique_ptr<SeqPreconditioner> precond(new SeqPreconditioner(opA.getmat(), ilu_fillin, relax, ilu_milu, ilu_redblack, ilu_reorder_spheres, ilu_level_scheduling, single_precision));
             return precond;
         }
 
@@ -695,7 +698,9 @@ protected:
             const MILU_VARIANT ilu_milu  = parameters_.ilu_milu_;
             const bool ilu_redblack = parameters_.ilu_redblack_;
             const bool ilu_reorder_spheres = parameters_.ilu_reorder_sphere_;
-            return Pointer(new ParPreconditioner(opA.getmat(), comm, relax, ilu_milu, interiorCellNum_, ilu_redblack, ilu_reorder_spheres));
+            const bool ilu_level_scheduling = parameters_.ilu_level_scheduling_;
+            const bool single_precision = parameters_.preconditioner_single_precision_;
+            return Pointer(new ParPreconditioner(opA.getmat(), comm, relax, ilu_milu, interiorCellNum_, ilu_redblack, ilu_reorder_spheres, ilu_level_scheduling, single_precision));
         }
 #endif
 
@@ -847,6 +852,7 @@ protected:
             // a minimal preconditioner update.
             const int newton_iteration = this->simulator_.model().newtonMethod().numIterations();
             bool recreate_solver = false;
+            bool update_preconditioner = true;
             if (this->parameters_.cpr_reuse_setup_ == 0) {
                 // Always recreate solver.
                 recreate_solver = true;
@@ -860,10 +866,16 @@ protected:
                 if (this->iterations() > 10) {
                     recreate_solver = true;
                 }
-            } else {
-                assert(this->parameters_.cpr_reuse_setup_ == 3);
+            } else if (this->parameters_.cpr_reuse_setup_ == 3) {
                 assert(recreate_solver == false);
                 // Never recreate solver.
+            } else {
+                assert(this->parameters_.cpr_reuse_setup_ == 4);
+                // Choose between keeping, updating and recreating the
+                // preconditioner based on the measured costs.
+                const auto action = adaptivePreconditionerUpdate();
+                recreate_solver = (action == PreconditionerUpdate::Full);
+                update_preconditioner = (action == PreconditionerUpdate::Numeric);
             }
 
             std::function<Vector()> weightsCalculator;
@@ -901,112 +913,91 @@ protected:
                 }
             }
 
+            Dune::Timer setupTimer;
             if (recreate_solver || !flexibleSolver_) {
                 if (isParallel()) {
 #if HAVE_MPI
-                    assert(noGhostMat_);
-                    flexibleSolver_.reset(new FlexibleSolverType(prm_, *noGhostMat_, weightsCalculator, *comm_));
+                    flexibleSolver_.reset(new FlexibleSolverType(prm_, *matrix_, weightsCalculator, *comm_));
 #endif
                 } else {
                     flexibleSolver_.reset(new FlexibleSolverType(prm_, *matrix_, weightsCalculator));
                 }
+                full_setup_time_ = setupTimer.elapsed();
+                last_update_ = PreconditionerUpdate::Full;
             }
-            else
+            else if (update_preconditioner)
             {
+                // Numerical update only: the aggregates and the transfer
+                // operators are kept, the coarse level matrices and the
+                // smoothers are recomputed from the current matrix values.
                 flexibleSolver_->preconditioner().update();
+                numeric_setup_time_ = setupTimer.elapsed();
+                last_update_ = PreconditionerUpdate::Numeric;
+            }
+            else
+            {
+                last_update_ = PreconditionerUpdate::Stale;
             }
         }
 
-        /// Create sparsity pattern of matrix without off-diagonal ghost entries.
-        void noGhostAdjacency()
+        /// Decide how to refresh the preconditioner for the adaptive
+        /// reuse strategy (CprReuseSetup=4).
+        ///
+        /// The extra time spent in the last solve compared to the first
+        /// solve after a full setup is estimated from the iteration
+        /// counts. The preconditioner is kept as long as this is cheaper
+        /// than a numerical update, and recreated when even a numerical
+        /// update did not recover more than a full setup costs.
+        ///
+        /// All processes need to take the same decision, hence the
+        /// timings of this process are replaced by the maxima over all
+        /// processes in one reduction. This is the only communication of
+        /// the reuse strategies.
+        PreconditionerUpdate adaptivePreconditionerUpdate() const
         {
-            const auto& grid = simulator_.vanguard().grid();
-            const auto& gridView = simulator_.vanguard().gridView();
-            // For some reason simulator_.model().elementMapper() is not initialized at this stage.
-            // Hence const auto& elemMapper = simulator_.model().elementMapper(); does not work.
-            // Set it up manually
-            using ElementMapper =
-                Dune::MultipleCodimMultipleGeomTypeMapper<GridView>;
-            ElementMapper elemMapper(gridView, Dune::mcmgElementLayout());
-            typedef typename Matrix::size_type size_type;
-            size_type numCells = grid.size( 0 );
-            noGhostMat_.reset(new Matrix(numCells, numCells, Matrix::random));
-
-            std::vector<std::set<size_type>> pattern;
-            pattern.resize(numCells);
-
-            auto elemIt = gridView.template begin<0>();
-            const auto& elemEndIt = gridView.template end<0>();
-
-            //Loop over cells
-            for (; elemIt != elemEndIt; ++elemIt)
-            {
-                const auto& elem = *elemIt;
-                size_type idx = elemMapper.index(elem);
-                pattern[idx].insert(idx);
-
-                // Add well non-zero connections
-                for (auto wc = wellConnectionsGraph_[idx].begin(); wc!=wellConnectionsGraph_[idx].end(); ++wc)
-                    pattern[idx].insert(*wc);
-
-                // Add just a single element to ghost rows
-                if (elem.partitionType() != Dune::InteriorEntity)
-                {
-                    noGhostMat_->setrowsize(idx, pattern[idx].size());
-                }
-                else {
-                    auto isend = gridView.iend(elem);
-                    for (auto is = gridView.ibegin(elem); is!=isend; ++is)
-                    {
-                        //check if face has neighbor
-                        if (is->neighbor())
-                        {
-                            size_type nid = elemMapper.index(is->outside());
-                            pattern[idx].insert(nid);
-                        }
-                    }
-                    noGhostMat_->setrowsize(idx, pattern[idx].size());
-                }
+            if (!flexibleSolver_) {
+                return PreconditionerUpdate::Full;
             }
-            noGhostMat_->endrowsizes();
-            for (size_type dofId = 0; dofId < numCells; ++dofId)
-            {
-                auto nabIdx = pattern[dofId].begin();
-                auto endNab = pattern[dofId].end();
-                for (; nabIdx != endNab; ++nabIdx)
-                {
-                    noGhostMat_->addindex(dofId, *nabIdx);
-                }
+            double times[3] = { full_setup_time_, numeric_setup_time_, time_per_iteration_ };
+            simulator_.gridView().comm().max(times, 3);
+            const int extra_iterations = std::max(this->iterations() - reference_iterations_, 0);
+            const double extra_time = extra_iterations * times[2];
+            if (last_update_ == PreconditionerUpdate::Numeric && extra_time > times[0]) {
+                return PreconditionerUpdate::Full;
             }
-            noGhostMat_->endindices();
+            if (extra_time > times[1]) {
+                return PreconditionerUpdate::Numeric;
+            }
+            return PreconditionerUpdate::Stale;
         }
 
-        /// Set the ghost diagonal in noGhost to diag(1.0)
-        void setGhostsInNoGhost(Matrix& ng)
+        void recordFlexibleSolveTime(const double solve_time)
         {
-            ng=0;
+            time_per_iteration_ = solve_time / std::max(iterations_, 1);
+            if (last_update_ == PreconditionerUpdate::Full) {
+                reference_iterations_ = iterations_;
+            }
+        }
+
+        /// Zero out off-diagonal blocks on rows corresponding to overlap cells
+        /// Diagonal blocks on ovelap rows are set to diag(1.0).
+        void makeOverlapRowsInvalid(Matrix& matrix) const
+        {
+            //value to set on diagonal
             typedef typename Matrix::block_type MatrixBlockTypeT;
             MatrixBlockTypeT diag_block(0.0);
             for (int eq = 0; eq < Matrix::block_type::rows; ++eq)
                 diag_block[eq][eq] = 1.0;
 
-            //loop over precalculated ghost rows and columns
+            //loop over precalculated overlap rows and columns
             for (auto row = overlapRows_.begin(); row != overlapRows_.end(); row++ )
             {
                 int lcell = *row;
-                //diagonal block set to 1
-                ng[lcell][lcell] = diag_block;
-            }
-        }
+                // Zero out row.
+                matrix[lcell] = 0.0;
 
-        /// Copy interior rows to noghost matrix
-        void copyJacToNoGhost(const Matrix& jac, Matrix& ng)
-        {
-            //Loop over precalculated interior rows.
-            for (auto row = interiorRows_.begin(); row != interiorRows_.end(); row++ )
-            {
-                //Copy row
-                ng[*row] = jac[*row];
+                //diagonal block set to diag(1.0).
+                matrix[lcell][lcell] = diag_block;
             }
         }
 
@@ -1148,12 +1139,12 @@ protected:
 
         Matrix& getMatrix()
         {
-            return noGhostMat_ ? *noGhostMat_ : *matrix_;
+            return *matrix_;
         }
 
         const Matrix& getMatrix() const
         {
-            return noGhostMat_ ? *noGhostMat_ : *matrix_;
+            return *matrix_;
         }
 
         const Simulator& simulator_;
@@ -1163,13 +1154,16 @@ protected:
 
         // non-const to be able to scale the linear system
         Matrix* matrix_;
-        std::unique_ptr<Matrix> noGhostMat_;
         Vector *rhs_;
 
         std::unique_ptr<FlexibleSolverType> flexibleSolver_;
+        // Measurements used by the adaptive preconditioner reuse strategy.
+        PreconditionerUpdate last_update_ = PreconditionerUpdate::Full;
+        double full_setup_time_ = 0.0;
+        double numeric_setup_time_ = 0.0;
+        double time_per_iteration_ = 0.0;
+        int reference_iterations_ = 0;
         std::vector<int> overlapRows_;
-        std::vector<int> interiorRows_;
-        std::vector<std::set<int>> wellConnectionsGraph_;
 
         bool ownersFirst_;
         bool useWellConn_;
@@ -25,6 +25,7 @@
 #include <opm/simulators/linalg/PressureTransferPolicy.hpp>
 #include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
 #include <opm/simulators/linalg/twolevelmethodcpr.hh>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 
 #include <opm/common/ErrorMacros.hpp>
 
@@ -161,6 +162,7 @@ public:
 
     virtual void update() override
     {
+        OPM_TIMEBLOCK(cpr_setup);
         weights_ = weightsCalculator_();
         updateImpl(comm_);
     }
@@ -28,8 +28,11 @@
 #include <exception>
 
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <type_traits>
 #include <vector>
@@ -73,14 +76,16 @@ public:
     ParallelISTLInformation()
         : indexSet_(new ParallelIndexSet),
           remoteIndices_(new RemoteIndices(*indexSet_, *indexSet_, MPI_COMM_WORLD)),
-          communicator_(MPI_COMM_WORLD)
+          communicator_(MPI_COMM_WORLD),
+          haloPlan_(std::make_shared<HaloExchangePlan>())
     {}
     /// \brief Constructs an empty parallel information object using a communicator.
     /// \param communicator The communicator to use.
     ParallelISTLInformation(MPI_Comm communicator)
         : indexSet_(new ParallelIndexSet),
           remoteIndices_(new RemoteIndices(*indexSet_, *indexSet_, communicator)),
-          communicator_(communicator)
+          communicator_(communicator),
+          haloPlan_(std::make_shared<HaloExchangePlan>())
     {}
     /// \brief Constructs a parallel information object from the specified information.
     /// \param indexSet The parallel index set to use.
@@ -89,14 +94,15 @@ public:
     ParallelISTLInformation(const std::shared_ptr<ParallelIndexSet>& indexSet,
                             const std::shared_ptr<RemoteIndices>& remoteIndices,
                             MPI_Comm communicator)
-        : indexSet_(indexSet), remoteIndices_(remoteIndices), communicator_(communicator)
+        : indexSet_(indexSet), remoteIndices_(remoteIndices), communicator_(communicator),
+          haloPlan_(std::make_shared<HaloExchangePlan>())
     {}
     /// \brief Copy constructor.
     ///
     /// The information will be shared by the the two objects.
     ParallelISTLInformation(const ParallelISTLInformation& other)
     : indexSet_(other.indexSet_), remoteIndices_(other.remoteIndices_),
-      communicator_(other.communicator_)
+      communicator_(other.communicator_), haloPlan_(other.haloPlan_)
     {}
     /// \brief Get a pointer to the underlying index set.
     std::shared_ptr<ParallelIndexSet> indexSet() const
@@ -144,21 +150,13 @@ public:
     template<class T>
     void copyOwnerToAll (const T& source, T& dest) const
     {
-        typedef Dune::Combine<Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner>,Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::overlap>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> OwnerOverlapSet;
-        typedef Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner> OwnerSet;
-        typedef Dune::Combine<OwnerOverlapSet, Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::copy>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> AllSet;
-      OwnerSet sourceFlags;
-      AllSet destFlags;
-      Dune::Interface interface(communicator_);
-      if( !remoteIndices_->isSynced() )
-      {
-          remoteIndices_->rebuild<false>();
-      }
-      interface.build(*remoteIndices_,sourceFlags,destFlags);
-      Dune::BufferedCommunicator communicator;
-      communicator.template build<T>(interface);
-      communicator.template forward<CopyGatherScatter<T> >(source,dest);
-      communicator.free();
+        if( !remoteIndices_->isSynced() )
+        {
+            remoteIndices_->rebuild<false>();
+        }
+        haloPlan_->update(*remoteIndices_, *indexSet_, communicator_);
+        haloPlan_->start(source);
+        haloPlan_->finish(dest);
     }
     template<class T>
     const std::vector<double>& updateOwnerMask(const T& container) const
@@ -326,21 +324,148 @@ private:
         }
         computeLocalReduction<I+1>(containers, operators, values);
     }
-    /** \brief gather/scatter callback for communcation */
-    template<typename T>
-    struct CopyGatherScatter
+    /// \brief The send and receive lists of copyOwnerToAll() for all neighbours.
+    ///
+    /// The lists are built once from the remote indices and are only rebuilt
+    /// when the index set changes. The message buffers are kept between
+    /// exchanges and only grow. The messages are sent on a duplicate of the
+    /// communicator, so they cannot be matched by other communication. The
+    /// duplicate is created when the plan is built, which all processes have
+    /// to do together.
+    class HaloExchangePlan
     {
-        typedef typename Dune::CommPolicy<T>::IndexedType V;
+    public:
+        HaloExchangePlan() = default;
+        HaloExchangePlan(const HaloExchangePlan&) = delete;
+        HaloExchangePlan& operator=(const HaloExchangePlan&) = delete;
 
-      static V gather(const T& a, std::size_t i)
-      {
-        return a[i];
-      }
+        ~HaloExchangePlan()
+        {
+            freeCommunicator();
+        }
+
+        void update(const RemoteIndices& remoteIndices, const ParallelIndexSet& indexSet,
+                    const Dune::CollectiveCommunication<MPI_Comm>& communicator)
+        {
+            if( built_ && seqNo_ == indexSet.seqNo() )
+            {
+                return;
+            }
+            assert(requests_.empty());
+            typedef Dune::Combine<Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner>,Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::overlap>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> OwnerOverlapSet;
+            typedef Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner> OwnerSet;
+            typedef Dune::Combine<OwnerOverlapSet, Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::copy>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> AllSet;
+            OwnerSet sourceFlags;
+            AllSet destFlags;
+            Dune::Interface interface(communicator);
+            interface.build(remoteIndices, sourceFlags, destFlags);
+
+            neighbours_.clear();
+            for( const auto& entry : interface.interfaces() )
+            {
+                Neighbour neighbour;
+                neighbour.rank = entry.first;
+                const auto& send = entry.second.first;
+                const auto& recv = entry.second.second;
+                for( std::size_t i = 0; i < send.size(); ++i )
+                {
+                    neighbour.sendIndices.push_back(send[i]);
+                }
+                for( std::size_t i = 0; i < recv.size(); ++i )
+                {
+                    neighbour.recvIndices.push_back(recv[i]);
+                }
+                if( !neighbour.sendIndices.empty() || !neighbour.recvIndices.empty() )
+                {
+                    neighbours_.push_back(std::move(neighbour));
+                }
+            }
+            interface.free();
+            freeCommunicator();
+            MPI_Comm_dup(communicator, &communicator_);
+            seqNo_ = indexSet.seqNo();
+            built_ = true;
+        }
 
-      static void scatter(T& a, V v, std::size_t i)
-      {
-        a[i] = v;
-      }
+        template<class T>
+        void start(const T& source)
+        {
+            typedef typename Dune::CommPolicy<T>::IndexedType V;
+            static_assert(std::is_trivially_copyable<V>::value,
+                          "copyOwnerToAll sends the values as raw bytes");
+            assert(requests_.empty());
+            for( auto& neighbour : neighbours_ )
+            {
+                if( neighbour.recvIndices.empty() )
+                    continue;
+                neighbour.recvBuffer.resize(neighbour.recvIndices.size() * sizeof(V));
+                requests_.emplace_back();
+                MPI_Irecv(neighbour.recvBuffer.data(), static_cast<int>(neighbour.recvBuffer.size()), MPI_BYTE,
+                          neighbour.rank, tag_, communicator_, &requests_.back());
+            }
+            for( auto& neighbour : neighbours_ )
+            {
+                if( neighbour.sendIndices.empty() )
+                    continue;
+                neighbour.sendBuffer.resize(neighbour.sendIndices.size() * sizeof(V));
+                char* buffer = neighbour.sendBuffer.data();
+                for( const auto index : neighbour.sendIndices )
+                {
+                    const V value = source[index];
+                    std::memcpy(buffer, &value, sizeof(V));
+                    buffer += sizeof(V);
+                }
+                requests_.emplace_back();
+                MPI_Isend(neighbour.sendBuffer.data(), static_cast<int>(neighbour.sendBuffer.size()), MPI_BYTE,
+                          neighbour.rank, tag_, communicator_, &requests_.back());
+            }
+        }
+
+        template<class T>
+        void finish(T& dest)
+        {
+            typedef typename Dune::CommPolicy<T>::IndexedType V;
+            MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+            requests_.clear();
+            for( const auto& neighbour : neighbours_ )
+            {
+                const char* buffer = neighbour.recvBuffer.data();
+                for( const auto index : neighbour.recvIndices )
+                {
+                    V value;
+                    std::memcpy(&value, buffer, sizeof(V));
+                    dest[index] = value;
+                    buffer += sizeof(V);
+                }
+            }
+        }
+
+    private:
+        void freeCommunicator()
+        {
+            int finalized = 0;
+            MPI_Finalized(&finalized);
+            if( communicator_ != MPI_COMM_NULL && !finalized )
+            {
+                MPI_Comm_free(&communicator_);
+            }
+            communicator_ = MPI_COMM_NULL;
+        }
+
+        struct Neighbour
+        {
+            int rank;
+            std::vector<std::size_t> sendIndices;
+            std::vector<std::size_t> recvIndices;
+            std::vector<char> sendBuffer;
+            std::vector<char> recvBuffer;
+        };
+        static constexpr int tag_ = 4711;
+        bool built_ = false;
+        int seqNo_ = 0;
+        MPI_Comm communicator_ = MPI_COMM_NULL;
+        std::vector<Neighbour> neighbours_;
+        std::vector<MPI_Request> requests_;
     };
     template<class T>
     class IndexSetInserter
@@ -376,6 +501,8 @@ private:
     std::shared_ptr<RemoteIndices> remoteIndices_;
     Dune::CollectiveCommunication<MPI_Comm> communicator_;
     mutable std::vector<double> ownerMask_;
+    /// \brief The exchange plan of copyOwnerToAll(), shared by all copies.
+    std::shared_ptr<HaloExchangePlan> haloPlan_;
 };
 
     namespace Reduction
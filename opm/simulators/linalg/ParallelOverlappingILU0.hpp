@@ -22,14 +22,17 @@
 
 #include <opm/simulators/linalg/GraphColoring.hpp>
 #include <opm/simulators/linalg/PreconditionerWithUpdate.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <dune/common/version.hh>
+#include <dune/common/fmatrix.hh>
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/paamg/smoother.hh>
 #include <dune/istl/paamg/graph.hh>
 #include <dune/istl/paamg/pinfo.hh>
 
+#include <algorithm>
 #include <type_traits>
 #include <numeric>
 #include <limits>
@@ -98,9 +101,18 @@ class ParallelOverlappingILU0Args
     {
         return n_;
     }
+    void setSinglePrecision(bool single_precision)
+    {
+        single_precision_ = single_precision;
+    }
+    bool getSinglePrecision() const
+    {
+        return single_precision_;
+    }
  private:
     MILU_VARIANT milu_;
     int n_;
+    bool single_precision_ = false;
 };
 } // end namespace Opm
 
@@ -142,7 +154,9 @@ struct ConstructionTraits<Opm::ParallelOverlappingILU0<Matrix,Domain,Range,Paral
                       args.getComm(),
                       args.getArgs().getN(),
                       args.getArgs().relaxationFactor,
-                      args.getArgs().getMilu()) );
+                      args.getArgs().getMilu(),
+                      false, true, false,
+                      args.getArgs().getSinglePrecision()) );
     }
 
 #if ! DUNE_VERSION_NEWER(DUNE_ISTL, 2, 7)
@@ -494,6 +508,23 @@ namespace Opm
         }
     }
 
+      //! copy blocks into blocks of a possibly different field type
+      template<class SrcBlocks, class DstBlocks>
+      void convertBlocks(const SrcBlocks& src, DstBlocks& dst)
+      {
+        dst.resize( src.size() );
+        for ( std::size_t b = 0; b < src.size(); ++b )
+        {
+          for ( std::size_t i = 0; i < src[ b ].N(); ++i )
+          {
+            for ( std::size_t j = 0; j < src[ b ].M(); ++j )
+            {
+              dst[ b ][ i ][ j ] = src[ b ][ i ][ j ];
+            }
+          }
+        }
+      }
+
       //! compute ILU decomposition of A. A is overwritten by its decomposition
       template<class M, class CRS, class InvVector>
       void convertToCRS(const M& A, CRS& lower, CRS& upper, InvVector& inv )
@@ -620,6 +651,8 @@ public:
 
     typedef typename matrix_type::block_type  block_type;
     typedef typename matrix_type::size_type   size_type;
+    //! \brief The block type used to store the factors in single precision.
+    typedef Dune::FieldMatrix< float, block_type::rows, block_type::cols > float_block_type;
 
 protected:
     struct CRS
@@ -664,12 +697,21 @@ protected:
       {
           rows_.clear();
           values_.clear();
+          floatValues_.clear();
           cols_.clear();
           nRows_= 0;
       }
 
+      //! \brief Move the values to single precision storage and release the double ones.
+      void toSinglePrecision()
+      {
+          detail::convertBlocks( values_, floatValues_ );
+          std::vector< block_type >().swap( values_ );
+      }
+
       std::vector< size_type  > rows_;
       std::vector< block_type > values_;
+      std::vector< float_block_type > floatValues_;
       std::vector< size_type  > cols_;
       size_type nRows_;
     };
@@ -693,19 +735,28 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, the triangular solves in apply are done level
+                              by level, with the rows of each level distributed
+                              among the threads.
+      \param single_precision If true, the factors are stored in single precision
+                              to reduce the memory traffic in apply. The vectors
+                              are still in double precision.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool single_precision=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(nullptr), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(n),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling),
+          singlePrecision_(single_precision)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -724,19 +775,28 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, the triangular solves in apply are done level
+                              by level, with the rows of each level distributed
+                              among the threads.
+      \param single_precision If true, the factors are stored in single precision
+                              to reduce the memory traffic in apply. The vectors
+                              are still in double precision.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool single_precision=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(n),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling),
+          singlePrecision_(single_precision)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -755,12 +815,17 @@ public:
                   The vertices on each layer aound it (same distance) are
                   ordered consecutivly. If false, we preserver the order of
                   the vertices with the same color.
+      \param level_scheduling If true, the triangular solves in apply are done level
+                  by level, with the rows of each level distributed
+                  among the threads.
+      \param single_precision If true, the factors are stored in single precision.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const field_type w, MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
-        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere )
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool single_precision=false)
+        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere, level_scheduling, single_precision )
     {
     }
 
@@ -776,19 +841,28 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, the triangular solves in apply are done level
+                              by level, with the rows of each level distributed
+                              among the threads.
+      \param single_precision If true, the factors are stored in single precision
+                              to reduce the memory traffic in apply. The vectors
+                              are still in double precision.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool single_precision=false)
         : lower_(),
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(0),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling),
+          singlePrecision_(single_precision)
     {
         interiorSize_ = A.N();
         // BlockMatrix is a Subclass of FieldMatrix that just adds
@@ -809,13 +883,20 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param level_scheduling If true, the triangular solves in apply are done level
+                              by level, with the rows of each level distributed
+                              among the threads.
+      \param single_precision If true, the factors are stored in single precision
+                              to reduce the memory traffic in apply. The vectors
+                              are still in double precision.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm,
                              const field_type w, MILU_VARIANT milu,
                              size_type interiorSize, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool level_scheduling=false,
+                             bool single_precision=false)
         : lower_(),
           upper_(),
           inv_(),
@@ -823,7 +904,9 @@ public:
           relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
           interiorSize_(interiorSize),
           A_(&reinterpret_cast<const Matrix&>(A)), iluIteration_(0),
-          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere)
+          milu_(milu), redBlack_(redblack), reorderSphere_(reorder_sphere),
+          levelScheduling_(level_scheduling),
+          singlePrecision_(single_precision)
     {
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
@@ -848,15 +931,11 @@ public:
     */
     virtual void apply (Domain& v, const Range& d) override
     {
+        OPM_TIMEBLOCK(ilu_apply);
         Range& md = reorderD(d);
         Domain& mv = reorderV(v);
 
-        // iterator types
-        typedef typename Range ::block_type  dblock;
-        typedef typename Domain::block_type  vblock;
-
         const size_type iEnd = lower_.rows();
-        const size_type lastRow = iEnd - 1;
         size_type upperLoppStart = iEnd - interiorSize_;
         size_type lowerLoopEnd = interiorSize_;
         if( iEnd != upper_.rows() )
@@ -864,35 +943,15 @@ public:
             OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
         }
 
-        // lower triangular solve
-        for( size_type i=0; i<lowerLoopEnd; ++ i )
+        if ( singlePrecision_ )
         {
-          dblock rhs( md[ i ] );
-          const size_type rowI     = lower_.rows_[ i ];
-          const size_type rowINext = lower_.rows_[ i+1 ];
-
-          for( size_type col = rowI; col < rowINext; ++ col )
-          {
-            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
-          }
-
-          mv[ i ] = rhs;  // Lii = I
+            triangularSolves( lower_.floatValues_, upper_.floatValues_, invFloat_,
+                              md, mv, lowerLoopEnd, upperLoppStart, iEnd );
         }
-
-        for( size_type i=upperLoppStart; i<iEnd; ++ i )
+        else
         {
-            vblock& vBlock = mv[ lastRow - i ];
-            vblock rhs ( vBlock );
-            const size_type rowI     = upper_.rows_[ i ];
-            const size_type rowINext = upper_.rows_[ i+1 ];
-
-            for( size_type col = rowI; col < rowINext; ++ col )
-            {
-                upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
-            }
-
-            // apply inverse and store result
-            inv_[ i ].mv( rhs, vBlock);
+            triangularSolves( lower_.values_, upper_.values_, inv_,
+                              md, mv, lowerLoopEnd, upperLoppStart, iEnd );
         }
 
         copyOwnerToAll( mv );
@@ -923,6 +982,7 @@ public:
 
     virtual void update() override
     {
+        OPM_TIMEBLOCK(ilu_decomposition);
         // (For older DUNE versions the communicator might be
         // invalid if redistribution in AMG happened on the coarset level.
         // Therefore we check for nonzero size
@@ -1066,9 +1126,192 @@ public:
 
         // store ILU in simple CRS format
         detail::convertToCRS( *ILU, lower_, upper_, inv_ );
+
+        if ( singlePrecision_ )
+        {
+            lower_.toSinglePrecision();
+            upper_.toSinglePrecision();
+            detail::convertBlocks( inv_, invFloat_ );
+            std::vector< block_type >().swap( inv_ );
+        }
+
+        if ( levelScheduling_ )
+        {
+            computeLevels();
+        }
     }
 
 protected:
+    /// \brief Forward and backward substitution with the factors given by their values.
+    ///
+    /// The values are either the double or the single precision ones, the
+    /// sparsity pattern is shared.
+    template <class Values, class InvValues>
+    void triangularSolves( const Values& lowerValues, const Values& upperValues, const InvValues& inv,
+                           const Range& md, Domain& mv, const size_type lowerLoopEnd,
+                           const size_type upperLoopStart, const size_type iEnd ) const
+    {
+        const size_type lastRow = iEnd - 1;
+        if ( levelScheduling_ )
+        {
+            levelScheduledSolve( lowerValues, upperValues, inv, md, mv, lastRow );
+        }
+        else
+        {
+            // lower triangular solve
+            for( size_type i=0; i<lowerLoopEnd; ++ i )
+            {
+                lowerSolveRow( lowerValues, i, md, mv );
+            }
+
+            // upper triangular solve
+            for( size_type i=upperLoopStart; i<iEnd; ++ i )
+            {
+                upperSolveRow( upperValues, inv, i, lastRow, mv );
+            }
+        }
+    }
+
+    /// \brief Forward substitution for row i of the lower triangular factor.
+    template <class Values>
+    void lowerSolveRow( const Values& lowerValues, const size_type i, const Range& md, Domain& mv ) const
+    {
+        typename Range::block_type rhs( md[ i ] );
+        const size_type rowI     = lower_.rows_[ i ];
+        const size_type rowINext = lower_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            lowerValues[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
+        }
+
+        mv[ i ] = rhs;  // Lii = I
+    }
+
+    /// \brief Backward substitution for row i of the (reversely stored) upper triangular factor.
+    template <class Values, class InvValues>
+    void upperSolveRow( const Values& upperValues, const InvValues& inv,
+                        const size_type i, const size_type lastRow, Domain& mv ) const
+    {
+        typename Domain::block_type& vBlock = mv[ lastRow - i ];
+        typename Domain::block_type rhs ( vBlock );
+        const size_type rowI     = upper_.rows_[ i ];
+        const size_type rowINext = upper_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            upperValues[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+        }
+
+        // apply inverse and store result
+        inv[ i ].mv( rhs, vBlock);
+    }
+
+    /// \brief Triangular solves where the independent rows of each level are
+    ///        distributed among the threads.
+    ///
+    /// Each row is computed exactly as in the sequential sweep, hence the
+    /// result does not depend on the number of threads.
+    template <class Values, class InvValues>
+    void levelScheduledSolve( const Values& lowerValues, const Values& upperValues, const InvValues& inv,
+                              const Range& md, Domain& mv, const size_type lastRow ) const
+    {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            for( std::size_t level = 0; level + 1 < lowerLevelStart_.size(); ++level )
+            {
+                const size_type levelBegin = lowerLevelStart_[ level ];
+                const size_type levelEnd   = lowerLevelStart_[ level+1 ];
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+                for( size_type idx = levelBegin; idx < levelEnd; ++idx )
+                {
+                    lowerSolveRow( lowerValues, lowerLevelRows_[ idx ], md, mv );
+                }
+            }
+
+            for( std::size_t level = 0; level + 1 < upperLevelStart_.size(); ++level )
+            {
+                const size_type levelBegin = upperLevelStart_[ level ];
+                const size_type levelEnd   = upperLevelStart_[ level+1 ];
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+                for( size_type idx = levelBegin; idx < levelEnd; ++idx )
+                {
+                    upperSolveRow( upperValues, inv, upperLevelRows_[ idx ], lastRow, mv );
+                }
+            }
+        }
+    }
+
+    /// \brief Compute the dependency levels of the rows of the triangular factors.
+    ///
+    /// A row only depends on rows in lower levels, hence all rows of a level
+    /// can be processed concurrently. Only the interior rows take part in the
+    /// solves, entries referring to other rows are constant during a sweep.
+    void computeLevels()
+    {
+        const size_type iEnd = lower_.rows();
+        std::vector<size_type> level( interiorSize_, 0 );
+
+        // lower factor: row i depends on the rows of its entries left of the diagonal
+        for( size_type i = 0; i < interiorSize_; ++i )
+        {
+            size_type rowLevel = 0;
+            for( size_type col = lower_.rows_[ i ]; col < lower_.rows_[ i+1 ]; ++col )
+            {
+                rowLevel = std::max( rowLevel, level[ lower_.cols_[ col ] ] + 1 );
+            }
+            level[ i ] = rowLevel;
+        }
+        groupByLevel( level, 0, lowerLevelStart_, lowerLevelRows_ );
+
+        // upper factor: row i is stored reversely and updates mv[ lastRow - i ]
+        const size_type upperLoopStart = iEnd - interiorSize_;
+        const size_type lastRow = iEnd - 1;
+        std::vector<size_type> rowLevelOf( interiorSize_, 0 );
+        for( size_type i = upperLoopStart; i < iEnd; ++i )
+        {
+            size_type rowLevel = 0;
+            for( size_type col = upper_.rows_[ i ]; col < upper_.rows_[ i+1 ]; ++col )
+            {
+                const size_type colIndex = upper_.cols_[ col ];
+                if( colIndex < interiorSize_ )
+                {
+                    rowLevel = std::max( rowLevel, rowLevelOf[ colIndex ] + 1 );
+                }
+            }
+            rowLevelOf[ lastRow - i ] = rowLevel;
+            level[ i - upperLoopStart ] = rowLevel;
+        }
+        groupByLevel( level, upperLoopStart, upperLevelStart_, upperLevelRows_ );
+    }
+
+    /// \brief Sort the row indices offset + i by level[ i ] (counting sort, stable).
+    static void groupByLevel( const std::vector<size_type>& level, const size_type offset,
+                              std::vector<size_type>& levelStart, std::vector<size_type>& levelRows )
+    {
+        const size_type numLevels = level.empty() ? 0 :
+            *std::max_element( level.begin(), level.end() ) + 1;
+        levelStart.assign( numLevels + 1, 0 );
+        for( const auto l : level )
+        {
+            ++levelStart[ l + 1 ];
+        }
+        std::partial_sum( levelStart.begin(), levelStart.end(), levelStart.begin() );
+
+        std::vector<size_type> next( levelStart.begin(), levelStart.end() - 1 );
+        levelRows.resize( level.size() );
+        for( size_type i = 0; i < level.size(); ++i )
+        {
+            levelRows[ next[ level[ i ] ]++ ] = offset + i;
+        }
+    }
+
     /// \brief Reorder D if needed and return a reference to it.
     Range& reorderD(const Range& d)
     {
@@ -1127,6 +1370,8 @@ protected:
     CRS lower_;
     CRS upper_;
     std::vector< block_type > inv_;
+    //! \brief The inverted diagonal blocks if the factors are stored in single precision.
+    std::vector< float_block_type > invFloat_;
     //! \brief the reordering of the unknowns
     std::vector< std::size_t > ordering_;
     //! \brief The reordered right hand side
@@ -1144,6 +1389,17 @@ protected:
     MILU_VARIANT milu_;
     bool redBlack_;
     bool reorderSphere_;
+    //! \brief Whether to do the triangular solves level by level using multiple threads.
+    bool levelScheduling_;
+    //! \brief Level l of the lower factor consists of the rows
+    //!        lowerLevelRows_[ lowerLevelStart_[ l ] ] ... lowerLevelRows_[ lowerLevelStart_[ l+1 ]-1 ]
+    std::vector< size_type > lowerLevelStart_;
+    std::vector< size_type > lowerLevelRows_;
+    //! \brief The levels of the (reversely stored) upper factor.
+    std::vector< size_type > upperLevelStart_;
+    std::vector< size_type > upperLevelRows_;
+    //! \brief Whether the factors are stored in single precision.
+    bool singlePrecision_;
 };
 
 } // end namespace Opm
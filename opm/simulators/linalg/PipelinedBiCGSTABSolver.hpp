@@ -0,0 +1,252 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PIPELINEDBICGSTABSOLVER_HEADER_INCLUDED
+#define OPM_PIPELINEDBICGSTABSOLVER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/GlobalDotProducts.hpp>
+
+#include <dune/common/timer.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace Dune
+{
+
+/// Pipelined BiCGSTAB with right preconditioning.
+///
+/// The recurrences of Cools and Vanroose (2017) keep the products of
+/// the operator and the preconditioner with all search directions, so
+/// the dot products of an iteration are collected in two groups. Each
+/// group is summed over the processes with one non-blocking reduction
+/// while the next preconditioner and operator applications are
+/// computed. Standard BiCGSTAB needs four to five blocking reductions
+/// per iteration.
+///
+/// The iterates are the same as those of BiCGSTAB in exact arithmetic,
+/// but the recursively updated residual may drift further from the
+/// true residual.
+template <class X>
+class PipelinedBiCGSTABSolver : public InverseOperator<X, X>
+{
+public:
+    using domain_type = X;
+    using range_type = X;
+    using field_type = typename X::field_type;
+
+    PipelinedBiCGSTABSolver(LinearOperator<X, X>& op,
+                            Preconditioner<X, X>& prec,
+                            const GlobalDotProducts& dots,
+                            double reduction,
+                            int maxit,
+                            int verbose)
+        : op_(op)
+        , prec_(prec)
+        , dots_(dots)
+        , reduction_(reduction)
+        , maxit_(maxit)
+        , verbose_(verbose)
+    {
+    }
+
+    virtual void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        res.clear();
+
+        prec_.pre(x, b);
+        op_.applyscaleadd(-1.0, x, b);
+        X& r = b;
+        const X r0(r);
+
+        // rh = M^-1 r, w = A rh, wh = M^-1 w, t = A wh
+        X rh(x);
+        applyPrec(rh, r);
+        X w(r);
+        op_.apply(rh, w);
+        X wh(x);
+        X t(r);
+
+        std::vector<double> values = { dots_.local(r0, r), dots_.local(r0, w) };
+        dots_.start(values);
+        applyPrec(wh, w);
+        op_.apply(wh, t);
+        dots_.finish();
+
+        double rho = values[0];
+        const double def0 = std::sqrt(rho);
+        if (verbose_ > 0) {
+            std::cout << "=== PipelinedBiCGSTABSolver" << std::endl;
+            printOutput(0, def0, def0);
+        }
+        if (!std::isfinite(def0) || def0 < 1e-30) {
+            res.converged = std::isfinite(def0);
+            res.iterations = 0;
+            res.reduction = 0;
+            res.conv_rate = 0;
+            res.elapsed = watch.elapsed();
+            prec_.post(x);
+            return;
+        }
+        double alpha = rho / values[1];
+        double beta = 0.0;
+        double omega = 0.0;
+
+        X ph(rh), s(w), sh(wh), z(t);
+        X zh(x), v(r), q(r), qh(x), y(r);
+
+        double def = def0;
+        int it = 1;
+        for (; it <= maxit_; ++it) {
+            if (it > 1) {
+                // ph = rh + beta (ph - omega sh), and likewise for
+                // s = A ph, sh = M^-1 s and z = A sh
+                update(ph, rh, sh, beta, omega);
+                update(s, w, z, beta, omega);
+                update(sh, wh, zh, beta, omega);
+                update(z, t, v, beta, omega);
+            }
+
+            // q = r - alpha s, qh = rh - alpha sh, y = A qh = w - alpha z
+            q = r;
+            q.axpy(-alpha, s);
+            qh = rh;
+            qh.axpy(-alpha, sh);
+            y = w;
+            y.axpy(-alpha, z);
+
+            values = { dots_.local(q, y), dots_.local(y, y) };
+            dots_.start(values);
+            applyPrec(zh, z);
+            op_.apply(zh, v);
+            dots_.finish();
+
+            if (!(std::abs(values[1]) > 0.0)) {
+                break;
+            }
+            omega = values[0] / values[1];
+
+            x.axpy(alpha, ph);
+            x.axpy(omega, qh);
+            // r = q - omega y
+            r = q;
+            r.axpy(-omega, y);
+            // rh = qh - omega (wh - alpha zh)
+            rh = qh;
+            rh.axpy(-omega, wh);
+            rh.axpy(omega * alpha, zh);
+            // w = y - omega (t - alpha v)
+            w = y;
+            w.axpy(-omega, t);
+            w.axpy(omega * alpha, v);
+
+            values = { dots_.local(r0, r), dots_.local(r0, w), dots_.local(r0, s),
+                       dots_.local(r0, z), dots_.local(r, r) };
+            dots_.start(values);
+            applyPrec(wh, w);
+            op_.apply(wh, t);
+            dots_.finish();
+
+            def = std::sqrt(values[4]);
+            if (verbose_ > 1) {
+                printOutput(it, def, def0);
+            }
+            if (!std::isfinite(def) || def < def0 * reduction_ || def < 1e-30) {
+                break;
+            }
+
+            const double rhoNew = values[0];
+            if (!(std::abs(omega) > 0.0) || !(std::abs(rho) > 0.0)) {
+                break;
+            }
+            beta = (alpha / omega) * (rhoNew / rho);
+            rho = rhoNew;
+            const double denominator = values[1] + beta * values[2] - beta * omega * values[3];
+            if (!(std::abs(denominator) > 0.0)) {
+                break;
+            }
+            alpha = rho / denominator;
+        }
+
+        prec_.post(x);
+
+        res.iterations = std::min(it, maxit_);
+        res.reduction = def / def0;
+        res.converged = std::isfinite(def) && (def < def0 * reduction_ || def < 1e-30);
+        res.conv_rate = std::pow(res.reduction, 1.0 / std::max(res.iterations, 1));
+        res.elapsed = watch.elapsed();
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate << ", T=" << res.elapsed
+                      << ", TIT=" << res.elapsed / std::max(res.iterations, 1)
+                      << ", IT=" << res.iterations << std::endl;
+        }
+    }
+
+    virtual void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+        const double savedReduction = reduction_;
+        reduction_ = reduction;
+        apply(x, b, res);
+        reduction_ = savedReduction;
+    }
+
+    virtual SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+
+private:
+    void applyPrec(X& v, const X& d)
+    {
+        v = 0.0;
+        prec_.apply(v, d);
+    }
+
+    // a = b + beta (a - omega c)
+    static void update(X& a, const X& b, const X& c, const double beta, const double omega)
+    {
+        a *= beta;
+        a.axpy(-beta * omega, c);
+        a += b;
+    }
+
+    void printOutput(const int it, const double def, const double def0) const
+    {
+        std::cout << std::setw(5) << it << std::setw(16) << def
+                  << std::setw(16) << def / def0 << std::endl;
+    }
+
+    LinearOperator<X, X>& op_;
+    Preconditioner<X, X>& prec_;
+    GlobalDotProducts dots_;
+    double reduction_;
+    int maxit_;
+    int verbose_;
+};
+
+} // namespace Dune
+
+#endif // OPM_PIPELINEDBICGSTABSOLVER_HEADER_INCLUDED
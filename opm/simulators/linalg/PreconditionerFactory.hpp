@@ -172,6 +172,7 @@ private:
         smootherArgs.setN(iluwitdh);
         const MILU_VARIANT milu = convertString2Milu(prm.get<std::string>("milutype", std::string("ilu")));
         smootherArgs.setMilu(milu);
+        smootherArgs.setSinglePrecision(prm.get<bool>("single_precision", false));
         // smootherArgs.overlap=SmootherArgs::vertex;
         // smootherArgs.overlap=SmootherArgs::none;
         // smootherArgs.overlap=SmootherArgs::aggregate;
@@ -211,21 +212,27 @@ private:
         using C = Comm;
         doAddCreator("ILU0", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
             const double w = prm.get<double>("relaxation", 1.0);
+            const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+            const bool single_precision = prm.get<bool>("single_precision", false);
             return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V, C>>(
-                op.getmat(), comm, 0, w, Opm::MILU_VARIANT::ILU);
+                op.getmat(), comm, 0, w, Opm::MILU_VARIANT::ILU, false, true, level_scheduling, single_precision);
         });
         doAddCreator("ParOverILU0", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
             const double w = prm.get<double>("relaxation", 1.0);
             const int n = prm.get<int>("ilulevel", 0);
+            const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+            const bool single_precision = prm.get<bool>("single_precision", false);
             // Already a parallel preconditioner. Need to pass comm, but no need to wrap it in a BlockPreconditioner.
             return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V, C>>(
-                op.getmat(), comm, n, w, Opm::MILU_VARIANT::ILU);
+                op.getmat(), comm, n, w, Opm::MILU_VARIANT::ILU, false, true, level_scheduling, single_precision);
         });
         doAddCreator("ILUn", [](const O& op, const P& prm, const std::function<Vector()>&, const C& comm) {
             const int n = prm.get<int>("ilulevel", 0);
             const double w = prm.get<double>("relaxation", 1.0);
+            const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+            const bool single_precision = prm.get<bool>("single_precision", false);
             return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V, C>>(
-                op.getmat(), comm, n, w, Opm::MILU_VARIANT::ILU);
+                op.getmat(), comm, n, w, Opm::MILU_VARIANT::ILU, false, true, level_scheduling, single_precision);
         });
         doAddCreator("Jac", [](const O& op, const P& prm, const std::function<Vector()>&,
                                const C& comm) {
@@ -280,20 +287,26 @@ private:
         using P = boost::property_tree::ptree;
         doAddCreator("ILU0", [](const O& op, const P& prm, const std::function<Vector()>&) {
             const double w = prm.get<double>("relaxation", 1.0);
+            const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+            const bool single_precision = prm.get<bool>("single_precision", false);
             return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), 0, w, Opm::MILU_VARIANT::ILU);
+                op.getmat(), 0, w, Opm::MILU_VARIANT::ILU, false, true, level_scheduling, single_precision);
         });
         doAddCreator("ParOverILU0", [](const O& op, const P& prm, const std::function<Vector()>&) {
             const double w = prm.get<double>("relaxation", 1.0);
             const int n = prm.get<int>("ilulevel", 0);
+            const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+            const bool single_precision = prm.get<bool>("single_precision", false);
             return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+                op.getmat(), n, w, Opm::MILU_VARIANT::ILU, false, true, level_scheduling, single_precision);
         });
         doAddCreator("ILUn", [](const O& op, const P& prm, const std::function<Vector()>&) {
             const int n = prm.get<int>("ilulevel", 0);
             const double w = prm.get<double>("relaxation", 1.0);
+            const bool level_scheduling = prm.get<bool>("level_scheduling", false);
+            const bool single_precision = prm.get<bool>("single_precision", false);
             return std::make_shared<Opm::ParallelOverlappingILU0<M, V, V>>(
-                op.getmat(), n, w, Opm::MILU_VARIANT::ILU);
+                op.getmat(), n, w, Opm::MILU_VARIANT::ILU, false, true, level_scheduling, single_precision);
         });
         doAddCreator("Jac", [](const O& op, const P& prm, const std::function<Vector()>&) {
             const int n = prm.get<int>("repeats", 1);
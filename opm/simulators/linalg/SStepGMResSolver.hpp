@@ -0,0 +1,432 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SSTEPGMRESSOLVER_HEADER_INCLUDED
+#define OPM_SSTEPGMRESSOLVER_HEADER_INCLUDED
+
+#include <opm/simulators/linalg/GlobalDotProducts.hpp>
+
+#include <dune/common/timer.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace Dune
+{
+
+/// Restarted s-step GMRes with right preconditioning.
+///
+/// The Krylov basis is extended by blocks of s vectors. The s products
+/// with the preconditioned operator of a block are computed first, then
+/// the block is orthogonalized against the basis with block classical
+/// Gram-Schmidt and a Cholesky QR. The dot products of a block are
+/// summed over the processes in one reduction, and the columns of the
+/// Hessenberg matrix are recovered from the factors. Standard GMRes
+/// with modified Gram-Schmidt needs j + 2 reductions for the j-th
+/// vector.
+///
+/// The block is orthogonalized a second time, with one more reduction,
+/// when the Gram-Schmidt step cancels most of a vector. Vectors that
+/// are still linearly dependent end the restart cycle early.
+template <class X>
+class SStepGMResSolver : public InverseOperator<X, X>
+{
+public:
+    using domain_type = X;
+    using range_type = X;
+    using field_type = typename X::field_type;
+
+    /// \param restart  maximum size of the Krylov basis before restarting,
+    ///                 rounded down to a multiple of steps
+    /// \param steps    number of vectors added to the basis per reduction
+    SStepGMResSolver(LinearOperator<X, X>& op,
+                     Preconditioner<X, X>& prec,
+                     const GlobalDotProducts& dots,
+                     double reduction,
+                     int restart,
+                     int steps,
+                     int maxit,
+                     int verbose)
+        : op_(op)
+        , prec_(prec)
+        , dots_(dots)
+        , reduction_(reduction)
+        , steps_(std::max(steps, 1))
+        , restart_(std::max(restart / steps_, 1) * steps_)
+        , maxit_(maxit)
+        , verbose_(verbose)
+    {
+    }
+
+    virtual void apply(X& x, X& b, InverseOperatorResult& res) override
+    {
+        Timer watch;
+        res.clear();
+
+        prec_.pre(x, b);
+        op_.applyscaleadd(-1.0, x, b);
+        X& r = b;
+        double def = norm(r);
+        const double def0 = def;
+        if (verbose_ > 0) {
+            std::cout << "=== SStepGMResSolver" << std::endl;
+            printOutput(0, def, def0);
+        }
+
+        const int m = restart_;
+        std::vector<X> basis(m + 1, r);
+        std::vector<X> powers(steps_, r);
+        X z(x);
+        // Columns of the Hessenberg matrix, and the same columns after
+        // the Givens rotations.
+        std::vector<std::vector<double>> hessenberg(m, std::vector<double>(m + 1, 0.0));
+        std::vector<std::vector<double>> rotated(m, std::vector<double>(m + 1, 0.0));
+        std::vector<double> cs(m), sn(m), g(m + 1);
+        double sigma = 1.0;
+
+        int it = 0;
+        bool converged = !std::isfinite(def) || def < 1e-30;
+        while (!converged && it < maxit_) {
+            basis[0] = r;
+            basis[0] *= 1.0 / def;
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = def;
+
+            // Number of Hessenberg columns, the last basis vector is basis[j].
+            int j = 0;
+            while (j < m && it < maxit_ && !converged) {
+                const int k = std::min(steps_, std::min(m - j, maxit_ - it));
+                const X* prev = &basis[j];
+                for (int i = 0; i < k; ++i) {
+                    applyPrec(z, *prev);
+                    op_.apply(z, powers[i]);
+                    powers[i] *= 1.0 / sigma;
+                    prev = &powers[i];
+                }
+
+                const int nq = j + 1;
+                Block block(nq, k);
+                orthogonalize(basis, powers, block, false);
+                int kk = block.factorize(1e-4);
+                if (kk < k) {
+                    orthogonalize(basis, powers, block, true);
+                    kk = block.factorize(1e-24);
+                }
+                if (kk == 0) {
+                    break;
+                }
+
+                for (int i = 0; i < kk; ++i) {
+                    X& q = basis[nq + i];
+                    q = powers[i];
+                    for (int l = 0; l < i; ++l) {
+                        q.axpy(-block.r(l, i), basis[nq + l]);
+                    }
+                    q *= 1.0 / block.r(i, i);
+                }
+                hessenbergColumns(block, kk, j, sigma, hessenberg);
+
+                for (int i = 0; i < kk && !converged; ++i) {
+                    const int col = j + i;
+                    rotated[col] = hessenberg[col];
+                    applyGivens(rotated[col], cs, sn, g, col);
+                    ++it;
+                    def = std::abs(g[col + 1]);
+                    if (verbose_ > 1) {
+                        printOutput(it, def, def0);
+                    }
+                    converged = !std::isfinite(def) || def < def0 * reduction_;
+                    if (converged) {
+                        kk = i + 1;
+                    }
+                }
+                j += kk;
+                if (kk < k) {
+                    break;
+                }
+                const double growth = std::sqrt(block.gram(0, 0));
+                if (std::isfinite(growth) && growth > 0.0) {
+                    sigma *= growth;
+                }
+            }
+
+            if (j == 0) {
+                break;
+            }
+
+            // x += M^-1 V y with the least squares solution y
+            std::vector<double> y(g.begin(), g.begin() + j);
+            for (int row = j - 1; row >= 0; --row) {
+                for (int col = row + 1; col < j; ++col) {
+                    y[row] -= rotated[col][row] * y[col];
+                }
+                y[row] /= rotated[row][row];
+            }
+            X& u = powers[0];
+            u = 0.0;
+            for (int col = 0; col < j; ++col) {
+                u.axpy(y[col], basis[col]);
+            }
+            applyPrec(z, u);
+            x += z;
+
+            // Restart with the true residual.
+            op_.applyscaleadd(-1.0, z, r);
+            def = norm(r);
+            if (verbose_ > 1) {
+                printOutput(it, def, def0);
+            }
+            converged = !std::isfinite(def) || def < def0 * reduction_ || def < 1e-30;
+        }
+
+        prec_.post(x);
+
+        res.iterations = it;
+        res.reduction = def0 > 0.0 ? def / def0 : 0.0;
+        res.converged = std::isfinite(def) && (def < def0 * reduction_ || def < 1e-30);
+        res.conv_rate = std::pow(res.reduction, 1.0 / std::max(it, 1));
+        res.elapsed = watch.elapsed();
+        if (verbose_ > 0) {
+            std::cout << "=== rate=" << res.conv_rate << ", T=" << res.elapsed
+                      << ", TIT=" << res.elapsed / std::max(it, 1)
+                      << ", IT=" << it << std::endl;
+        }
+    }
+
+    virtual void apply(X& x, X& b, double reduction, InverseOperatorResult& res) override
+    {
+        const double savedReduction = reduction_;
+        reduction_ = reduction;
+        apply(x, b, res);
+        reduction_ = savedReduction;
+    }
+
+    virtual SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+
+private:
+    /// The projection of a block W of new vectors onto the basis Q and
+    /// the Cholesky factor of the remainder,
+    /// W = Q C + Qnew R.
+    class Block
+    {
+    public:
+        Block(const int nq, const int k)
+            : nq_(nq), k_(k), c_(nq * k, 0.0), gram_(k * k), r_(k * k, 0.0)
+        {
+        }
+
+        double& c(const int l, const int i) { return c_[l * k_ + i]; }
+        double c(const int l, const int i) const { return c_[l * k_ + i]; }
+        double& gram(const int i, const int l) { return gram_[i * k_ + l]; }
+        double gram(const int i, const int l) const { return gram_[i * k_ + l]; }
+        double r(const int l, const int i) const { return r_[l * k_ + i]; }
+
+        /// Cholesky factorization of the Gram matrix of W - Q C. Returns
+        /// the number of leading columns whose part outside of the
+        /// basis is larger than sqrt(tolerance) times their norm.
+        int factorize(const double tolerance)
+        {
+            std::fill(r_.begin(), r_.end(), 0.0);
+            for (int i = 0; i < k_; ++i) {
+                for (int l = 0; l <= i; ++l) {
+                    double value = projected_[l * k_ + i];
+                    for (int m = 0; m < l; ++m) {
+                        value -= r_[m * k_ + l] * r_[m * k_ + i];
+                    }
+                    if (l < i) {
+                        r_[l * k_ + i] = value / r_[l * k_ + l];
+                    } else if (value > tolerance * norms_[i] && std::isfinite(value)) {
+                        r_[i * k_ + i] = std::sqrt(value);
+                    } else {
+                        return i;
+                    }
+                }
+            }
+            return k_;
+        }
+
+        int nq_;
+        int k_;
+        std::vector<double> c_;
+        std::vector<double> gram_;
+        std::vector<double> r_;
+        // Gram matrix of W - Q C and squared norms of the columns of W.
+        std::vector<double> projected_;
+        std::vector<double> norms_;
+    };
+
+    /// Project powers onto the orthogonal complement of the basis. All
+    /// dot products are summed in one reduction. The Gram matrix of the
+    /// result follows from that of the input, G - C^T C.
+    void orthogonalize(const std::vector<X>& basis, std::vector<X>& powers, Block& block, const bool again)
+    {
+        const int nq = block.nq_;
+        const int k = block.k_;
+        std::vector<double> values(nq * k + k * k);
+        for (int l = 0; l < nq; ++l) {
+            for (int i = 0; i < k; ++i) {
+                values[l * k + i] = dots_.local(basis[l], powers[i]);
+            }
+        }
+        for (int i = 0; i < k; ++i) {
+            for (int l = i; l < k; ++l) {
+                values[nq * k + i * k + l] = dots_.local(powers[i], powers[l]);
+            }
+        }
+        dots_.sum(values);
+
+        std::vector<double> gram(k * k);
+        for (int i = 0; i < k; ++i) {
+            for (int l = i; l < k; ++l) {
+                gram[i * k + l] = gram[l * k + i] = values[nq * k + i * k + l];
+            }
+        }
+        if (!again) {
+            block.gram_ = gram;
+            block.norms_.resize(k);
+            for (int i = 0; i < k; ++i) {
+                block.norms_[i] = gram[i * k + i];
+            }
+        }
+        block.projected_ = gram;
+        for (int i = 0; i < k; ++i) {
+            for (int l = 0; l < k; ++l) {
+                for (int q = 0; q < nq; ++q) {
+                    block.projected_[i * k + l] -= values[q * k + i] * values[q * k + l];
+                }
+            }
+        }
+        for (int i = 0; i < k; ++i) {
+            for (int l = 0; l < nq; ++l) {
+                const double c = values[l * k + i];
+                powers[i].axpy(-c, basis[l]);
+                block.c(l, i) += c;
+            }
+        }
+    }
+
+    /// Compute the Hessenberg columns j, ..., j + kk - 1.
+    ///
+    /// With K = [q_j, w_1, ..., w_kk] the relation A M^-1 K_0..kk-1 =
+    /// sigma K_1..kk and W = [Q Qnew] [C; R] give
+    /// A M^-1 [q_j Qnew_0..kk-2] Z = sigma [Q Qnew] [C; R] - Q_0..j H Z_q,
+    /// where Z holds the coefficients of q_j, w_1, ..., w_kk-1 in the
+    /// new basis vectors and Z_q those in q_0, ..., q_j-1.
+    void hessenbergColumns(const Block& block, const int kk, const int j, const double sigma,
+                           std::vector<std::vector<double>>& hessenberg) const
+    {
+        const int nq = j + 1;
+        const int rows = nq + kk;
+        std::vector<std::vector<double>> columns(kk, std::vector<double>(rows, 0.0));
+        for (int i = 0; i < kk; ++i) {
+            auto& column = columns[i];
+            for (int l = 0; l < nq; ++l) {
+                column[l] = sigma * block.c(l, i);
+            }
+            for (int l = 0; l <= i; ++l) {
+                column[nq + l] = sigma * block.r(l, i);
+            }
+            if (i > 0) {
+                for (int col = 0; col < j; ++col) {
+                    const double zq = block.c(col, i - 1);
+                    for (int row = 0; row <= col + 1; ++row) {
+                        column[row] -= hessenberg[col][row] * zq;
+                    }
+                }
+            }
+        }
+
+        // Solve H_new Z = columns with the upper triangular Z.
+        for (int i = 0; i < kk; ++i) {
+            auto& column = columns[i];
+            for (int l = 0; l < i; ++l) {
+                const double zli = (l == 0) ? block.c(j, i - 1) : block.r(l - 1, i - 1);
+                for (int row = 0; row < rows; ++row) {
+                    column[row] -= columns[l][row] * zli;
+                }
+            }
+            const double zii = (i == 0) ? 1.0 : block.r(i - 1, i - 1);
+            for (auto& value : column) {
+                value /= zii;
+            }
+            // The entries below the subdiagonal vanish up to rounding.
+            auto& target = hessenberg[j + i];
+            std::fill(target.begin(), target.end(), 0.0);
+            std::copy(column.begin(), column.begin() + j + i + 2, target.begin());
+        }
+    }
+
+    static void applyGivens(std::vector<double>& h, std::vector<double>& cs, std::vector<double>& sn,
+                            std::vector<double>& g, const int col)
+    {
+        for (int i = 0; i < col; ++i) {
+            const double temp = cs[i] * h[i] + sn[i] * h[i + 1];
+            h[i + 1] = -sn[i] * h[i] + cs[i] * h[i + 1];
+            h[i] = temp;
+        }
+        const double norm = std::hypot(h[col], h[col + 1]);
+        cs[col] = norm > 0.0 ? h[col] / norm : 1.0;
+        sn[col] = norm > 0.0 ? h[col + 1] / norm : 0.0;
+        h[col] = norm;
+        h[col + 1] = 0.0;
+        g[col + 1] = -sn[col] * g[col];
+        g[col] = cs[col] * g[col];
+    }
+
+    double norm(const X& x)
+    {
+        std::vector<double> values = { dots_.local(x, x) };
+        dots_.sum(values);
+        return std::sqrt(values[0]);
+    }
+
+    void applyPrec(X& v, const X& d)
+    {
+        v = 0.0;
+        prec_.apply(v, d);
+    }
+
+    void printOutput(const int it, const double def, const double def0) const
+    {
+        std::cout << std::setw(5) << it << std::setw(16) << def
+                  << std::setw(16) << def / def0 << std::endl;
+    }
+
+    LinearOperator<X, X>& op_;
+    Preconditioner<X, X>& prec_;
+    GlobalDotProducts dots_;
+    double reduction_;
+    int steps_;
+    int restart_;
+    int maxit_;
+    int verbose_;
+};
+
+} // namespace Dune
+
+#endif // OPM_SSTEPGMRESSOLVER_HEADER_INCLUDED
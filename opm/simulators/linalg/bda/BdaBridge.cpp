@@ -35,11 +35,22 @@ typedef Dune::InverseOperatorResult InverseOperatorResult;
 namespace Opm
 {
 
-BdaBridge::BdaBridge(bool use_gpu_, int linear_solver_verbosity, int maxit, double tolerance)
-    : use_gpu(use_gpu_)
+BdaBridge::BdaBridge(bool use_gpu_, bool use_cpu_, int linear_solver_verbosity, int maxit, double tolerance)
+    : use_gpu(use_gpu_), use_cpu(use_cpu_)
 {
+    if (use_gpu && use_cpu) {
+        OpmLog::warning("Both the cusparseSolver and the cpuSolver are selected, the cusparseSolver is used");
+        use_cpu = false;
+    }
     if (use_gpu) {
+#if HAVE_CUDA
         backend.reset(new cusparseSolverBackend(linear_solver_verbosity, maxit, tolerance));
+#else
+        OPM_THROW(std::logic_error, "Error cannot use GPU solver since CUDA was not found during compilation");
+#endif
+    }
+    if (use_cpu) {
+        cpuBackend.reset(new cpuSolverBackend(linear_solver_verbosity, maxit, tolerance));
     }
 }
 
@@ -49,7 +60,7 @@ template <class BridgeMatrix>
 int checkZeroDiagonal(BridgeMatrix& mat) {
     static std::vector<typename BridgeMatrix::size_type> diag_indices;   // contains offsets of the diagonal nnzs
     int numZeros = 0;
-    const int dim = 3;                    // might be replaced with mat[0][0].N() or BridgeMatrix::block_type::size()
+    const int dim = BridgeMatrix::block_type::rows;
     const double zero_replace = 1e-15;
     if (diag_indices.size() == 0) {
         int N = mat.N();
@@ -116,7 +127,7 @@ template <class BridgeMatrix, class BridgeVector>
 void BdaBridge::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_UNUSED, WellContributions& wellContribs OPM_UNUSED, InverseOperatorResult &res OPM_UNUSED)
 {
 
-    if (use_gpu) {
+    if (use_gpu || use_cpu) {
         BdaResult result;
         result.converged = false;
         static std::vector<int> h_rows;
@@ -125,11 +136,16 @@ void BdaBridge::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_U
         const int N = mat->N()*dim;
         const int nnz = (h_rows.empty()) ? mat->nonzeroes()*dim*dim : h_rows.back()*dim*dim;
 
-        if (dim != 3) {
+        if (use_gpu && dim != 3) {
             OpmLog::warning("cusparseSolver only accepts blocksize = 3 at this time, will use Dune for the remainder of the program");
             use_gpu = false;
             return;
         }
+        if (use_cpu && !cpuSolverBackend::supportsBlockSize(dim)) {
+            OpmLog::warning("cpuSolver only accepts blocksize = 3 or 4 at this time, will use Dune for the remainder of the program");
+            use_cpu = false;
+            return;
+        }
 
         if (h_rows.capacity() == 0) {
             h_rows.reserve(N+1);
@@ -159,21 +175,42 @@ void BdaBridge::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_U
         /////////////////////////
         // actually solve
 
-        typedef cusparseSolverBackend::cusparseSolverStatus cusparseSolverStatus;
-        // assume that underlying data (nonzeroes) from mat (Dune::BCRSMatrix) are contiguous, if this is not the case, cusparseSolver is expected to perform undefined behaviour
-        cusparseSolverStatus status = backend->solve_system(N, nnz, dim, static_cast<double*>(&(((*mat)[0][0][0][0]))), h_rows.data(), h_cols.data(), static_cast<double*>(&(b[0][0])), wellContribs, result);
-        switch(status) {
-        case cusparseSolverStatus::CUSPARSE_SOLVER_SUCCESS:
-            //OpmLog::info("cusparseSolver converged");
-            break;
-        case cusparseSolverStatus::CUSPARSE_SOLVER_ANALYSIS_FAILED:
-            OpmLog::warning("cusparseSolver could not analyse level information of matrix, perhaps there is still a 0.0 on the diagonal of a block on the diagonal");
-            break;
-        case cusparseSolverStatus::CUSPARSE_SOLVER_CREATE_PRECONDITIONER_FAILED:
-            OpmLog::warning("cusparseSolver could not create preconditioner, perhaps there is still a 0.0 on the diagonal of a block on the diagonal");
-            break;
-        default:
-            OpmLog::warning("cusparseSolver returned unknown status code");
+        // assume that underlying data (nonzeroes) from mat (Dune::BCRSMatrix) are contiguous, if this is not the case, the backends are expected to perform undefined behaviour
+        double *vals = static_cast<double*>(&(((*mat)[0][0][0][0])));
+        double *rhs = static_cast<double*>(&(b[0][0]));
+        if (use_gpu) {
+#if HAVE_CUDA
+            typedef cusparseSolverBackend::cusparseSolverStatus cusparseSolverStatus;
+            cusparseSolverStatus status = backend->solve_system(N, nnz, dim, vals, h_rows.data(), h_cols.data(), rhs, wellContribs, result);
+            switch(status) {
+            case cusparseSolverStatus::CUSPARSE_SOLVER_SUCCESS:
+                //OpmLog::info("cusparseSolver converged");
+                break;
+            case cusparseSolverStatus::CUSPARSE_SOLVER_ANALYSIS_FAILED:
+                OpmLog::warning("cusparseSolver could not analyse level information of matrix, perhaps there is still a 0.0 on the diagonal of a block on the diagonal");
+                break;
+            case cusparseSolverStatus::CUSPARSE_SOLVER_CREATE_PRECONDITIONER_FAILED:
+                OpmLog::warning("cusparseSolver could not create preconditioner, perhaps there is still a 0.0 on the diagonal of a block on the diagonal");
+                break;
+            default:
+                OpmLog::warning("cusparseSolver returned unknown status code");
+            }
+#endif
+        } else {
+            typedef cpuSolverBackend::cpuSolverStatus cpuSolverStatus;
+            cpuSolverStatus status = cpuBackend->solve_system(N, nnz, dim, vals, h_rows.data(), h_cols.data(), rhs, wellContribs, result);
+            switch(status) {
+            case cpuSolverStatus::CPU_SOLVER_SUCCESS:
+                break;
+            case cpuSolverStatus::CPU_SOLVER_ANALYSIS_FAILED:
+                OpmLog::warning("cpuSolver could not analyse the matrix, a block on the diagonal is missing");
+                break;
+            case cpuSolverStatus::CPU_SOLVER_CREATE_PRECONDITIONER_FAILED:
+                OpmLog::warning("cpuSolver could not create preconditioner, a block on the diagonal is singular");
+                break;
+            default:
+                OpmLog::warning("cpuSolver returned unknown status code");
+            }
         }
 
         res.iterations = result.iterations;
@@ -190,7 +227,11 @@ void BdaBridge::solve_system(BridgeMatrix *mat OPM_UNUSED, BridgeVector &b OPM_U
 template <class BridgeVector>
 void BdaBridge::get_result(BridgeVector &x OPM_UNUSED) {
     if (use_gpu) {
+#if HAVE_CUDA
         backend->post_process(static_cast<double*>(&(x[0][0])));
+#endif
+    } else if (use_cpu) {
+        cpuBackend->post_process(static_cast<double*>(&(x[0][0])));
     }
 }
 
@@ -22,10 +22,6 @@
 
 #include <config.h>
 
-#if ! HAVE_CUDA
-  #error "This file should only be included if CUDA is found"
-#endif
-
 #include "dune/istl/solver.hh" // for struct InverseOperatorResult
 
 #include "dune/istl/bcrsmatrix.hh"
@@ -33,28 +29,36 @@
 
 #include <opm/simulators/linalg/bda/WellContributions.hpp>
 
+#if HAVE_CUDA
 #include <opm/simulators/linalg/bda/cusparseSolverBackend.hpp>
+#endif
+#include <opm/simulators/linalg/bda/cpuSolverBackend.hpp>
 
 namespace Opm
 {
 
 typedef Dune::InverseOperatorResult InverseOperatorResult;
 
-/// BdaBridge acts as interface between opm-simulators with the cusparseSolver
-/// if CUDA was not found during CMake, function bodies of this class are empty
+/// BdaBridge acts as interface between opm-simulators with the cusparseSolver and the cpuSolver
+/// if CUDA was not found during CMake, only the cpuSolver is available
 class BdaBridge
 {
 private:
+#if HAVE_CUDA
     std::unique_ptr<cusparseSolverBackend> backend;
+#endif
+    std::unique_ptr<cpuSolverBackend> cpuBackend;
     bool use_gpu;
+    bool use_cpu;
 
 public:
     /// Construct a BdaBridge
     /// \param[in] use_gpu                    true iff the cusparseSolver is used, is passed via command-line: '--use-gpu=[true|false]'
-    /// \param[in] linear_solver_verbosity    verbosity of cusparseSolver
-    /// \param[in] maxit                      maximum number of iterations for cusparseSolver
-    /// \param[in] tolerance                  required relative tolerance for cusparseSolver
-    BdaBridge(bool use_gpu, int linear_solver_verbosity, int maxit, double tolerance);
+    /// \param[in] use_cpu                    true iff the cpuSolver is used, is passed via command-line: '--use-bda-cpu=[true|false]'
+    /// \param[in] linear_solver_verbosity    verbosity of the solver
+    /// \param[in] maxit                      maximum number of iterations for the solver
+    /// \param[in] tolerance                  required relative tolerance for the solver
+    BdaBridge(bool use_gpu, bool use_cpu, int linear_solver_verbosity, int maxit, double tolerance);
 
 
     /// Solve linear system, A*x = b
@@ -71,12 +75,16 @@ public:
     template <class BridgeVector>
     void get_result(BridgeVector &x);
 
-    /// Return whether the BdaBridge will use the GPU or not
     /// return whether the BdaBridge will use the GPU or not
     bool getUseGpu(){
         return use_gpu;
     }
 
+    /// return whether the BdaBridge will use the cpuSolver or not
+    bool getUseCpu(){
+        return use_cpu;
+    }
+
 }; // end class BdaBridge
 
 }
@@ -21,6 +21,8 @@
 #include <cstdlib>
 #include <config.h> // CMake
 
+#include <opm/common/ErrorMacros.hpp>
+
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
 #endif // HAVE_UMFPACK
@@ -57,14 +59,20 @@ namespace Opm
             z1.resize(Mb * dim_wells);
             z2.resize(Mb * dim_wells);
 
+#if HAVE_UMFPACK
             umfpack_di_symbolic(M, M, Dcols.data(), Drows.data(), Dvals.data(), &UMFPACK_Symbolic, nullptr, nullptr);
             umfpack_di_numeric(Dcols.data(), Drows.data(), Dvals.data(), UMFPACK_Symbolic, &UMFPACK_Numeric, nullptr, nullptr);
+#else
+            OPM_THROW(std::runtime_error, "MultisegmentWellContribution requires UMFPACK to solve with matrix D");
+#endif // HAVE_UMFPACK
         }
 
         MultisegmentWellContribution::~MultisegmentWellContribution()
         {
+#if HAVE_UMFPACK
             umfpack_di_free_symbolic(&UMFPACK_Symbolic);
             umfpack_di_free_numeric(&UMFPACK_Numeric);
+#endif // HAVE_UMFPACK
         }
 
 
@@ -94,7 +102,9 @@ namespace Opm
 
             // z2 = D^-1 * (B * x)
             // umfpack
+#if HAVE_UMFPACK
             umfpack_di_solve(UMFPACK_A, Dcols.data(), Drows.data(), Dvals.data(), z2.data(), z1.data(), UMFPACK_Numeric, nullptr, nullptr);
+#endif // HAVE_UMFPACK
 
             // y -= (C^T * z2)
             // y -= (C^T * (D^-1 * (B * x)))
@@ -113,10 +123,12 @@ namespace Opm
             }
         }
 
+#if HAVE_CUDA
         void MultisegmentWellContribution::setCudaStream(cudaStream_t stream_)
         {
             stream = stream_;
         }
+#endif
 
 
 } //namespace Opm
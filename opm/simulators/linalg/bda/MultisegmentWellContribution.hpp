@@ -24,7 +24,9 @@
 
 #include <vector>
 
+#if HAVE_CUDA
 #include <cuda_runtime.h>
+#endif
 
 namespace Opm
 {
@@ -47,7 +49,9 @@ namespace Opm
         unsigned int M;                          // number of rows, M == dim_wells*Mb
         unsigned int Mb;                         // number of blockrows in C, D and B
 
+#if HAVE_CUDA
         cudaStream_t stream; // not actually used yet, will be when MultisegmentWellContribution are applied on GPU
+#endif
 
         // C and B are stored in BCRS format, D is stored in CSC format (Dune::UMFPack)
         // Sparsity pattern for C is not stored, since it is the same as B
@@ -67,9 +71,11 @@ namespace Opm
 
     public:
 
+#if HAVE_CUDA
         /// Set a cudaStream to be used
         /// \param[in] stream           the cudaStream that is used
         void setCudaStream(cudaStream_t stream);
+#endif
 
         /// Create a new MultisegmentWellContribution
         /// Matrices C and B are passed in Blocked CSR, matrix D in CSC
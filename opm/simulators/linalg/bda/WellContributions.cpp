@@ -0,0 +1,207 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h> // CMake
+#include <algorithm>
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+
+namespace Opm
+{
+
+    WellContributions::WellContributions(bool use_gpu_)
+        : use_gpu(use_gpu_)
+    {
+#if ! HAVE_CUDA
+        if (use_gpu) {
+            OPM_THROW(std::logic_error, "Error cannot store WellContributions on GPU since CUDA was not found during compilation");
+        }
+#endif
+    }
+
+    WellContributions::~WellContributions()
+    {
+#if HAVE_CUDA
+        if (use_gpu) {
+            free_gpu();
+        }
+#endif
+
+        // delete MultisegmentWellContributions
+        for (auto ms : multisegments) {
+            delete ms;
+        }
+        multisegments.clear();
+
+        delete[] val_pointers;
+    }
+
+    void WellContributions::alloc()
+    {
+        if (num_std_wells > 0) {
+            val_pointers = new unsigned int[num_std_wells + 1];
+#if HAVE_CUDA
+            if (use_gpu) {
+                alloc_gpu();
+            }
+#endif
+            if (!use_gpu) {
+                h_Cnnzs.resize(num_blocks * dim * dim_wells);
+                h_Dnnzs.resize(num_std_wells * dim_wells * dim_wells);
+                h_Bnnzs.resize(num_blocks * dim * dim_wells);
+                h_Ccols.resize(num_blocks);
+                h_Bcols.resize(num_blocks);
+                h_z2.resize(num_std_wells * dim_wells);
+            }
+            allocated = true;
+        }
+    }
+
+
+    // Apply the WellContributions on the host, similar to StandardWell::apply()
+    // y -= (C^T *(D^-1*(   B*x)))
+    void WellContributions::apply_cpu(double *x, double *y)
+    {
+        // apply MultisegmentWells
+        for (MultisegmentWellContribution *well : multisegments) {
+            well->apply(x, y);
+        }
+
+        if (num_std_wells == 0) {
+            return;
+        }
+
+        // z2 = D^-1 * B * x, every well only uses its own blocks
+        const int nw = num_std_wells;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (int w = 0; w < nw; ++w) {
+            std::vector<double> z1(dim_wells, 0.0);
+            for (unsigned int b = val_pointers[w]; b < val_pointers[w + 1]; ++b) {
+                const double *block = h_Bnnzs.data() + b * dim * dim_wells;
+                const double *xb = x + h_Bcols[b] * dim;
+                for (unsigned int r = 0; r < dim_wells; ++r) {
+                    for (unsigned int c = 0; c < dim; ++c) {
+                        z1[r] += block[r * dim + c] * xb[c];
+                    }
+                }
+            }
+            const double *invD = h_Dnnzs.data() + w * dim_wells * dim_wells;
+            double *z2 = h_z2.data() + w * dim_wells;
+            for (unsigned int r = 0; r < dim_wells; ++r) {
+                double temp = 0.0;
+                for (unsigned int c = 0; c < dim_wells; ++c) {
+                    temp += invD[r * dim_wells + c] * z1[c];
+                }
+                z2[r] = temp;
+            }
+        }
+
+        // y -= C^T * z2, done sequentially since wells might share cells
+        for (int w = 0; w < nw; ++w) {
+            const double *z2 = h_z2.data() + w * dim_wells;
+            for (unsigned int b = val_pointers[w]; b < val_pointers[w + 1]; ++b) {
+                const double *block = h_Cnnzs.data() + b * dim * dim_wells;
+                double *yb = y + h_Ccols[b] * dim;
+                for (unsigned int c = 0; c < dim; ++c) {
+                    double temp = 0.0;
+                    for (unsigned int r = 0; r < dim_wells; ++r) {
+                        temp += block[r * dim + c] * z2[r];
+                    }
+                    yb[c] -= temp;
+                }
+            }
+        }
+    }
+
+
+    void WellContributions::addMatrix(MatrixType type, int *colIndices, double *values, unsigned int val_size)
+    {
+        if (!allocated) {
+            OPM_THROW(std::logic_error,"Error cannot add wellcontribution before allocating memory in WellContributions");
+        }
+
+        if (MatrixType::B == type) {
+            val_pointers[num_std_wells_so_far] = num_blocks_so_far;
+            if (num_std_wells_so_far == num_std_wells - 1) {
+                val_pointers[num_std_wells] = num_blocks;
+            }
+        }
+
+#if HAVE_CUDA
+        if (use_gpu) {
+            addMatrix_gpu(type, colIndices, values, val_size);
+        }
+#endif
+
+        if (!use_gpu) {
+            switch (type) {
+            case MatrixType::C:
+                std::copy(values, values + val_size * dim * dim_wells, h_Cnnzs.begin() + num_blocks_so_far * dim * dim_wells);
+                std::copy(colIndices, colIndices + val_size, h_Ccols.begin() + num_blocks_so_far);
+                break;
+            case MatrixType::D:
+                std::copy(values, values + dim_wells * dim_wells, h_Dnnzs.begin() + num_std_wells_so_far * dim_wells * dim_wells);
+                break;
+            case MatrixType::B:
+                std::copy(values, values + val_size * dim * dim_wells, h_Bnnzs.begin() + num_blocks_so_far * dim * dim_wells);
+                std::copy(colIndices, colIndices + val_size, h_Bcols.begin() + num_blocks_so_far);
+                break;
+            default:
+                OPM_THROW(std::logic_error,"Error unsupported matrix ID for WellContributions::addMatrix()");
+            }
+        }
+
+        if (MatrixType::B == type) {
+            num_blocks_so_far += val_size;
+            num_std_wells_so_far++;
+        }
+    }
+
+    void WellContributions::setBlockSize(unsigned int dim_, unsigned int dim_wells_)
+    {
+        dim = dim_;
+        dim_wells = dim_wells_;
+    }
+
+    void WellContributions::addNumBlocks(unsigned int nnz)
+    {
+        if (allocated) {
+            OPM_THROW(std::logic_error,"Error cannot add more sizes after allocated in WellContributions");
+        }
+        num_blocks += nnz;
+        num_std_wells++;
+    }
+
+    void WellContributions::addMultisegmentWellContribution(unsigned int dim, unsigned int dim_wells,
+        unsigned int Nb, unsigned int Mb,
+        unsigned int BnumBlocks, std::vector<double> &Bvalues, std::vector<unsigned int> &BcolIndices, std::vector<unsigned int> &BrowPointers,
+        unsigned int DnumBlocks, double *Dvalues, int *DcolPointers, int *DrowIndices,
+        std::vector<double> &Cvalues)
+    {
+        this->N = Nb * dim;
+        MultisegmentWellContribution *well = new MultisegmentWellContribution(dim, dim_wells, Nb, Mb, BnumBlocks, Bvalues, BcolIndices, BrowPointers, DnumBlocks, Dvalues, DcolPointers, DrowIndices, Cvalues);
+        multisegments.emplace_back(well);
+        ++num_ms_wells;
+    }
+
+} //namespace Opm
+
@@ -127,22 +127,18 @@ namespace Opm
 
     }
 
-    void WellContributions::alloc()
+    void WellContributions::alloc_gpu()
     {
-        if (num_std_wells > 0) {
-            cudaMalloc((void**)&d_Cnnzs, sizeof(double) * num_blocks * dim * dim_wells);
-            cudaMalloc((void**)&d_Dnnzs, sizeof(double) * num_std_wells * dim_wells * dim_wells);
-            cudaMalloc((void**)&d_Bnnzs, sizeof(double) * num_blocks * dim * dim_wells);
-            cudaMalloc((void**)&d_Ccols, sizeof(int) * num_blocks);
-            cudaMalloc((void**)&d_Bcols, sizeof(int) * num_blocks);
-            val_pointers = new unsigned int[num_std_wells + 1];
-            cudaMalloc((void**)&d_val_pointers, sizeof(int) * (num_std_wells + 1));
-            cudaCheckLastError("apply_gpu malloc failed");
-            allocated = true;
-        }
+        cudaMalloc((void**)&d_Cnnzs, sizeof(double) * num_blocks * dim * dim_wells);
+        cudaMalloc((void**)&d_Dnnzs, sizeof(double) * num_std_wells * dim_wells * dim_wells);
+        cudaMalloc((void**)&d_Bnnzs, sizeof(double) * num_blocks * dim * dim_wells);
+        cudaMalloc((void**)&d_Ccols, sizeof(int) * num_blocks);
+        cudaMalloc((void**)&d_Bcols, sizeof(int) * num_blocks);
+        cudaMalloc((void**)&d_val_pointers, sizeof(int) * (num_std_wells + 1));
+        cudaCheckLastError("apply_gpu malloc failed");
     }
 
-    WellContributions::~WellContributions()
+    void WellContributions::free_gpu()
     {
         // free pinned memory for MultisegmentWellContributions
         if (h_x) {
@@ -150,20 +146,13 @@ namespace Opm
             cudaFreeHost(h_y);
         }
 
-        // delete MultisegmentWellContributions
-        for (auto ms : multisegments) {
-            delete ms;
-        }
-        multisegments.clear();
-
         // delete data for StandardWell
-        if (num_std_wells > 0) {
+        if (num_std_wells > 0 && allocated) {
             cudaFree(d_Cnnzs);
             cudaFree(d_Dnnzs);
             cudaFree(d_Bnnzs);
             cudaFree(d_Ccols);
             cudaFree(d_Bcols);
-            delete[] val_pointers;
             cudaFree(d_val_pointers);
         }
     }
@@ -209,12 +198,8 @@ namespace Opm
     }
 
 
-    void WellContributions::addMatrix(MatrixType type, int *colIndices, double *values, unsigned int val_size)
+    void WellContributions::addMatrix_gpu(MatrixType type, int *colIndices, double *values, unsigned int val_size)
     {
-        if (!allocated) {
-            OPM_THROW(std::logic_error,"Error cannot add wellcontribution before allocating memory in WellContributions");
-        }
-
         switch (type) {
         case MatrixType::C:
             cudaMemcpy(d_Cnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells, cudaMemcpyHostToDevice);
@@ -226,20 +211,12 @@ namespace Opm
         case MatrixType::B:
             cudaMemcpy(d_Bnnzs + num_blocks_so_far * dim * dim_wells, values, sizeof(double) * val_size * dim * dim_wells, cudaMemcpyHostToDevice);
             cudaMemcpy(d_Bcols + num_blocks_so_far, colIndices, sizeof(int) * val_size, cudaMemcpyHostToDevice);
-            val_pointers[num_std_wells_so_far] = num_blocks_so_far;
-            if(num_std_wells_so_far == num_std_wells - 1){
-                val_pointers[num_std_wells] = num_blocks;
-            }
             cudaMemcpy(d_val_pointers, val_pointers, sizeof(int) * (num_std_wells+1), cudaMemcpyHostToDevice);
             break;
         default:
             OPM_THROW(std::logic_error,"Error unsupported matrix ID for WellContributions::addMatrix()");
         }
         cudaCheckLastError("WellContributions::addMatrix() failed");
-        if (MatrixType::B == type) {
-            num_blocks_so_far += val_size;
-            num_std_wells_so_far++;
-        }
     }
 
     void WellContributions::setCudaStream(cudaStream_t stream_)
@@ -250,32 +227,5 @@ namespace Opm
         }
     }
 
-    void WellContributions::setBlockSize(unsigned int dim_, unsigned int dim_wells_)
-    {
-        dim = dim_;
-        dim_wells = dim_wells_;
-    }
-
-    void WellContributions::addNumBlocks(unsigned int nnz)
-    {
-        if (allocated) {
-            OPM_THROW(std::logic_error,"Error cannot add more sizes after allocated in WellContributions");
-        }
-        num_blocks += nnz;
-        num_std_wells++;
-    }
-
-    void WellContributions::addMultisegmentWellContribution(unsigned int dim, unsigned int dim_wells,
-        unsigned int Nb, unsigned int Mb,
-        unsigned int BnumBlocks, std::vector<double> &Bvalues, std::vector<unsigned int> &BcolIndices, std::vector<unsigned int> &BrowPointers,
-        unsigned int DnumBlocks, double *Dvalues, int *DcolPointers, int *DrowIndices,
-        std::vector<double> &Cvalues)
-    {
-        this->N = Nb * dim;
-        MultisegmentWellContribution *well = new MultisegmentWellContribution(dim, dim_wells, Nb, Mb, BnumBlocks, Bvalues, BcolIndices, BrowPointers, DnumBlocks, Dvalues, DcolPointers, DrowIndices, Cvalues);
-        multisegments.emplace_back(well);
-        ++num_ms_wells;
-    }
-
 } //namespace Opm
 
@@ -22,20 +22,18 @@
 
 #include <config.h>
 
-#if ! HAVE_CUDA
-  #error "This file should only be included if CUDA is found"
-#endif
-
 #include <vector>
 
 #include <opm/simulators/linalg/bda/MultisegmentWellContribution.hpp>
 
+#if HAVE_CUDA
 #include <cuda_runtime.h>
+#endif
 
 namespace Opm
 {
 
-    /// This class serves to eliminate the need to include the WellContributions into the matrix (with --matrix-add-well-contributions=true) for the cusparseSolver
+    /// This class serves to eliminate the need to include the WellContributions into the matrix (with --matrix-add-well-contributions=true) for the cusparseSolver and the cpuSolver
     /// If the --matrix-add-well-contributions commandline parameter is true, this class should not be used
     /// So far, StandardWell and MultisegmentWell are supported
     /// A single instance (or pointer) of this class is passed to the cusparseSolver.
@@ -51,9 +49,19 @@ namespace Opm
     /// - get total size of all wellcontributions that must be stored here
     /// - allocate memory
     /// - copy data of wellcontributions
+    /// The data of the StandardWells is stored on the GPU if the object is created for the cusparseSolver, otherwise on the host.
     class WellContributions
     {
 
+    public:
+
+        /// StandardWell has C, D and B matrices that need to be copied
+        enum class MatrixType {
+            C,
+            D,
+            B
+        };
+
     private:
         unsigned int num_blocks = 0;             // total number of blocks in all wells
         unsigned int dim;                        // number of columns in blocks in B and C, equal to StandardWell::numEq
@@ -65,7 +73,18 @@ namespace Opm
         unsigned int *val_pointers = nullptr;    // val_pointers[wellID] == index of first block for this well in Ccols and Bcols
         unsigned int N;                          // number of rows (not blockrows) in vectors x and y
         bool allocated = false;
+        bool use_gpu;                            // true iff the data of the StandardWells is stored on the GPU
         std::vector<MultisegmentWellContribution*> multisegments;
+
+        // data for StandardWells on host, only used if use_gpu is false
+        std::vector<double> h_Cnnzs;
+        std::vector<double> h_Dnnzs;
+        std::vector<double> h_Bnnzs;
+        std::vector<int> h_Ccols;
+        std::vector<int> h_Bcols;
+        std::vector<double> h_z2;                // D^-1 * B * x for every StandardWell
+
+#if HAVE_CUDA
         cudaStream_t stream;
 
         // data for StandardWells, could remain nullptrs if not used
@@ -80,31 +99,43 @@ namespace Opm
 
         double *h_x = nullptr, *h_y = nullptr;  // CUDA pinned memory for GPU memcpy
 
+        /// Allocate memory for the StandardWells on GPU
+        void alloc_gpu();
 
-    public:
+        /// Free the memory on GPU
+        void free_gpu();
+
+        /// Copy a matrix of a StandardWell to the GPU, see addMatrix()
+        void addMatrix_gpu(MatrixType type, int *colIndices, double *values, unsigned int val_size);
+#endif
 
-        /// StandardWell has C, D and B matrices that need to be copied
-        enum class MatrixType {
-            C,
-            D,
-            B
-        };
 
+    public:
+
+#if HAVE_CUDA
         /// Set a cudaStream to be used
         /// \param[in] stream           the cudaStream that is used to launch the kernel in
         void setCudaStream(cudaStream_t stream);
 
-        /// Create a new WellContributions, implementation is empty
-        WellContributions(){};
-
-        /// Destroy a WellContributions, and free memory
-        ~WellContributions();
-
         /// Apply all Wells in this object
         /// performs y -= (C^T * (D^-1 * (B*x))) for all Wells
         /// \param[in] d_x        vector x, must be on GPU
         /// \param[inout] d_y     vector y, must be on GPU
         void apply(double *d_x, double *d_y);
+#endif
+
+        /// Create a new WellContributions
+        /// \param[in] use_gpu    true iff the data is used by the cusparseSolver and must be stored on the GPU
+        explicit WellContributions(bool use_gpu);
+
+        /// Destroy a WellContributions, and free memory
+        ~WellContributions();
+
+        /// Apply all Wells in this object on the host
+        /// performs y -= (C^T * (D^-1 * (B*x))) for all Wells
+        /// \param[in] x          vector x, must be on CPU
+        /// \param[inout] y       vector y, must be on CPU
+        void apply_cpu(double *x, double *y);
 
         /// Allocate memory for the StandardWells
         void alloc();
@@ -0,0 +1,556 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include <dune/common/timer.hh>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+
+#include <opm/simulators/linalg/bda/cpuSolverBackend.hpp>
+#include <opm/simulators/linalg/bda/BdaResult.hpp>
+
+namespace Opm
+{
+
+namespace
+{
+    // The block kernels have a fixed size, such that the compiler can unroll
+    // and vectorize the loops. Blocks are stored row-wise.
+
+    // y = A * x
+    template <unsigned int bs>
+    inline void blockMultVec(const double *A, const double *x, double *y)
+    {
+        for (unsigned int i = 0; i < bs; ++i) {
+            double temp = 0.0;
+            for (unsigned int j = 0; j < bs; ++j) {
+                temp += A[i * bs + j] * x[j];
+            }
+            y[i] = temp;
+        }
+    }
+
+    // y -= A * x
+    template <unsigned int bs>
+    inline void blockMultVecSub(const double *A, const double *x, double *y)
+    {
+        for (unsigned int i = 0; i < bs; ++i) {
+            double temp = 0.0;
+            for (unsigned int j = 0; j < bs; ++j) {
+                temp += A[i * bs + j] * x[j];
+            }
+            y[i] -= temp;
+        }
+    }
+
+    // C = A * B
+    template <unsigned int bs>
+    inline void blockMult(const double *A, const double *B, double *C)
+    {
+        for (unsigned int i = 0; i < bs; ++i) {
+            for (unsigned int j = 0; j < bs; ++j) {
+                double temp = 0.0;
+                for (unsigned int k = 0; k < bs; ++k) {
+                    temp += A[i * bs + k] * B[k * bs + j];
+                }
+                C[i * bs + j] = temp;
+            }
+        }
+    }
+
+    // C -= A * B
+    template <unsigned int bs>
+    inline void blockMultSub(const double *A, const double *B, double *C)
+    {
+        for (unsigned int i = 0; i < bs; ++i) {
+            for (unsigned int j = 0; j < bs; ++j) {
+                double temp = 0.0;
+                for (unsigned int k = 0; k < bs; ++k) {
+                    temp += A[i * bs + k] * B[k * bs + j];
+                }
+                C[i * bs + j] -= temp;
+            }
+        }
+    }
+
+    // invert A in place, using Gauss-Jordan elimination with partial pivoting
+    // return false iff A is singular
+    template <unsigned int bs>
+    bool blockInvert(double *A)
+    {
+        double M[bs][2 * bs];
+        for (unsigned int i = 0; i < bs; ++i) {
+            for (unsigned int j = 0; j < bs; ++j) {
+                M[i][j] = A[i * bs + j];
+                M[i][bs + j] = (i == j) ? 1.0 : 0.0;
+            }
+        }
+        for (unsigned int c = 0; c < bs; ++c) {
+            unsigned int pivot = c;
+            for (unsigned int i = c + 1; i < bs; ++i) {
+                if (std::abs(M[i][c]) > std::abs(M[pivot][c])) {
+                    pivot = i;
+                }
+            }
+            if (M[pivot][c] == 0.0) {
+                return false;
+            }
+            if (pivot != c) {
+                for (unsigned int j = 0; j < 2 * bs; ++j) {
+                    std::swap(M[c][j], M[pivot][j]);
+                }
+            }
+            const double inv = 1.0 / M[c][c];
+            for (unsigned int j = 0; j < 2 * bs; ++j) {
+                M[c][j] *= inv;
+            }
+            for (unsigned int i = 0; i < bs; ++i) {
+                if (i != c) {
+                    const double factor = M[i][c];
+                    for (unsigned int j = 0; j < 2 * bs; ++j) {
+                        M[i][j] -= factor * M[c][j];
+                    }
+                }
+            }
+        }
+        for (unsigned int i = 0; i < bs; ++i) {
+            for (unsigned int j = 0; j < bs; ++j) {
+                A[i * bs + j] = M[i][bs + j];
+            }
+        }
+        return true;
+    }
+
+    // y = A * x, A in blocked-CSR format
+    template <unsigned int bs>
+    void bsrmv(int Nb, const int *rows, const int *cols, const double *vals, const double *x, double *y)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int row = 0; row < Nb; ++row) {
+            double temp[bs] = {0.0};
+            for (int ij = rows[row]; ij < rows[row + 1]; ++ij) {
+                const double *block = vals + ij * bs * bs;
+                const double *xb = x + cols[ij] * bs;
+                for (unsigned int i = 0; i < bs; ++i) {
+                    for (unsigned int j = 0; j < bs; ++j) {
+                        temp[i] += block[i * bs + j] * xb[j];
+                    }
+                }
+            }
+            for (unsigned int i = 0; i < bs; ++i) {
+                y[row * bs + i] = temp[i];
+            }
+        }
+    }
+
+    double dot(int n, const double *a, const double *b)
+    {
+        double sum = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
+        for (int i = 0; i < n; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    double norm2(int n, const double *a)
+    {
+        return std::sqrt(dot(n, a, a));
+    }
+
+    // y += alpha * x
+    void axpy(int n, double alpha, const double *x, double *y)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < n; ++i) {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    // sort the rows by level, like a counting sort
+    void groupByLevel(const std::vector<int>& level, std::vector<int>& levelStart, std::vector<int>& levelRows, bool reverse)
+    {
+        const int n = level.size();
+        const int numLevels = n > 0 ? *std::max_element(level.begin(), level.end()) + 1 : 0;
+        levelStart.assign(numLevels + 1, 0);
+        for (int row = 0; row < n; ++row) {
+            ++levelStart[level[row] + 1];
+        }
+        for (int l = 0; l < numLevels; ++l) {
+            levelStart[l + 1] += levelStart[l];
+        }
+        levelRows.resize(n);
+        std::vector<int> next(levelStart.begin(), levelStart.end() - 1);
+        for (int k = 0; k < n; ++k) {
+            const int row = reverse ? n - 1 - k : k;
+            levelRows[next[level[row]]++] = row;
+        }
+    }
+
+} // end anonymous namespace
+
+
+    cpuSolverBackend::cpuSolverBackend(int verbosity_, int maxit_, double tolerance_) : minit(0), maxit(maxit_), tolerance(tolerance_), verbosity(verbosity_) {
+    }
+
+    bool cpuSolverBackend::supportsBlockSize(int dim) {
+        return dim == 3 || dim == 4;
+    }
+
+    template <unsigned int bs>
+    void cpuSolverBackend::cpu_pbicgstab(WellContributions& wellContribs, BdaResult& res) {
+        Dune::Timer t_total;
+        const int n = N;
+        double rho = 1.0, rhop;
+        double alpha = 0.0, beta;
+        double omega = 0.0, tmp1, tmp2;
+        double norm, norm_0;
+        float it;
+
+        const bool applyWells = wellContribs.getNumWells() > 0;
+
+        std::fill(x.begin(), x.end(), 0.0);
+        // r = b - A * x, with x == 0
+        std::copy(b.begin(), b.end(), r.begin());
+        std::copy(r.begin(), r.end(), rw.begin());
+        std::copy(r.begin(), r.end(), p.begin());
+        norm_0 = norm2(n, r.data());
+        norm = norm_0;
+
+        if (verbosity > 1) {
+            std::ostringstream out;
+            out << std::scientific << "cpuSolver initial norm: " << norm_0;
+            OpmLog::info(out.str());
+        }
+
+        for (it = 0.5; it < maxit; it+=0.5) {
+            rhop = rho;
+            rho = dot(n, rw.data(), r.data());
+
+            if (it > 1) {
+                beta = (rho/rhop) * (alpha/omega);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+                for (int i = 0; i < n; ++i) {
+                    p[i] = r[i] + beta * (p[i] - omega * v[i]);
+                }
+            }
+
+            // apply ilu0
+            apply_preconditioner<bs>(p.data(), pw.data());
+
+            // spmv
+            bsrmv<bs>(Nb, bRows, bCols, bVals, pw.data(), v.data());
+
+            // apply wellContributions
+            if (applyWells) {
+                wellContribs.apply_cpu(pw.data(), v.data());
+            }
+
+            tmp1 = dot(n, rw.data(), v.data());
+            alpha = rho / tmp1;
+            axpy(n, -alpha, v.data(), r.data());
+            axpy(n, alpha, pw.data(), x.data());
+            norm = norm2(n, r.data());
+
+            if (norm < tolerance * norm_0 && it > minit) {
+                break;
+            }
+
+            it += 0.5;
+
+            // apply ilu0
+            apply_preconditioner<bs>(r.data(), s.data());
+
+            // spmv
+            bsrmv<bs>(Nb, bRows, bCols, bVals, s.data(), t.data());
+
+            // apply wellContributions
+            if (applyWells) {
+                wellContribs.apply_cpu(s.data(), t.data());
+            }
+
+            tmp1 = dot(n, t.data(), r.data());
+            tmp2 = dot(n, t.data(), t.data());
+            omega = tmp1 / tmp2;
+            axpy(n, omega, s.data(), x.data());
+            axpy(n, -omega, t.data(), r.data());
+
+            norm = norm2(n, r.data());
+
+            if (norm < tolerance * norm_0 && it > minit) {
+                break;
+            }
+
+            if (verbosity > 1) {
+                std::ostringstream out;
+                out << "it: " << it << std::scientific << ", norm: " << norm;
+                OpmLog::info(out.str());
+            }
+        }
+
+        res.iterations = std::min(it, (float)maxit);
+        res.reduction = norm/norm_0;
+        res.conv_rate  = static_cast<double>(pow(res.reduction,1.0/it));
+        res.elapsed = t_total.stop();
+        res.converged = (it != (maxit + 0.5));
+
+        if (verbosity > 0) {
+            std::ostringstream out;
+            out << "=== converged: " << res.converged << ", conv_rate: " << res.conv_rate << ", time: " << res.elapsed << \
+                   ", time per iteration: " << res.elapsed/it << ", iterations: " << it;
+            OpmLog::info(out.str());
+        }
+    }
+
+
+    void cpuSolverBackend::initialize(int N_, int nnz_, int dim) {
+        this->N = N_;
+        this->nnz = nnz_;
+        this->block_size = dim;
+        this->nnzb = nnz/block_size/block_size;
+        Nb = (N + dim - 1) / dim;
+        std::ostringstream out;
+        out << "Initializing cpuSolver, matrix size: " << Nb << " blocks, nnz: " << nnzb << " blocks";
+        OpmLog::info(out.str());
+        out.str("");
+        out.clear();
+        out << "Minit: " << minit << ", maxit: " << maxit << std::scientific << ", tolerance: " << tolerance;
+        OpmLog::info(out.str());
+
+        for (auto vec : {&x, &b, &r, &rw, &p, &pw, &s, &t, &v}) {
+            vec->resize(N);
+        }
+        mVals.resize(nnz);
+
+        initialized = true;
+    } // end initialize()
+
+
+    bool cpuSolverBackend::analyse_matrix() {
+        Dune::Timer t;
+
+        diagIndex.resize(Nb);
+        for (int row = 0; row < Nb; ++row) {
+            const int *begin = bCols + bRows[row];
+            const int *end = bCols + bRows[row + 1];
+            const int *diag = std::lower_bound(begin, end, row);
+            if (diag == end || *diag != row) {
+                return false;
+            }
+            diagIndex[row] = diag - bCols;
+        }
+
+        // a row of the lower part depends on the rows of its lower columns, and
+        // a row of the upper part on the rows of its upper columns
+        std::vector<int> level(Nb, 0);
+        for (int row = 0; row < Nb; ++row) {
+            for (int ij = bRows[row]; ij < diagIndex[row]; ++ij) {
+                level[row] = std::max(level[row], level[bCols[ij]] + 1);
+            }
+        }
+        groupByLevel(level, lowerLevelStart, lowerLevelRows, false);
+
+        std::fill(level.begin(), level.end(), 0);
+        for (int row = Nb - 1; row >= 0; --row) {
+            for (int ij = diagIndex[row] + 1; ij < bRows[row + 1]; ++ij) {
+                level[row] = std::max(level[row], level[bCols[ij]] + 1);
+            }
+        }
+        groupByLevel(level, upperLevelStart, upperLevelRows, true);
+
+        if (verbosity > 2) {
+            std::ostringstream out;
+            out << "cpuSolver::analyse_matrix(): " << t.stop() << " s, lower levels: " << lowerLevelStart.size() - 1
+                << ", upper levels: " << upperLevelStart.size() - 1;
+            OpmLog::info(out.str());
+        }
+
+        analysis_done = true;
+
+        return true;
+    } // end analyse_matrix()
+
+
+    template <unsigned int bs>
+    bool cpuSolverBackend::create_preconditioner() {
+        Dune::Timer t;
+
+        std::copy(bVals, bVals + nnz, mVals.begin());
+
+        // the rows of one level only depend on rows of earlier levels
+        const int numLevels = lowerLevelStart.size() - 1;
+        int failed = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(max:failed)
+#endif
+        for (int level = 0; level < numLevels; ++level) {
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (int k = lowerLevelStart[level]; k < lowerLevelStart[level + 1]; ++k) {
+                const int row = lowerLevelRows[k];
+                double temp[bs * bs];
+                for (int ik = bRows[row]; ik < diagIndex[row]; ++ik) {
+                    const int col = bCols[ik];
+                    // L_ik = A_ik * D_k^-1, the diagonal blocks are already inverted
+                    double *Lik = mVals.data() + ik * bs * bs;
+                    blockMult<bs>(Lik, mVals.data() + diagIndex[col] * bs * bs, temp);
+                    std::copy(temp, temp + bs * bs, Lik);
+
+                    // A_ij -= L_ik * U_kj for all j > k that are in both rows
+                    int ij = ik + 1;
+                    int kj = diagIndex[col] + 1;
+                    while (ij < bRows[row + 1] && kj < bRows[col + 1]) {
+                        if (bCols[ij] == bCols[kj]) {
+                            blockMultSub<bs>(Lik, mVals.data() + kj * bs * bs, mVals.data() + ij * bs * bs);
+                            ++ij;
+                            ++kj;
+                        } else if (bCols[ij] < bCols[kj]) {
+                            ++ij;
+                        } else {
+                            ++kj;
+                        }
+                    }
+                }
+                if (!blockInvert<bs>(mVals.data() + diagIndex[row] * bs * bs)) {
+                    failed = 1;
+                }
+            }
+        }
+
+        if (verbosity > 2) {
+            std::ostringstream out;
+            out << "cpuSolver::create_preconditioner(): " << t.stop() << " s";
+            OpmLog::info(out.str());
+        }
+        return failed == 0;
+    } // end create_preconditioner()
+
+
+    template <unsigned int bs>
+    void cpuSolverBackend::apply_preconditioner(const double *in, double *out) {
+        const int numLowerLevels = lowerLevelStart.size() - 1;
+        const int numUpperLevels = upperLevelStart.size() - 1;
+        const double *m = mVals.data();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            // out = L^-1 * in, L has unit diagonal
+            for (int level = 0; level < numLowerLevels; ++level) {
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+                for (int k = lowerLevelStart[level]; k < lowerLevelStart[level + 1]; ++k) {
+                    const int row = lowerLevelRows[k];
+                    double temp[bs];
+                    std::copy(in + row * bs, in + (row + 1) * bs, temp);
+                    for (int ij = bRows[row]; ij < diagIndex[row]; ++ij) {
+                        blockMultVecSub<bs>(m + ij * bs * bs, out + bCols[ij] * bs, temp);
+                    }
+                    std::copy(temp, temp + bs, out + row * bs);
+                }
+            }
+
+            // out = U^-1 * out, the diagonal of U is stored inverted
+            for (int level = 0; level < numUpperLevels; ++level) {
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+                for (int k = upperLevelStart[level]; k < upperLevelStart[level + 1]; ++k) {
+                    const int row = upperLevelRows[k];
+                    double temp[bs];
+                    std::copy(out + row * bs, out + (row + 1) * bs, temp);
+                    for (int ij = diagIndex[row] + 1; ij < bRows[row + 1]; ++ij) {
+                        blockMultVecSub<bs>(m + ij * bs * bs, out + bCols[ij] * bs, temp);
+                    }
+                    blockMultVec<bs>(m + diagIndex[row] * bs * bs, temp, out + row * bs);
+                }
+            }
+        }
+    }
+
+
+    template <unsigned int bs>
+    bool cpuSolverBackend::solve_fixed_blocksize(WellContributions& wellContribs, BdaResult &res) {
+        if (!create_preconditioner<bs>()) {
+            return false;
+        }
+        cpu_pbicgstab<bs>(wellContribs, res);
+        return true;
+    }
+
+
+    // copy result to the vector of the caller
+    // caller must be sure that x is a valid array
+    void cpuSolverBackend::post_process(double *x_) {
+        std::copy(x.begin(), x.end(), x_);
+    } // end post_process()
+
+
+    typedef cpuSolverBackend::cpuSolverStatus cpuSolverStatus;
+
+    cpuSolverStatus cpuSolverBackend::solve_system(int N_, int nnz_, int dim, double *vals, int *rows, int *cols, double *b_, WellContributions& wellContribs, BdaResult &res) {
+        if (!supportsBlockSize(dim)) {
+            return cpuSolverStatus::CPU_SOLVER_UNKNOWN_ERROR;
+        }
+        if (initialized == false) {
+            initialize(N_, nnz_, dim);
+        }
+        bVals = vals;
+        bRows = rows;
+        bCols = cols;
+        std::copy(b_, b_ + N, b.begin());
+
+        if (analysis_done == false) {
+            if (!analyse_matrix()) {
+                return cpuSolverStatus::CPU_SOLVER_ANALYSIS_FAILED;
+            }
+        }
+
+        bool success = false;
+        switch (block_size) {
+        case 3:
+            success = solve_fixed_blocksize<3>(wellContribs, res);
+            break;
+        case 4:
+            success = solve_fixed_blocksize<4>(wellContribs, res);
+            break;
+        default:
+            return cpuSolverStatus::CPU_SOLVER_UNKNOWN_ERROR;
+        }
+        if (!success) {
+            return cpuSolverStatus::CPU_SOLVER_CREATE_PRECONDITIONER_FAILED;
+        }
+        return cpuSolverStatus::CPU_SOLVER_SUCCESS;
+    }
+
+}
@@ -0,0 +1,143 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CPUSOLVER_BACKEND_HEADER_INCLUDED
+#define OPM_CPUSOLVER_BACKEND_HEADER_INCLUDED
+
+#include <vector>
+
+#include <opm/simulators/linalg/bda/BdaResult.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+
+namespace Opm
+{
+
+/// This class implements a multithreaded ilu0-bicgstab solver on CPU
+/// It works directly on the blocked-CSR arrays that BdaBridge extracts from the Dune::BCRSMatrix,
+/// and uses kernels of a fixed blocksize, only blocksizes 3 and 4 are supported.
+/// The triangular solves and the ilu0-decomposition are parallelized by level scheduling.
+class cpuSolverBackend{
+
+private:
+
+    int minit;
+    int maxit;
+    double tolerance;
+
+    // b: bsr matrix, owned by the caller, only valid during solve_system()
+    // m: preconditioner, diagonal blocks are stored inverted
+    double *bVals = nullptr;
+    int *bCols = nullptr;
+    int *bRows = nullptr;
+    std::vector<double> mVals;
+    std::vector<int> diagIndex;        // index of the diagonal block of every blockrow
+    std::vector<double> x, b, r, rw, p, pw, s, t, v;
+    int N, Nb, nnz, nnzb;
+
+    // level sets of the triangular parts, rows of level l are levelRows[levelStart[l]] to levelRows[levelStart[l+1]-1]
+    std::vector<int> lowerLevelStart, lowerLevelRows;
+    std::vector<int> upperLevelStart, upperLevelRows;
+
+    int block_size;
+
+    bool initialized = false;
+    bool analysis_done = false;
+
+    // verbosity
+    // 0: print nothing during solves, only when initializing
+    // 1: print number of iterations and final norm
+    // 2: also print norm each iteration
+    // 3: also print timings of different backend functions
+
+    int verbosity = 0;
+
+    /// Solve linear system using ilu0-bicgstab
+    /// \param[in] wellContribs   contains all WellContributions, to apply them separately, instead of adding them to matrix A
+    /// \param[inout] res         summary of solver result
+    template <unsigned int bs>
+    void cpu_pbicgstab(WellContributions& wellContribs, BdaResult& res);
+
+    /// Allocate memory
+    /// \param[in] N                number of rows, divide by dim to get number of blockrows
+    /// \param[in] nnz              number of nonzeroes, divide by dim*dim to get number of blocks
+    /// \param[in] dim              size of block
+    void initialize(int N, int nnz, int dim);
+
+    /// Analyse sparsity pattern, find the diagonal blocks and the levels of the triangular parts
+    /// \return true iff every blockrow has a diagonal block
+    bool analyse_matrix();
+
+    /// Perform ilu0-decomposition
+    /// \return true iff decomposition was successful
+    template <unsigned int bs>
+    bool create_preconditioner();
+
+    /// Apply the ilu0 preconditioner, out = (LU)^-1 * in
+    template <unsigned int bs>
+    void apply_preconditioner(const double *in, double *out);
+
+    /// Create the preconditioner and solve the linear system with a fixed blocksize
+    /// \param[in] wellContribs   contains all WellContributions, to apply them separately, instead of adding them to matrix A
+    /// \param[inout] res         summary of solver result
+    /// \return                   true iff the preconditioner could be created
+    template <unsigned int bs>
+    bool solve_fixed_blocksize(WellContributions& wellContribs, BdaResult &res);
+
+public:
+
+    enum class cpuSolverStatus {
+        CPU_SOLVER_SUCCESS,
+        CPU_SOLVER_ANALYSIS_FAILED,
+        CPU_SOLVER_CREATE_PRECONDITIONER_FAILED,
+        CPU_SOLVER_UNKNOWN_ERROR
+    };
+
+    /// Construct a cpuSolver
+    /// \param[in] linear_solver_verbosity    verbosity of cpuSolver
+    /// \param[in] maxit                      maximum number of iterations for cpuSolver
+    /// \param[in] tolerance                  required relative tolerance for cpuSolver
+    cpuSolverBackend(int linear_solver_verbosity, int maxit, double tolerance);
+
+    /// Return true iff the blocksize is supported by the cpuSolver
+    /// \param[in] dim            size of block
+    static bool supportsBlockSize(int dim);
+
+    /// Solve linear system, A*x = b, matrix A must be in blocked-CSR format
+    /// The sparsity pattern of A must be the same for every call
+    /// \param[in] N              number of rows, divide by dim to get number of blockrows
+    /// \param[in] nnz            number of nonzeroes, divide by dim*dim to get number of blocks
+    /// \param[in] dim            size of block
+    /// \param[in] vals           array of nonzeroes, each block is stored row-wise and contiguous, contains nnz values
+    /// \param[in] rows           array of rowPointers, contains N/dim+1 values
+    /// \param[in] cols           array of columnIndices, contains nnz values
+    /// \param[in] b              input vector, contains N values
+    /// \param[in] wellContribs   contains all WellContributions, to apply them separately, instead of adding them to matrix A
+    /// \param[inout] res         summary of solver result
+    /// \return                   status code
+    cpuSolverStatus solve_system(int N, int nnz, int dim, double *vals, int *rows, int *cols, double *b, WellContributions& wellContribs, BdaResult &res);
+
+    /// Post processing after linear solve, now only copies resulting x vector back
+    /// \param[inout] x        resulting x vector, caller must guarantee that x points to a valid array
+    void post_process(double *x);
+
+}; // end class cpuSolverBackend
+
+}
+
+#endif
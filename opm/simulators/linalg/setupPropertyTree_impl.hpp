@@ -81,6 +81,8 @@ setupPropertyTree(const FlowLinearSolverParameters& p)
             }
             prm.put("preconditioner.finesmoother.type", "ParOverILU0");
             prm.put("preconditioner.finesmoother.relaxation", 1.0);
+            prm.put("preconditioner.finesmoother.level_scheduling", p.ilu_level_scheduling_);
+            prm.put("preconditioner.finesmoother.single_precision", p.preconditioner_single_precision_);
             prm.put("preconditioner.pressure_var_index",1);
             prm.put("preconditioner.verbosity",0);
             prm.put("preconditioner.coarsesolver.maxiter",1);
@@ -99,6 +101,7 @@ setupPropertyTree(const FlowLinearSolverParameters& p)
             prm.put("preconditioner.coarsesolver.preconditioner.post_smooth",1);
             prm.put("preconditioner.coarsesolver.preconditioner.beta",1e-5);
             prm.put("preconditioner.coarsesolver.preconditioner.smoother","ILU0");
+            prm.put("preconditioner.coarsesolver.preconditioner.single_precision", p.preconditioner_single_precision_);
             prm.put("preconditioner.coarsesolver.preconditioner.verbosity",0);
             prm.put("preconditioner.coarsesolver.preconditioner.maxlevel",15);
             prm.put("preconditioner.coarsesolver.preconditioner.skip_isolated",0);
@@ -114,6 +117,8 @@ setupPropertyTree(const FlowLinearSolverParameters& p)
             prm.put("preconditioner.type", "ParOverILU0");
             prm.put("preconditioner.relaxation", p.ilu_relaxation_);
             prm.put("preconditioner.ilulevel", p.ilu_fillin_level_);
+            prm.put("preconditioner.level_scheduling", p.ilu_level_scheduling_);
+            prm.put("preconditioner.single_precision", p.preconditioner_single_precision_);
         }
     }
     return prm;
@@ -15,6 +15,7 @@
 #include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
 #include <opm/simulators/timestepping/TimeStepControlInterface.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
 BEGIN_PROPERTIES
@@ -240,6 +241,7 @@ namespace Opm {
                 SimulatorReportSingle substepReport;
                 std::string causeOfFailure = "";
                 try {
+                    OPM_TIMEBLOCK(time_step);
                     substepReport = solver.step(substepTimer);
                     if (solverVerbose_) {
                         // report number of linear iterations
@@ -0,0 +1,221 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <config.h>
+
+#include <opm/simulators/utils/DeckCache.hpp>
+
+#include <opm/common/OpmLog/OpmLog.hpp>
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+#include <opm/simulators/utils/moduleVersion.hpp>
+
+#include <ebos/eclmpiserializer.hh>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace Opm {
+
+namespace {
+
+const std::uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+
+// 64-bit FNV-1a
+std::uint64_t hashBytes(const char* data, std::size_t size, std::uint64_t hash)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template<class T>
+void writeValue(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& os, const std::string& value)
+{
+    writeValue<std::uint64_t>(os, value.size());
+    os.write(value.data(), value.size());
+}
+
+template<class T>
+T readValue(std::istream& is)
+{
+    T value{};
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!is)
+        throw std::runtime_error("Unexpected end of file");
+    return value;
+}
+
+std::string readString(std::istream& is)
+{
+    const auto size = readValue<std::uint64_t>(is);
+    std::string value(size, '\0');
+    is.read(&value[0], size);
+    if (!is)
+        throw std::runtime_error("Unexpected end of file");
+    return value;
+}
+
+}
+
+DeckCache::DeckCache(const std::string& cacheDir,
+                     const std::string& deckFilename,
+                     const std::string& options)
+    : deckFilename_(deckFilename)
+    , header_("OPM deck cache\n" + moduleVersion() + "\n" + options)
+{
+    char key[17];
+    const auto hash = hashBytes(deckFilename.data(), deckFilename.size(), fnvOffsetBasis);
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    const auto stem = filesystem::path(deckFilename).stem().string();
+    fileName_ = (filesystem::path(cacheDir) / (stem + "-" + key + ".OPMCACHE")).string();
+}
+
+
+bool DeckCache::load(Deck& deck, Schedule& schedule, SummaryConfig& summaryConfig) const
+{
+    std::ifstream is(fileName_, std::ios::binary);
+    if (!is)
+        return false;
+
+    try {
+        if (readString(is) != header_) {
+            OpmLog::info("Deck cache " + fileName_ + " was written with different settings, parsing the deck");
+            return false;
+        }
+
+        const auto numFiles = readValue<std::uint64_t>(is);
+        for (std::uint64_t i = 0; i < numFiles; ++i) {
+            InputFile cached;
+            cached.name = readString(is);
+            cached.size = readValue<std::uint64_t>(is);
+            cached.hash = readValue<std::uint64_t>(is);
+
+            InputFile current;
+            if (!hashFile(cached.name, current) || current.size != cached.size || current.hash != cached.hash) {
+                OpmLog::info("Input file " + cached.name + " has changed, parsing the deck");
+                return false;
+            }
+        }
+
+        EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+        ser.read(deck, is);
+        ser.read(schedule, is);
+        ser.read(summaryConfig, is);
+    }
+    catch (const std::exception& e) {
+        OpmLog::warning("Could not read deck cache " + fileName_ + ": " + e.what());
+        return false;
+    }
+
+    OpmLog::info("Loaded deck from cache " + fileName_);
+    return true;
+}
+
+
+void DeckCache::store(Deck& deck, Schedule& schedule, SummaryConfig& summaryConfig,
+                      const std::vector<std::string>& extraFiles) const
+{
+    std::vector<std::string> names{deckFilename_};
+    for (std::size_t i = 0; i < deck.size(); ++i) {
+        const auto& filename = deck.getKeyword(i).location().filename;
+        if (!filename.empty())
+            names.push_back(filename);
+    }
+    names.insert(names.end(), extraFiles.begin(), extraFiles.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    std::vector<InputFile> files(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (!hashFile(names[i], files[i])) {
+            OpmLog::warning("Could not read input file " + names[i] + ", the deck is not cached");
+            return;
+        }
+    }
+
+    // Write to a temporary file first such that concurrent runs never
+    // see a partially written cache.
+    const std::string tmpName = fileName_ + ".tmp";
+    try {
+        filesystem::create_directories(filesystem::path(fileName_).parent_path());
+        {
+            std::ofstream os(tmpName, std::ios::binary | std::ios::trunc);
+            if (!os)
+                throw std::runtime_error("Could not open " + tmpName);
+
+            writeString(os, header_);
+            writeValue<std::uint64_t>(os, files.size());
+            for (const auto& file : files) {
+                writeString(os, file.name);
+                writeValue(os, file.size);
+                writeValue(os, file.hash);
+            }
+
+            EclMpiSerializer ser(Dune::MPIHelper::getCollectiveCommunication());
+            ser.write(deck, os);
+            ser.write(schedule, os);
+            ser.write(summaryConfig, os);
+            if (!os)
+                throw std::runtime_error("Could not write " + tmpName);
+        }
+        filesystem::rename(tmpName, fileName_);
+    }
+    catch (const std::exception& e) {
+        OpmLog::warning("Could not write deck cache " + fileName_ + ": " + e.what());
+        std::remove(tmpName.c_str());
+        return;
+    }
+
+    OpmLog::info("Stored deck in cache " + fileName_);
+}
+
+
+bool DeckCache::hashFile(const std::string& name, InputFile& file)
+{
+    std::ifstream is(name, std::ios::binary);
+    if (!is)
+        return false;
+
+    file.name = name;
+    file.size = 0;
+    file.hash = fnvOffsetBasis;
+    std::vector<char> buffer(1 << 20);
+    while (is) {
+        is.read(buffer.data(), buffer.size());
+        const std::size_t count = is.gcount();
+        file.hash = hashBytes(buffer.data(), count, file.hash);
+        file.size += count;
+    }
+    return is.eof();
+}
+
+} // end namespace Opm
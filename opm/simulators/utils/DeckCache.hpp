@@ -0,0 +1,85 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_DECK_CACHE_HEADER_INCLUDED
+#define OPM_DECK_CACHE_HEADER_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+class Deck;
+class Schedule;
+class SummaryConfig;
+
+/*! \brief Cache of the parsed input of a case between runs.
+ *! \details Stores the serialized deck, schedule and summary configuration
+ *!          in a binary file. The file records the size and a hash of every
+ *!          input file which contributed to the deck, a cached entry is only
+ *!          used if all of them are unchanged. Only used on the root process.
+*/
+class DeckCache {
+public:
+    //! \brief Constructor.
+    //! \param cacheDir Directory holding the cache files
+    //! \param deckFilename Canonical path of the deck
+    //! \param options Settings affecting the parsed result, a cached entry
+    //!                is only used if they match
+    DeckCache(const std::string& cacheDir,
+              const std::string& deckFilename,
+              const std::string& options);
+
+    //! \brief Load a cached entry.
+    //! \return True if a valid entry was found and loaded. If false is
+    //!         returned the arguments may be partially filled and
+    //!         should be discarded.
+    bool load(Deck& deck, Schedule& schedule, SummaryConfig& summaryConfig) const;
+
+    //! \brief Store an entry, replacing an existing one.
+    //! \param extraFiles Input files in addition to the ones referenced
+    //!                   by the deck keywords, e.g. a restart file.
+    //! \details Failures are reported as warnings only.
+    void store(Deck& deck, Schedule& schedule, SummaryConfig& summaryConfig,
+               const std::vector<std::string>& extraFiles = {}) const;
+
+    //! \brief Returns the name of the cache file.
+    const std::string& fileName() const
+    {
+        return fileName_;
+    }
+
+private:
+    struct InputFile
+    {
+        std::string name;
+        std::uint64_t size;
+        std::uint64_t hash;
+    };
+
+    static bool hashFile(const std::string& name, InputFile& file);
+
+    std::string deckFilename_;
+    std::string header_;
+    std::string fileName_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_DECK_CACHE_HEADER_INCLUDED
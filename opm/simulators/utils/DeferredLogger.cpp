@@ -94,4 +94,10 @@ namespace Opm
         messages_.clear();
     }
 
+    void DeferredLogger::appendMessages(DeferredLogger& other)
+    {
+        messages_.insert(messages_.end(), other.messages_.begin(), other.messages_.end());
+        other.messages_.clear();
+    }
+
 } // namespace Opm
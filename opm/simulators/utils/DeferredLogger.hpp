@@ -67,6 +67,10 @@ namespace Opm
         /// Clear the message container without logging them.
         void clearMessages();
 
+        /// Append the messages of another logger to this one,
+        /// and clear the message container of the other logger.
+        void appendMessages(DeferredLogger& other);
+
     private:
         std::vector<Message> messages_;
         friend Opm::DeferredLogger gatherDeferredLogger(const Opm::DeferredLogger& local_deferredlogger);
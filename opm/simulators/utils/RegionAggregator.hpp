@@ -0,0 +1,253 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_REGIONAGGREGATOR_HEADER_INCLUDED
+#define OPM_REGIONAGGREGATOR_HEADER_INCLUDED
+
+#include <dune/grid/common/gridenums.hh>
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Opm
+{
+
+    /// Sums of cell quantities over the regions of one or more region maps.
+    ///
+    /// A fixed number of fields is evaluated once per cell and added to
+    /// the region of the cell in every region map. The sums of all maps
+    /// are kept in one buffer, so a single collective call reduces all
+    /// of them over the processes.
+    ///
+    /// The cells are split into one contiguous chunk per thread and the
+    /// partial sums of the threads are added in thread order. The sums
+    /// are therefore reproducible for a given number of threads.
+    class RegionAggregator
+    {
+    public:
+        /// \param numFields  number of quantities summed per region
+        explicit RegionAggregator(const int numFields)
+            : num_fields_(numFields)
+        {
+        }
+
+        /// Add a region map and return its index.
+        ///
+        /// \param cellRegions  region of every local cell, numbered from
+        ///                     zero. Cells with a negative region are not
+        ///                     counted in this map.
+        /// \param numRegions   number of regions on all processes
+        int addRegionMap(std::vector<int> cellRegions, const int numRegions)
+        {
+            maps_.push_back({std::move(cellRegions), sums_.size()});
+            sums_.resize(sums_.size() + numRegions * num_fields_, 0.0);
+            return maps_.size() - 1;
+        }
+
+        int numFields() const { return num_fields_; }
+        int numRegionMaps() const { return maps_.size(); }
+
+        int numRegions(const int map) const
+        {
+            const std::size_t end = (map + 1 < numRegionMaps()) ? maps_[map + 1].offset : sums_.size();
+            return (end - maps_[map].offset) / num_fields_;
+        }
+
+        /// Set all sums to zero.
+        void clear()
+        {
+            sums_.assign(sums_.size(), 0.0);
+        }
+
+        /// Add the fields of the cells 0, ..., numCells - 1.
+        ///
+        /// cellValues(cellIdx, values) is called concurrently by several
+        /// threads and writes the numFields() values of the cell to values.
+        template <class CellValues>
+        void accumulate(const std::size_t numCells, const CellValues& cellValues)
+        {
+            std::vector<std::vector<double>> threadSums(maxThreads_());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                const int thread = threadNum_();
+                const std::size_t begin = chunkBegin_(numCells, thread);
+                const std::size_t end = chunkBegin_(numCells, thread + 1);
+                auto& sums = threadSums[thread];
+                sums.assign(sums_.size(), 0.0);
+                std::vector<double> values(num_fields_);
+                for (std::size_t cellIdx = begin; cellIdx < end; ++cellIdx) {
+                    cellValues(cellIdx, values.data());
+                    addCell_(sums, cellIdx, values);
+                }
+            }
+            addThreadSums_(threadSums);
+        }
+
+        /// Add the fields of the interior cells of a simulator.
+        ///
+        /// cellValues(cellIdx, intQuants, values) is called concurrently
+        /// by several threads with the intensive quantities of the cell.
+        /// The cached intensive quantities are used where available,
+        /// otherwise they are computed for the primary variables.
+        template <class ElementContext, class Simulator, class CellValues>
+        void accumulateIntensiveQuantities(const Simulator& simulator, const CellValues& cellValues)
+        {
+            const auto& gridView = simulator.gridView();
+            const auto& model = simulator.model();
+            const std::size_t numElements = gridView.size(/*codim=*/0);
+            std::vector<std::vector<double>> threadSums(maxThreads_());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                const int thread = threadNum_();
+                const std::size_t begin = chunkBegin_(numElements, thread);
+                const std::size_t end = chunkBegin_(numElements, thread + 1);
+                auto& sums = threadSums[thread];
+                sums.assign(sums_.size(), 0.0);
+                std::vector<double> values(num_fields_);
+                ElementContext elemCtx(simulator);
+
+                auto elemIt = gridView.template begin</*codim=*/0>();
+                for (std::size_t elemIdx = 0; elemIdx < begin; ++elemIdx) {
+                    ++elemIt;
+                }
+                for (std::size_t elemIdx = begin; elemIdx < end; ++elemIdx, ++elemIt) {
+                    const auto& elem = *elemIt;
+                    if (elem.partitionType() != Dune::InteriorEntity)
+                        continue;
+
+                    const unsigned cellIdx = model.dofMapper().index(elem);
+                    const auto* iqPtr = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                    if (!iqPtr) {
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                        iqPtr = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    }
+                    cellValues(cellIdx, *iqPtr, values.data());
+                    addCell_(sums, cellIdx, values);
+                }
+            }
+            addThreadSums_(threadSums);
+        }
+
+        /// Sum the accumulated values over all processes. This is the
+        /// only collective call.
+        template <class Comm>
+        void reduce(const Comm& comm)
+        {
+            comm.sum(sums_.data(), sums_.size());
+        }
+
+        /// The sum of a field in a region of a map.
+        double sum(const int map, const int region, const int field) const
+        {
+            assert(region < numRegions(map));
+            return sums_[maps_[map].offset + region * num_fields_ + field];
+        }
+
+        /// The sums of a field in all regions of a map.
+        std::vector<double> sums(const int map, const int field) const
+        {
+            std::vector<double> result(numRegions(map));
+            for (std::size_t region = 0; region < result.size(); ++region) {
+                result[region] = sum(map, region, field);
+            }
+            return result;
+        }
+
+    private:
+        struct RegionMap
+        {
+            std::vector<int> cell_regions;
+            std::size_t offset;
+        };
+
+        static int maxThreads_()
+        {
+#ifdef _OPENMP
+            return omp_get_max_threads();
+#else
+            return 1;
+#endif
+        }
+
+        // The number of threads of the current parallel region.
+        static int numThreads_()
+        {
+#ifdef _OPENMP
+            return omp_get_num_threads();
+#else
+            return 1;
+#endif
+        }
+
+        static int threadNum_()
+        {
+#ifdef _OPENMP
+            return omp_get_thread_num();
+#else
+            return 0;
+#endif
+        }
+
+        static std::size_t chunkBegin_(const std::size_t size, const int thread)
+        {
+            return size * thread / numThreads_();
+        }
+
+        void addCell_(std::vector<double>& sums, const std::size_t cellIdx, const std::vector<double>& values) const
+        {
+            for (const auto& map : maps_) {
+                const int region = map.cell_regions[cellIdx];
+                if (region < 0)
+                    continue;
+
+                double* regionSums = sums.data() + map.offset + region * num_fields_;
+                for (int field = 0; field < num_fields_; ++field) {
+                    regionSums[field] += values[field];
+                }
+            }
+        }
+
+        void addThreadSums_(const std::vector<std::vector<double>>& threadSums)
+        {
+            for (const auto& sums : threadSums) {
+                for (std::size_t i = 0; i < sums.size(); ++i) {
+                    sums_[i] += sums[i];
+                }
+            }
+        }
+
+        int num_fields_;
+        std::vector<RegionMap> maps_;
+        std::vector<double> sums_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_REGIONAGGREGATOR_HEADER_INCLUDED
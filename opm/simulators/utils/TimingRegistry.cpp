@@ -0,0 +1,247 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/utils/TimingRegistry.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Opm
+{
+
+    namespace
+    {
+        void preorder(const std::vector<TimingRegistry::Node>& nodes, int node, std::vector<int>& order)
+        {
+            order.push_back(node);
+            for (int child : nodes[node].children) {
+                preorder(nodes, child, order);
+            }
+        }
+
+        std::vector<std::string> split(const std::string& s)
+        {
+            std::vector<std::string> lines;
+            std::istringstream is(s);
+            std::string line;
+            while (std::getline(is, line)) {
+                lines.push_back(line);
+            }
+            return lines;
+        }
+    } // anonymous namespace
+
+    TimingRegistry& TimingRegistry::instance()
+    {
+        static TimingRegistry registry;
+        return registry;
+    }
+
+    TimingRegistry::TimingRegistry()
+        : trace_enabled_(false)
+    {
+        clear();
+    }
+
+    void TimingRegistry::begin(const char* name)
+    {
+        const int parent = open_nodes_.back();
+        int node = -1;
+        for (int child : nodes_[parent].children) {
+            if (nodes_[child].name == name) {
+                node = child;
+                break;
+            }
+        }
+        if (node < 0) {
+            node = nodes_.size();
+            nodes_.push_back({name, parent, {}, 0.0, 0});
+            nodes_[parent].children.push_back(node);
+        }
+        open_nodes_.push_back(node);
+        open_times_.push_back(Clock::now());
+    }
+
+    void TimingRegistry::end()
+    {
+        // the root is never closed
+        if (open_nodes_.size() < 2) {
+            return;
+        }
+
+        const auto stop = Clock::now();
+        const int node = open_nodes_.back();
+        const auto start = open_times_.back();
+        open_nodes_.pop_back();
+        open_times_.pop_back();
+
+        const double seconds = std::chrono::duration<double>(stop - start).count();
+        nodes_[node].seconds += seconds;
+        ++nodes_[node].calls;
+        if (trace_enabled_) {
+            events_.push_back({node, std::chrono::duration<double>(start - epoch_).count(), seconds});
+        }
+    }
+
+    std::string TimingRegistry::path(int node) const
+    {
+        std::string result = nodes_[node].name;
+        for (int p = nodes_[node].parent; p > 0; p = nodes_[p].parent) {
+            result = nodes_[p].name + "/" + result;
+        }
+        return result;
+    }
+
+    void TimingRegistry::writeTrace(std::ostream& os, int pid)
+    {
+        os << "{\"traceEvents\":[";
+        const char* separator = "\n";
+        for (const auto& event : events_) {
+            os << separator
+               << "{\"name\":\"" << nodes_[event.node].name << "\","
+               << "\"cat\":\"" << path(event.node) << "\","
+               << "\"ph\":\"X\","
+               << "\"ts\":" << std::fixed << std::setprecision(3) << event.start * 1.0e6 << ","
+               << "\"dur\":" << event.duration * 1.0e6 << ","
+               << "\"pid\":" << pid << ",\"tid\":0}";
+            separator = ",\n";
+        }
+        os << "\n]}\n";
+        events_.clear();
+    }
+
+    void TimingRegistry::report(std::ostream& os, const Communication& comm) const
+    {
+        // Agree on a common list of nodes, the tree of the root process in
+        // depth first order followed by nodes only present on other processes.
+        std::vector<int> order;
+        preorder(nodes_, 0, order);
+        std::string localPaths;
+        for (std::size_t i = 1; i < order.size(); ++i) {
+            localPaths += path(order[i]) + "\n";
+        }
+
+        int localSize = localPaths.size();
+        std::vector<int> sizes(comm.size());
+        comm.gather(&localSize, sizes.data(), 1, 0);
+        std::vector<int> displ(comm.size() + 1, 0);
+        for (int r = 0; r < comm.size(); ++r) {
+            displ[r + 1] = displ[r] + sizes[r];
+        }
+        std::string allPaths(comm.rank() == 0 ? displ.back() : 0, '\0');
+        comm.gatherv(localPaths.data(), localSize, &allPaths[0], sizes.data(), displ.data(), 0);
+
+        std::string commonPaths;
+        if (comm.rank() == 0) {
+            std::vector<std::string> unique;
+            std::unordered_map<std::string, int> seen;
+            for (const auto& p : split(allPaths)) {
+                if (seen.emplace(p, unique.size()).second) {
+                    unique.push_back(p);
+                    commonPaths += p + "\n";
+                }
+            }
+        }
+        int commonSize = commonPaths.size();
+        comm.broadcast(&commonSize, 1, 0);
+        commonPaths.resize(commonSize);
+        comm.broadcast(&commonPaths[0], commonSize, 0);
+        const auto paths = split(commonPaths);
+
+        std::unordered_map<std::string, int> localNodes;
+        for (std::size_t i = 1; i < nodes_.size(); ++i) {
+            localNodes[path(i)] = i;
+        }
+        const int n = paths.size();
+        std::vector<double> minSeconds(n, 0.0);
+        std::vector<std::size_t> calls(n, 0);
+        for (int i = 0; i < n; ++i) {
+            const auto it = localNodes.find(paths[i]);
+            if (it != localNodes.end()) {
+                minSeconds[i] = nodes_[it->second].seconds;
+                calls[i] = nodes_[it->second].calls;
+            }
+        }
+        std::vector<double> maxSeconds = minSeconds;
+        std::vector<double> sumSeconds = minSeconds;
+        if (n > 0) {
+            comm.min(minSeconds.data(), n);
+            comm.max(maxSeconds.data(), n);
+            comm.sum(sumSeconds.data(), n);
+            comm.sum(calls.data(), n);
+        }
+
+        if (comm.rank() != 0) {
+            return;
+        }
+
+        os << std::left << std::setw(40) << "Timer"
+           << std::right << std::setw(12) << "Calls"
+           << std::setw(12) << "Min [s]"
+           << std::setw(12) << "Avg [s]"
+           << std::setw(12) << "Max [s]" << "\n";
+        for (int i = 0; i < n; ++i) {
+            const auto& p = paths[i];
+            const auto depth = std::count(p.begin(), p.end(), '/');
+            const auto name = std::string(2 * depth, ' ') + p.substr(p.rfind('/') + 1);
+            os << std::left << std::setw(40) << name
+               << std::right << std::setw(12) << calls[i]
+               << std::fixed << std::setprecision(3)
+               << std::setw(12) << minSeconds[i]
+               << std::setw(12) << sumSeconds[i] / comm.size()
+               << std::setw(12) << maxSeconds[i] << "\n";
+        }
+    }
+
+    void TimingRegistry::clear()
+    {
+        nodes_.assign(1, Node{"", -1, {}, 0.0, 0});
+        open_nodes_.assign(1, 0);
+        open_times_.assign(1, Clock::now());
+        events_.clear();
+        epoch_ = Clock::now();
+    }
+
+    ScopedTimer::ScopedTimer(const char* name)
+#ifdef _OPENMP
+        : active_(!omp_in_parallel())
+#else
+        : active_(true)
+#endif
+    {
+        if (active_) {
+            TimingRegistry::instance().begin(name);
+        }
+    }
+
+    ScopedTimer::~ScopedTimer()
+    {
+        if (active_) {
+            TimingRegistry::instance().end();
+        }
+    }
+
+} // namespace Opm
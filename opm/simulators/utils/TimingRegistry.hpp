@@ -0,0 +1,134 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TIMINGREGISTRY_HEADER_INCLUDED
+#define OPM_TIMINGREGISTRY_HEADER_INCLUDED
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Hierarchical wall clock timings of the simulator.
+    ///
+    /// Timed blocks are opened with begin() and closed with end(),
+    /// usually through ScopedTimer. A block opened while another one
+    /// is open becomes its child, the time and the number of calls are
+    /// accumulated per position in the resulting tree. Optionally, every
+    /// single call is recorded as well and can be written as a trace in
+    /// the Chrome trace event format.
+    ///
+    /// The registry is meant to be used from the main thread only,
+    /// blocks inside OpenMP parallel regions are ignored by ScopedTimer.
+    class TimingRegistry
+    {
+    public:
+        using Communication = Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>;
+
+        struct Node
+        {
+            std::string name;
+            int parent;
+            std::vector<int> children;
+            double seconds;
+            std::size_t calls;
+        };
+
+        /// The registry of the process.
+        static TimingRegistry& instance();
+
+        TimingRegistry();
+
+        /// Open a block as child of the currently open one.
+        void begin(const char* name);
+
+        /// Close the most recently opened block.
+        void end();
+
+        /// Record every call for writeTrace().
+        void setTraceEnabled(bool enabled) { trace_enabled_ = enabled; }
+        bool traceEnabled() const { return trace_enabled_; }
+
+        /// All nodes of the tree, node 0 is the root which is never closed.
+        const std::vector<Node>& nodes() const { return nodes_; }
+
+        /// The names of the node and its ancestors separated by '/'.
+        std::string path(int node) const;
+
+        /// Write the calls recorded since the last call of this method
+        /// in the Chrome trace event format and forget them.
+        /// \param pid  process id written to the events, e.g. the MPI rank
+        void writeTrace(std::ostream& os, int pid);
+
+        /// Write a table of the accumulated times with the minimum,
+        /// average and maximum over all processes of comm. Must be called
+        /// on all processes, only the root process writes to os.
+        void report(std::ostream& os, const Communication& comm) const;
+
+        /// Forget all timings.
+        void clear();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Event
+        {
+            int node;
+            double start;
+            double duration;
+        };
+
+        std::vector<Node> nodes_;
+        std::vector<int> open_nodes_;
+        std::vector<Clock::time_point> open_times_;
+        std::vector<Event> events_;
+        Clock::time_point epoch_;
+        bool trace_enabled_;
+    };
+
+    /// Times the enclosing scope in the TimingRegistry of the process.
+    class ScopedTimer
+    {
+    public:
+        /// \param name  name of the block, should be a string literal
+        explicit ScopedTimer(const char* name);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        bool active_;
+    };
+
+} // namespace Opm
+
+#define OPM_TIMEBLOCK_CONCAT_(a, b) a##b
+#define OPM_TIMEBLOCK_NAME_(line) OPM_TIMEBLOCK_CONCAT_(opmTimeBlock, line)
+
+/// Time the enclosing scope under the given name.
+#define OPM_TIMEBLOCK(name) ::Opm::ScopedTimer OPM_TIMEBLOCK_NAME_(__LINE__)(#name)
+
+#endif // OPM_TIMINGREGISTRY_HEADER_INCLUDED
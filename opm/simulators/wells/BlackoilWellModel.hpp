@@ -52,6 +52,7 @@
 #include <opm/simulators/wells/StandardWell.hpp>
 #include <opm/simulators/wells/MultisegmentWell.hpp>
 #include <opm/simulators/wells/WellGroupHelpers.hpp>
+#include <opm/simulators/wells/GroupRates.hpp>
 #include <opm/simulators/timestepping/gatherConvergenceReport.hpp>
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bcrsmatrix.hh>
@@ -235,10 +236,8 @@ namespace Opm {
             // subtract B*inv(D)*C * x from A*x
             void apply(const BVector& x, BVector& Ax) const;
 
-#if HAVE_CUDA
             // accumulate the contributions of all Wells in the WellContributions object
             void getWellContributions(WellContributions& x) const;
-#endif
 
             // apply well model with scaling of alpha
             void applyScaleAdd(const Scalar alpha, const BVector& x, BVector& Ax) const;
@@ -253,6 +252,18 @@ namespace Opm {
             // return the internal well state
             const WellState& wellState() const;
 
+            // extrapolate the internal well state from the converged states of previous
+            // time steps, see WellStateFullyImplicitBlackoil::extrapolate()
+            void extrapolateWellState(const std::vector<const WellState*>& states,
+                                      const std::vector<double>& weights);
+
+            // replace the internal well state, e.g. to undo extrapolateWellState()
+            void resetWellState(const WellState& well_state);
+
+            // assemble the well equations again for the current well state, without
+            // updating the controls or solving the well equations first
+            void reassemble(const double dt);
+
             const SimulatorReportSingle& lastReport() const;
 
             void addWellContributions(SparseMatrixAdapter& jacobian) const
@@ -289,6 +300,16 @@ namespace Opm {
 
             std::vector<bool> is_cell_perforated_;
 
+            // the wells of well_container_ grouped into colours, no two wells of the
+            // same colour perforate the same cell, so that their contributions to the
+            // reservoir vectors can be added concurrently
+            std::vector<std::vector<int> > well_colors_;
+
+            // indices into well_container_ of the wells which are assembled concurrently
+            // and of those which have to be assembled sequentially
+            std::vector<int> threaded_assembly_wells_;
+            std::vector<int> serial_assembly_wells_;
+
             void initializeWellPerfData();
 
             // create the well container
@@ -321,6 +342,7 @@ namespace Opm {
 
             WellTestState wellTestState_;
             std::unique_ptr<GuideRate> guideRate_;
+            WellGroupHelpers::GroupTree group_tree_;
 
             // used to better efficiency of calcuation
             mutable BVector scaleAddRes_;
@@ -390,6 +412,12 @@ namespace Opm {
 
             void assembleWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger);
 
+            // whether the loops over the wells are distributed over the threads
+            bool useThreadedWells() const;
+
+            // set up well_colors_ and the split of the wells for the threaded assembly
+            void setupThreadedWells();
+
             // some preparation work, mostly related to group control and RESV,
             // at the beginning of each time step (Not report step)
             void prepareTimeStep(Opm::DeferredLogger& deferred_logger);
@@ -424,15 +452,17 @@ namespace Opm {
 
             const Well& getWellEcl(const std::string& well_name) const;
 
-            void updateGroupIndividualControls(Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
-            void updateGroupIndividualControl(const Group& group, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
-            bool checkGroupConstraints(const Group& group, Opm::DeferredLogger& deferred_logger) const;
-            Group::ProductionCMode checkGroupProductionConstraints(const Group& group, Opm::DeferredLogger& deferred_logger) const;
-            Group::InjectionCMode checkGroupInjectionConstraints(const Group& group, const Phase& phase) const;
-            void checkGconsaleLimits(const Group& group, WellState& well_state, Opm::DeferredLogger& deferred_logger ) const;
-
-            void updateGroupHigherControls(Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
-            void checkGroupHigherConstraints(const Group& group, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
+            // The group constraint checks take the group rates summed over
+            // all processes, see WellGroupHelpers::GroupRates.
+            void updateGroupIndividualControls(const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
+            void updateGroupIndividualControl(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
+            bool checkGroupConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger) const;
+            Group::ProductionCMode checkGroupProductionConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger) const;
+            Group::InjectionCMode checkGroupInjectionConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, const Phase& phase) const;
+            void checkGconsaleLimits(const Group& group, const WellGroupHelpers::GroupRates& group_rates, WellState& well_state, Opm::DeferredLogger& deferred_logger ) const;
+
+            void updateGroupHigherControls(const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
+            void checkGroupHigherConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups);
 
             void actionOnBrokenConstraints(const Group& group, const Group::ExceedAction& exceed_action, const Group::ProductionCMode& newControl, Opm::DeferredLogger& deferred_logger);
 
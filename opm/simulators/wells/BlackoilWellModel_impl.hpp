@@ -21,9 +21,17 @@
 */
 
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
+#include <opm/simulators/utils/TimingRegistry.hpp>
 #include <opm/simulators/wells/SimFIBODetails.hpp>
+#include <opm/simulators/wells/WellColoring.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
     template<typename TypeTag>
     BlackoilWellModel<TypeTag>::
@@ -271,6 +279,9 @@ namespace Opm {
             well_state_.initWellStateMSWell(wells_ecl_, phase_usage_, &previous_well_state_);
         }
 
+        // The group hierarchy and the well map are fixed for the report step.
+        group_tree_ = WellGroupHelpers::GroupTree(schedule(), timeStepIdx, well_state_);
+
         const int nw = wells_ecl_.size();
         for (int w = 0; w <nw; ++w) {
             const auto& well = wells_ecl_[w];
@@ -344,6 +355,8 @@ namespace Opm {
                 well->updatePerforatedCell(is_cell_perforated_);
             }
 
+            setupThreadedWells();
+
             // calculate the efficiency factors for each well
             calculateEfficiencyFactors(reportStepIdx);
 
@@ -363,6 +376,7 @@ namespace Opm {
         for (auto& well : well_container_) {
             well->setVFPProperties(vfp_properties_.get());
             well->setGuideRate(guideRate_.get());
+            well->setGroupTree(&group_tree_);
         }
 
         // Close completions due to economical reasons
@@ -412,6 +426,7 @@ namespace Opm {
                 well->setWellEfficiencyFactor(well_efficiency_factor);
                 well->setVFPProperties(vfp_properties_.get());
                 well->setGuideRate(guideRate_.get());
+                well->setGroupTree(&group_tree_);
 
                 const WellTestConfig::Reason testing_reason = testWell.second;
 
@@ -467,7 +482,9 @@ namespace Opm {
 
         // check group sales limits at the end of the timestep
         const Group& fieldGroup = schedule().getGroup("FIELD", reportStepIdx);
-        checkGconsaleLimits(fieldGroup, well_state_, local_deferredLogger);
+        const auto& comm = ebosSimulator_.vanguard().grid().comm();
+        const WellGroupHelpers::GroupRates group_rates(group_tree_, well_state_, phase_usage_, comm);
+        checkGconsaleLimits(fieldGroup, group_rates, well_state_, local_deferredLogger);
 
         previous_well_state_ = well_state_;
 
@@ -808,6 +825,7 @@ namespace Opm {
     assemble(const int iterationIdx,
              const double dt)
     {
+        OPM_TIMEBLOCK(well_assembly);
 
         last_report_ = SimulatorReportSingle();
 
@@ -860,13 +878,119 @@ namespace Opm {
         last_report_.converged = true;
     }
 
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    reassemble(const double dt)
+    {
+        if (!wellsActive()) {
+            return;
+        }
+
+        Opm::DeferredLogger local_deferredLogger;
+
+        updatePerforationIntensiveQuantities();
+
+        int exception_thrown = 0;
+        try {
+            initPrimaryVariablesEvaluation();
+
+            std::vector< Scalar > B_avg(numComponents(), Scalar() );
+            computeAverageFormationFactor(B_avg);
+
+            assembleWellEq(B_avg, dt, local_deferredLogger);
+        } catch (std::exception& e) {
+            exception_thrown = 1;
+        }
+        logAndCheckForExceptionsAndThrow(local_deferredLogger, exception_thrown, "reassemble() failed.", terminal_output_);
+    }
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     assembleWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger)
     {
-        for (auto& well : well_container_) {
-            well->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, deferred_logger);
+        if (!useThreadedWells()) {
+            for (auto& well : well_container_) {
+                well->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, deferred_logger);
+            }
+            return;
+        }
+
+#ifdef _OPENMP
+        // every well only writes its own entries of the well state, the messages are
+        // collected per thread and merged in the order of the threads. With the static
+        // schedule this keeps the order of the messages of the sequential loop.
+        std::vector<Opm::DeferredLogger> thread_loggers(omp_get_max_threads());
+        int exception_thrown = 0;
+        const int num_threaded = threaded_assembly_wells_.size();
+#pragma omp parallel for schedule(static) reduction(max: exception_thrown)
+        for (int i = 0; i < num_threaded; ++i) {
+            try {
+                auto& well = well_container_[threaded_assembly_wells_[i]];
+                well->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, thread_loggers[omp_get_thread_num()]);
+            } catch (std::exception& e) {
+                exception_thrown = 1;
+            }
+        }
+        for (auto& logger : thread_loggers) {
+            deferred_logger.appendMessages(logger);
+        }
+        if (exception_thrown) {
+            OPM_THROW(std::runtime_error, "assembleWellEq() failed for at least one well.");
+        }
+#endif
+
+        for (const int w : serial_assembly_wells_) {
+            well_container_[w]->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, deferred_logger);
+        }
+    }
+
+
+
+    template<typename TypeTag>
+    bool
+    BlackoilWellModel<TypeTag>::
+    useThreadedWells() const
+    {
+#ifdef _OPENMP
+        return param_.use_threaded_wells_ && omp_get_max_threads() > 1;
+#else
+        return false;
+#endif
+    }
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    setupThreadedWells()
+    {
+        well_colors_.clear();
+        threaded_assembly_wells_.clear();
+        serial_assembly_wells_.clear();
+
+        if (!useThreadedWells()) {
+            return;
+        }
+
+        std::vector<std::vector<int>> well_cells;
+        well_cells.reserve(well_container_.size());
+        for (const auto& well : well_container_) {
+            well_cells.push_back(well->cells());
+        }
+        well_colors_ = colorWellsByCells(well_cells);
+
+        const int nw = well_container_.size();
+        for (int w = 0; w < nw; ++w) {
+            // the inner iterations of the multisegment wells work on a copy of the
+            // complete well state, which is not safe while other wells update theirs
+            if (std::dynamic_pointer_cast<MultisegmentWell<TypeTag> >(well_container_[w])) {
+                serial_assembly_wells_.push_back(w);
+            } else {
+                threaded_assembly_wells_.push_back(w);
+            }
         }
     }
 
@@ -879,8 +1003,22 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(r);
+        if (!useThreadedWells()) {
+            for (auto& well : well_container_) {
+                well->apply(r);
+            }
+            return;
+        }
+
+        // the wells of one colour do not share any cells
+        for (const auto& wells : well_colors_) {
+            const int num_wells = wells.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int i = 0; i < num_wells; ++i) {
+                well_container_[wells[i]]->apply(r);
+            }
         }
     }
 
@@ -896,12 +1034,25 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(x, Ax);
+        if (!useThreadedWells()) {
+            for (auto& well : well_container_) {
+                well->apply(x, Ax);
+            }
+            return;
+        }
+
+        // the wells of one colour do not share any cells
+        for (const auto& wells : well_colors_) {
+            const int num_wells = wells.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int i = 0; i < num_wells; ++i) {
+                well_container_[wells[i]]->apply(x, Ax);
+            }
         }
     }
 
-#if HAVE_CUDA
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -938,7 +1089,6 @@ namespace Opm {
             }
         }
     }
-#endif
 
     // Ax = Ax - alpha * C D^-1 B x
     template<typename TypeTag>
@@ -974,7 +1124,7 @@ namespace Opm {
 
         int exception_thrown = 0;
         try {
-            if (localWellsActive()) {
+            if (localWellsActive() && !useThreadedWells()) {
                 for (auto& well : well_container_) {
                     well->recoverWellSolutionAndUpdateWellState(x, well_state_, local_deferredLogger);
                 }
@@ -982,6 +1132,25 @@ namespace Opm {
         } catch (std::exception& e) {
             exception_thrown = 1;
         }
+
+#ifdef _OPENMP
+        if (localWellsActive() && useThreadedWells()) {
+            // every well only updates its own entries of the well state
+            std::vector<Opm::DeferredLogger> thread_loggers(omp_get_max_threads());
+            const int nw = well_container_.size();
+#pragma omp parallel for schedule(static) reduction(max: exception_thrown)
+            for (int w = 0; w < nw; ++w) {
+                try {
+                    well_container_[w]->recoverWellSolutionAndUpdateWellState(x, well_state_, thread_loggers[omp_get_thread_num()]);
+                } catch (std::exception& e) {
+                    exception_thrown = 1;
+                }
+            }
+            for (auto& logger : thread_loggers) {
+                local_deferredLogger.appendMessages(logger);
+            }
+        }
+#endif
         logAndCheckForExceptionsAndThrow(local_deferredLogger, exception_thrown, "recoverWellSolutionAndUpdateWellState() failed.", terminal_output_);
     }
 
@@ -1152,7 +1321,9 @@ namespace Opm {
         if (checkGroupConvergence) {
             const int reportStepIdx = ebosSimulator_.episodeIndex();
             const Group& fieldGroup = schedule().getGroup("FIELD", reportStepIdx);
-            bool violated = checkGroupConstraints(fieldGroup, global_deferredLogger);
+            const auto& comm = ebosSimulator_.vanguard().grid().comm();
+            const WellGroupHelpers::GroupRates group_rates(group_tree_, well_state_, phase_usage_, comm);
+            bool violated = checkGroupConstraints(fieldGroup, group_rates, global_deferredLogger);
             report.setGroupConverged(!violated);
         }
         return report;
@@ -1193,11 +1364,16 @@ namespace Opm {
         std::set<std::string> switched_groups;
 
         if (checkGroupControls) {
+            // The group rates do not change while the group controls are
+            // updated, they are therefore summed over all processes once.
+            const auto& comm = ebosSimulator_.vanguard().grid().comm();
+            const WellGroupHelpers::GroupRates group_rates(group_tree_, well_state_, phase_usage_, comm);
+
             // Check group individual constraints.
-            updateGroupIndividualControls(deferred_logger, switched_groups);
+            updateGroupIndividualControls(group_rates, deferred_logger, switched_groups);
 
             // Check group's constraints from higher levels.
-            updateGroupHigherControls(deferred_logger, switched_groups);
+            updateGroupHigherControls(group_rates, deferred_logger, switched_groups);
 
             updateAndCommunicateGroupData();
 
@@ -1249,10 +1425,8 @@ namespace Opm {
 
         // the group target reduction rates needs to be update since wells may have swicthed to/from GRUP control
         // Currently the group target reduction does not honor NUPCOL. TODO: is that true?
-        std::vector<double> groupTargetReduction(numPhases(), 0.0);
-        WellGroupHelpers::updateGroupTargetReduction(fieldGroup, schedule(), reportStepIdx, /*isInjector*/ false, phase_usage_, *guideRate_, well_state_nupcol_, well_state_, groupTargetReduction);
-        std::vector<double> groupTargetReductionInj(numPhases(), 0.0);
-        WellGroupHelpers::updateGroupTargetReduction(fieldGroup, schedule(), reportStepIdx, /*isInjector*/ true, phase_usage_, *guideRate_, well_state_nupcol_, well_state_, groupTargetReductionInj);
+        WellGroupHelpers::updateGroupTargetReduction(group_tree_, /*isInjector*/ false, phase_usage_, *guideRate_, well_state_nupcol_, well_state_);
+        WellGroupHelpers::updateGroupTargetReduction(group_tree_, /*isInjector*/ true, phase_usage_, *guideRate_, well_state_nupcol_, well_state_);
 
         const double simulationTime = ebosSimulator_.time();
         std::vector<double> pot(numPhases(), 0.0);
@@ -1402,6 +1576,42 @@ namespace Opm {
     wellState(const WellState& well_state OPM_UNUSED) const { return wellState(); }
 
 
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    extrapolateWellState(const std::vector<const WellState*>& states,
+                         const std::vector<double>& weights)
+    {
+        well_state_.extrapolate(states, weights, param_.dbhp_max_rel_);
+
+        Opm::DeferredLogger local_deferredLogger;
+        updatePrimaryVariables(local_deferredLogger);
+        Opm::DeferredLogger global_deferredLogger = gatherDeferredLogger(local_deferredLogger);
+        if (terminal_output_) {
+            global_deferredLogger.logMessages();
+        }
+    }
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    resetWellState(const WellState& well_state)
+    {
+        well_state_ = well_state;
+
+        Opm::DeferredLogger local_deferredLogger;
+        updatePrimaryVariables(local_deferredLogger);
+        Opm::DeferredLogger global_deferredLogger = gatherDeferredLogger(local_deferredLogger);
+        if (terminal_output_) {
+            global_deferredLogger.logMessages();
+        }
+    }
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1755,7 +1965,7 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    updateGroupIndividualControls(Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups)
+    updateGroupIndividualControls(const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups)
     {
         const int reportStepIdx = ebosSimulator_.episodeIndex();
 
@@ -1767,7 +1977,7 @@ namespace Opm {
             return;
 
         const Group& fieldGroup = schedule().getGroup("FIELD", reportStepIdx);
-        updateGroupIndividualControl(fieldGroup, deferred_logger, switched_groups);
+        updateGroupIndividualControl(fieldGroup, group_rates, deferred_logger, switched_groups);
     }
 
 
@@ -1775,7 +1985,7 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    updateGroupIndividualControl(const Group& group, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups) {
+    updateGroupIndividualControl(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups) {
 
         const int reportStepIdx = ebosSimulator_.episodeIndex();
         const bool skip = switched_groups.count(group.name());
@@ -1786,7 +1996,7 @@ namespace Opm {
                 if (!group.hasInjectionControl(phase)) {
                     continue;
                 }
-                Group::InjectionCMode newControl = checkGroupInjectionConstraints(group, phase);
+                Group::InjectionCMode newControl = checkGroupInjectionConstraints(group, group_rates, phase);
                 if (newControl != Group::InjectionCMode::NONE)
                 {
                     switched_groups.insert(group.name());
@@ -1795,7 +2005,7 @@ namespace Opm {
             }
         }
         if (!skip && group.isProductionGroup()) {
-            Group::ProductionCMode newControl = checkGroupProductionConstraints(group, deferred_logger);
+            Group::ProductionCMode newControl = checkGroupProductionConstraints(group, group_rates, deferred_logger);
             const auto& summaryState = ebosSimulator_.vanguard().summaryState();
             const auto controls = group.productionControls(summaryState);
             if (newControl != Group::ProductionCMode::NONE)
@@ -1807,14 +2017,14 @@ namespace Opm {
 
         // call recursively down the group hiearchy
         for (const std::string& groupName : group.groups()) {
-            updateGroupIndividualControl( schedule().getGroup(groupName, reportStepIdx), deferred_logger, switched_groups);
+            updateGroupIndividualControl( schedule().getGroup(groupName, reportStepIdx), group_rates, deferred_logger, switched_groups);
         }
     }
 
     template<typename TypeTag>
     bool
     BlackoilWellModel<TypeTag>::
-    checkGroupConstraints(const Group& group, Opm::DeferredLogger& deferred_logger) const {
+    checkGroupConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger) const {
 
         const int reportStepIdx = ebosSimulator_.episodeIndex();
         if (group.isInjectionGroup()) {
@@ -1823,14 +2033,14 @@ namespace Opm {
                 if (!group.hasInjectionControl(phase)) {
                     continue;
                 }
-                Group::InjectionCMode newControl = checkGroupInjectionConstraints(group, phase);
+                Group::InjectionCMode newControl = checkGroupInjectionConstraints(group, group_rates, phase);
                 if (newControl != Group::InjectionCMode::NONE) {
                     return true;
                 }
             }
         }
         if (group.isProductionGroup()) {
-            Group::ProductionCMode newControl = checkGroupProductionConstraints(group, deferred_logger);
+            Group::ProductionCMode newControl = checkGroupProductionConstraints(group, group_rates, deferred_logger);
             if (newControl != Group::ProductionCMode::NONE)
             {
                 return true;
@@ -1840,7 +2050,7 @@ namespace Opm {
         // call recursively down the group hiearchy
         bool violated = false;
         for (const std::string& groupName : group.groups()) {
-            violated = violated || checkGroupConstraints( schedule().getGroup(groupName, reportStepIdx), deferred_logger);
+            violated = violated || checkGroupConstraints( schedule().getGroup(groupName, reportStepIdx), group_rates, deferred_logger);
         }
         return violated;
     }
@@ -1850,11 +2060,9 @@ namespace Opm {
     template<typename TypeTag>
     Group::ProductionCMode
     BlackoilWellModel<TypeTag>::
-    checkGroupProductionConstraints(const Group& group, Opm::DeferredLogger& deferred_logger) const {
+    checkGroupProductionConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger) const {
 
-        const int reportStepIdx = ebosSimulator_.episodeIndex();
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
-        const auto& comm = ebosSimulator_.vanguard().grid().comm();
         const auto& well_state = well_state_;
 
         const auto controls = group.productionControls(summaryState);
@@ -1865,10 +2073,7 @@ namespace Opm {
             if (currentControl != Group::ProductionCMode::ORAT)
             {
                 double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Liquid], false);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                current_rate += group_rates.surfaceRate(group.name(), phase_usage_.phase_pos[BlackoilPhases::Liquid], false);
 
                 if (controls.oil_target < current_rate  ) {
                     return Group::ProductionCMode::ORAT;
@@ -1882,10 +2087,7 @@ namespace Opm {
             {
 
                 double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Aqua], false);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                current_rate += group_rates.surfaceRate(group.name(), phase_usage_.phase_pos[BlackoilPhases::Aqua], false);
 
                 if (controls.water_target < current_rate  ) {
                     return Group::ProductionCMode::WRAT;
@@ -1897,10 +2099,7 @@ namespace Opm {
             if (currentControl != Group::ProductionCMode::GRAT)
             {
                 double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Vapour], false);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                current_rate += group_rates.surfaceRate(group.name(), phase_usage_.phase_pos[BlackoilPhases::Vapour], false);
                 if (controls.gas_target < current_rate  ) {
                     return Group::ProductionCMode::GRAT;
                 }
@@ -1910,12 +2109,7 @@ namespace Opm {
         {
             if (currentControl != Group::ProductionCMode::LRAT)
             {
-                double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Liquid], false);
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Aqua], false);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                const double current_rate = group_rates.liquidRate(group.name());
 
                 if (controls.liquid_target < current_rate  ) {
                      return Group::ProductionCMode::LRAT;
@@ -1931,13 +2125,7 @@ namespace Opm {
         {
             if (currentControl != Group::ProductionCMode::RESV)
             {
-                double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Aqua], true);
-                current_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Liquid], true);
-                current_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Vapour], true);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                const double current_rate = group_rates.totalReservoirRate(group.name(), true);
 
                 if (controls.resv_target < current_rate  ) {
                     return Group::ProductionCMode::RESV;
@@ -1956,11 +2144,10 @@ namespace Opm {
     template<typename TypeTag>
     Group::InjectionCMode
     BlackoilWellModel<TypeTag>::
-    checkGroupInjectionConstraints(const Group& group, const Phase& phase) const {
+    checkGroupInjectionConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, const Phase& phase) const {
 
         const int reportStepIdx = ebosSimulator_.episodeIndex();
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
-        const auto& comm = ebosSimulator_.vanguard().grid().comm();
         const auto& well_state = well_state_;
 
         int phasePos;
@@ -1981,10 +2168,7 @@ namespace Opm {
             if (currentControl != Group::InjectionCMode::RATE)
             {
                 double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phasePos, /*isInjector*/true);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                current_rate += group_rates.surfaceRate(group.name(), phasePos, /*isInjector*/true);
 
                 if (controls.surface_max_rate < current_rate) {
                     return Group::InjectionCMode::RATE;
@@ -1996,9 +2180,7 @@ namespace Opm {
             if (currentControl != Group::InjectionCMode::RESV)
             {
                 double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phasePos, /*isInjector*/true);
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                current_rate += group_rates.reservoirRate(group.name(), phasePos, /*isInjector*/true);
 
                 if (controls.resv_max_rate < current_rate) {
                     return Group::InjectionCMode::RESV;
@@ -2011,16 +2193,10 @@ namespace Opm {
             {
                 double production_Rate = 0.0;
                 const Group& groupRein = schedule().getGroup(controls.reinj_group, reportStepIdx);
-                production_Rate += WellGroupHelpers::sumWellRates(groupRein, schedule(), well_state, reportStepIdx, phasePos, /*isInjector*/false);
-
-                // sum over all nodes
-                production_Rate = comm.sum(production_Rate);
+                production_Rate += group_rates.surfaceRate(groupRein.name(), phasePos, /*isInjector*/false);
 
                 double current_rate = 0.0;
-                current_rate += WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, phasePos, /*isInjector*/true);
-
-                // sum over all nodes
-                current_rate = comm.sum(current_rate);
+                current_rate += group_rates.surfaceRate(group.name(), phasePos, /*isInjector*/true);
 
                 if (controls.target_reinj_fraction*production_Rate < current_rate) {
                     return Group::InjectionCMode::REIN;
@@ -2031,22 +2207,9 @@ namespace Opm {
         {
             if (currentControl != Group::InjectionCMode::VREP)
             {
-                double voidage_rate = 0.0;
                 const Group& groupVoidage = schedule().getGroup(controls.voidage_group, reportStepIdx);
-                voidage_rate += WellGroupHelpers::sumWellResRates(groupVoidage, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Aqua], false);
-                voidage_rate += WellGroupHelpers::sumWellResRates(groupVoidage, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Liquid], false);
-                voidage_rate += WellGroupHelpers::sumWellResRates(groupVoidage, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Vapour], false);
-
-                // sum over all nodes
-                voidage_rate = comm.sum(voidage_rate);
-
-                double total_rate = 0.0;
-                total_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Aqua], true);
-                total_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Liquid], true);
-                total_rate += WellGroupHelpers::sumWellResRates(group, schedule(), well_state, reportStepIdx, phase_usage_.phase_pos[BlackoilPhases::Vapour], true);
-
-                // sum over all nodes
-                total_rate = comm.sum(total_rate);
+                const double voidage_rate = group_rates.totalReservoirRate(groupVoidage.name(), false);
+                const double total_rate = group_rates.totalReservoirRate(group.name(), true);
 
                 if (controls.target_void_fraction*voidage_rate < total_rate) {
                     return Group::InjectionCMode::VREP;
@@ -2059,12 +2222,12 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    checkGconsaleLimits(const Group& group, WellState& well_state, Opm::DeferredLogger& deferred_logger) const
+    checkGconsaleLimits(const Group& group, const WellGroupHelpers::GroupRates& group_rates, WellState& well_state, Opm::DeferredLogger& deferred_logger) const
     {
         const int reportStepIdx = ebosSimulator_.episodeIndex();
          // call recursively down the group hiearchy
         for (const std::string& groupName : group.groups()) {
-            checkGconsaleLimits( schedule().getGroup(groupName, reportStepIdx), well_state, deferred_logger);
+            checkGconsaleLimits( schedule().getGroup(groupName, reportStepIdx), group_rates, well_state, deferred_logger);
         }
 
         // only for groups with gas injection controls
@@ -2079,19 +2242,14 @@ namespace Opm {
         std::ostringstream ss;
 
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
-        const auto& comm = ebosSimulator_.vanguard().grid().comm();
 
         const auto& gconsale = schedule().gConSale(reportStepIdx).get(group.name(), summaryState);
         const Group::ProductionCMode& oldProductionControl = well_state.currentProductionGroupControl(group.name());
 
 
         int gasPos = phase_usage_.phase_pos[BlackoilPhases::Vapour];
-        double production_rate = WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, gasPos, /*isInjector*/false);
-        double injection_rate = WellGroupHelpers::sumWellRates(group, schedule(), well_state, reportStepIdx, gasPos, /*isInjector*/true);
-
-        // sum over all nodes
-        injection_rate = comm.sum(injection_rate);
-        production_rate = comm.sum(production_rate);
+        double production_rate = group_rates.surfaceRate(group.name(), gasPos, /*isInjector*/false);
+        double injection_rate = group_rates.surfaceRate(group.name(), gasPos, /*isInjector*/true);
 
         double sales_rate = production_rate - injection_rate;
         double production_target = gconsale.sales_target + injection_rate;
@@ -2267,18 +2425,18 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    updateGroupHigherControls(Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups)
+    updateGroupHigherControls(const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups)
     {
         const int reportStepIdx = ebosSimulator_.episodeIndex();
         const Group& fieldGroup = schedule().getGroup("FIELD", reportStepIdx);
-        checkGroupHigherConstraints(fieldGroup, deferred_logger, switched_groups);
+        checkGroupHigherConstraints(fieldGroup, group_rates, deferred_logger, switched_groups);
     }
 
 
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    checkGroupHigherConstraints(const Group& group, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups)
+    checkGroupHigherConstraints(const Group& group, const WellGroupHelpers::GroupRates& group_rates, Opm::DeferredLogger& deferred_logger, std::set<std::string>& switched_groups)
     {
         // Set up coefficients for RESV <-> surface rate conversion.
         // Use the pvtRegionIdx from the top cell of the first well.
@@ -2296,17 +2454,13 @@ namespace Opm {
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
 
         std::vector<double> rates(phase_usage_.num_phases, 0.0);
-        const auto& comm = ebosSimulator_.vanguard().grid().comm();
 
         const bool skip = switched_groups.count(group.name()) || group.name() == "FIELD";
 
         if (!skip && group.isInjectionGroup()) {
             // Obtain rates for group.
             for (int phasePos = 0; phasePos < phase_usage_.num_phases; ++phasePos) {
-                const double local_current_rate = WellGroupHelpers::sumWellRates(
-                    group, schedule(), well_state_, reportStepIdx, phasePos, /* isInjector */ true);
-                // Sum over all processes
-                rates[phasePos] = comm.sum(local_current_rate);
+                rates[phasePos] = group_rates.surfaceRate(group.name(), phasePos, /* isInjector */ true);
             }
             const Phase all[] = { Phase::WATER, Phase::OIL, Phase::GAS };
             for (Phase phase : all) {
@@ -2340,10 +2494,7 @@ namespace Opm {
         if (!skip && group.isProductionGroup()) {
             // Obtain rates for group.
             for (int phasePos = 0; phasePos < phase_usage_.num_phases; ++phasePos) {
-                const double local_current_rate = WellGroupHelpers::sumWellRates(
-                    group, schedule(), well_state_, reportStepIdx, phasePos, /* isInjector */ false);
-                // Sum over all processes
-                rates[phasePos] = -comm.sum(local_current_rate);
+                rates[phasePos] = -group_rates.surfaceRate(group.name(), phasePos, /* isInjector */ false);
             }
             // Check higher up only if under individual (not FLD) control.
             const Group::ProductionCMode& currentControl = well_state_.currentProductionGroupControl(group.name());
@@ -2373,7 +2524,7 @@ namespace Opm {
 
         // call recursively down the group hiearchy
         for (const std::string& groupName : group.groups()) {
-            checkGroupHigherConstraints( schedule().getGroup(groupName, reportStepIdx), deferred_logger, switched_groups);
+            checkGroupHigherConstraints( schedule().getGroup(groupName, reportStepIdx), group_rates, deferred_logger, switched_groups);
          }
     }
 
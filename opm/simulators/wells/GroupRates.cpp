@@ -0,0 +1,65 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/wells/GroupRates.hpp>
+#include <opm/simulators/wells/WellGroupHelpers.hpp>
+
+#include <initializer_list>
+
+namespace Opm
+{
+
+namespace WellGroupHelpers
+{
+
+    GroupRates::GroupRates(const GroupTree& tree, const WellStateFullyImplicitBlackoil& wellState, const PhaseUsage& pu)
+        : tree_(&tree)
+        , num_phases_(wellState.numPhases())
+    {
+        const int numGroups = tree.numGroups();
+        rates_.reserve(NumKinds * numGroups * num_phases_ + NumTotals * numGroups);
+        for (const auto& kind : {SurfaceProduction, SurfaceInjection, ReservoirProduction, ReservoirInjection}) {
+            const bool injector = (kind == SurfaceInjection || kind == ReservoirInjection);
+            const auto& wellRates = (kind == SurfaceProduction || kind == SurfaceInjection)
+                ? wellState.wellRates() : wellState.wellReservoirRates();
+            const auto groupRates = sumWellPhaseRatesAllGroups(wellRates, tree, wellState, injector);
+            rates_.insert(rates_.end(), groupRates.begin(), groupRates.end());
+        }
+
+        // The local totals, added in the order of the constraint checks.
+        auto addPhases = [&](const Kind kind, std::initializer_list<BlackoilPhases::PhaseIndex> phases) {
+            for (int g = 0; g < numGroups; ++g) {
+                double rate = 0.0;
+                for (const auto phase : phases) {
+                    if (pu.phase_used[phase]) {
+                        rate += rates_[(kind * numGroups + g) * num_phases_ + pu.phase_pos[phase]];
+                    }
+                }
+                rates_.push_back(rate);
+            }
+        };
+        addPhases(SurfaceProduction, {BlackoilPhases::Liquid, BlackoilPhases::Aqua});
+        addPhases(ReservoirProduction, {BlackoilPhases::Aqua, BlackoilPhases::Liquid, BlackoilPhases::Vapour});
+        addPhases(ReservoirInjection, {BlackoilPhases::Aqua, BlackoilPhases::Liquid, BlackoilPhases::Vapour});
+    }
+
+} // namespace WellGroupHelpers
+
+} // namespace Opm
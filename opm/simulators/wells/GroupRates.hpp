@@ -0,0 +1,119 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPM_GROUPRATES_HEADER_INCLUDED
+#define OPM_GROUPRATES_HEADER_INCLUDED
+
+#include <opm/core/props/BlackoilPhases.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
+#include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+namespace WellGroupHelpers
+{
+
+    /// The surface and reservoir rates of all groups of a group tree,
+    /// summed over all processes.
+    ///
+    /// The local rates of every group, phase and well type are
+    /// collected in one vector which is summed in a single collective
+    /// call. The group constraint checks can then look up any group
+    /// rate without further communication. The values are those of
+    /// sumWellRates() and sumWellResRates() followed by comm.sum().
+    /// The liquid and total reservoir rates are added up on every
+    /// process before the sum over the processes, like the constraint
+    /// checks did, so they are rounded the same way.
+    class GroupRates
+    {
+    public:
+        GroupRates() = default;
+
+        /// Compute the rates of the given well state. This is a
+        /// collective call.
+        template <class Comm>
+        GroupRates(const GroupTree& tree,
+                   const WellStateFullyImplicitBlackoil& wellState,
+                   const PhaseUsage& pu,
+                   const Comm& comm)
+            : GroupRates(tree, wellState, pu)
+        {
+            comm.sum(rates_.data(), rates_.size());
+        }
+
+        double surfaceRate(const std::string& group, const int phasePos, const bool injector) const
+        {
+            return rate(group, phasePos, injector ? SurfaceInjection : SurfaceProduction);
+        }
+
+        double reservoirRate(const std::string& group, const int phasePos, const bool injector) const
+        {
+            return rate(group, phasePos, injector ? ReservoirInjection : ReservoirProduction);
+        }
+
+        /// The produced oil and water surface rate (LRAT).
+        double liquidRate(const std::string& group) const
+        {
+            return total(group, LiquidProduction);
+        }
+
+        /// The sum of the reservoir rates of all phases (RESV, VREP).
+        double totalReservoirRate(const std::string& group, const bool injector) const
+        {
+            return total(group, injector ? TotalReservoirInjection : TotalReservoirProduction);
+        }
+
+    private:
+        enum Kind { SurfaceProduction, SurfaceInjection, ReservoirProduction, ReservoirInjection, NumKinds };
+        // the totals of all phases are stored after the phase rates
+        enum Total { LiquidProduction, TotalReservoirProduction, TotalReservoirInjection, NumTotals };
+
+        /// The local rates.
+        GroupRates(const GroupTree& tree, const WellStateFullyImplicitBlackoil& wellState, const PhaseUsage& pu);
+
+        double rate(const std::string& group, const int phasePos, const Kind kind) const
+        {
+            const int g = tree_->groupIndex(group);
+            assert(g >= 0);
+            return rates_[(kind * tree_->numGroups() + g) * num_phases_ + phasePos];
+        }
+
+        double total(const std::string& group, const Total total) const
+        {
+            const int g = tree_->groupIndex(group);
+            assert(g >= 0);
+            return rates_[NumKinds * tree_->numGroups() * num_phases_ + total * tree_->numGroups() + g];
+        }
+
+        const GroupTree* tree_ = nullptr;
+        int num_phases_ = 0;
+        std::vector<double> rates_;
+    };
+
+} // namespace WellGroupHelpers
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,125 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/wells/GroupTree.hpp>
+
+namespace Opm
+{
+
+namespace WellGroupHelpers
+{
+
+    GroupTree::GroupTree()
+        : report_step_(-1)
+    {
+    }
+
+    GroupTree::GroupTree(const Schedule& schedule,
+                         const int reportStepIdx,
+                         const WellStateFullyImplicitBlackoil& wellState)
+        : report_step_(reportStepIdx)
+    {
+        std::vector<std::vector<int>> childGroups;
+        std::vector<std::vector<int>> childWells;
+        addGroup(schedule, reportStepIdx, "FIELD", -1, childGroups, childWells);
+
+        // Flatten the child lists.
+        const int ng = groups_.size();
+        child_group_start_.assign(1, 0);
+        child_well_start_.assign(1, 0);
+        for (int g = 0; g < ng; ++g) {
+            child_groups_.insert(child_groups_.end(), childGroups[g].begin(), childGroups[g].end());
+            child_wells_.insert(child_wells_.end(), childWells[g].begin(), childWells[g].end());
+            child_group_start_.push_back(child_groups_.size());
+            child_well_start_.push_back(child_wells_.size());
+        }
+
+        // Groups are numbered in preorder, hence reversing the
+        // numbering puts every group after its subgroups.
+        bottom_up_order_.resize(ng);
+        for (int g = 0; g < ng; ++g) {
+            bottom_up_order_[g] = ng - 1 - g;
+        }
+
+        // Paths from the wells up to FIELD and the well state indices.
+        const auto& wellMap = wellState.wellMap();
+        group_path_start_.assign(1, 0);
+        for (auto& well : wells_) {
+            for (int g = well.group; g >= 0; g = groups_[g].parent) {
+                group_paths_.push_back(g);
+            }
+            group_path_start_.push_back(group_paths_.size());
+
+            const auto it = wellMap.find(well.name);
+            well.well_state_index = (it == wellMap.end()) ? -1 : it->second[0];
+        }
+    }
+
+    int GroupTree::groupIndex(const std::string& name) const
+    {
+        const auto it = group_index_.find(name);
+        return (it == group_index_.end()) ? -1 : it->second;
+    }
+
+    int GroupTree::wellIndex(const std::string& name) const
+    {
+        const auto it = well_index_.find(name);
+        return (it == well_index_.end()) ? -1 : it->second;
+    }
+
+    void GroupTree::addGroup(const Schedule& schedule,
+                             const int reportStepIdx,
+                             const std::string& name,
+                             const int parent,
+                             std::vector<std::vector<int>>& childGroups,
+                             std::vector<std::vector<int>>& childWells)
+    {
+        const Group& group = schedule.getGroup(name, reportStepIdx);
+        const int g = groups_.size();
+        groups_.push_back({name, parent, group.getGroupEfficiencyFactor()});
+        group_index_[name] = g;
+        childGroups.emplace_back();
+        childWells.emplace_back();
+        if (parent >= 0) {
+            childGroups[parent].push_back(g);
+        }
+
+        for (const std::string& wellName : group.wells()) {
+            const auto& wellEcl = schedule.getWell(wellName, reportStepIdx);
+            const int w = wells_.size();
+            wells_.push_back({wellName,
+                              g,
+                              wellEcl.getEfficiencyFactor(),
+                              wellEcl.isProducer(),
+                              wellEcl.isInjector(),
+                              wellEcl.getStatus() == Well::Status::SHUT,
+                              -1});
+            well_index_[wellName] = w;
+            childWells[g].push_back(w);
+        }
+
+        for (const std::string& groupName : group.groups()) {
+            addGroup(schedule, reportStepIdx, groupName, g, childGroups, childWells);
+        }
+    }
+
+} // namespace WellGroupHelpers
+
+} // namespace Opm
@@ -0,0 +1,156 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPM_GROUPTREE_HEADER_INCLUDED
+#define OPM_GROUPTREE_HEADER_INCLUDED
+
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm
+{
+
+namespace WellGroupHelpers
+{
+
+    /// The group hierarchy of one report step with integer indices.
+    ///
+    /// Groups and wells are numbered in the order of a depth-first
+    /// traversal starting at FIELD, which has index 0. The children of
+    /// each group are stored in flat arrays, and for each well the
+    /// chain of groups from its own group up to FIELD is precomputed.
+    /// This avoids resolving children by name through the Schedule in
+    /// functions that are called many times per Newton iteration.
+    class GroupTree
+    {
+    public:
+        /// A contiguous range of indices.
+        class IndexRange
+        {
+        public:
+            IndexRange(const int* b, const int* e) : begin_(b), end_(e) {}
+            const int* begin() const { return begin_; }
+            const int* end() const { return end_; }
+            std::size_t size() const { return end_ - begin_; }
+        private:
+            const int* begin_;
+            const int* end_;
+        };
+
+        struct GroupNode
+        {
+            std::string name;
+            int parent;
+            double efficiency_factor;
+        };
+
+        struct WellNode
+        {
+            std::string name;
+            int group;
+            double efficiency_factor;
+            bool is_producer;
+            bool is_injector;
+            bool is_shut;
+            /// Index in the well map of the well state, -1 if the well
+            /// is not present on this process.
+            int well_state_index;
+        };
+
+        GroupTree();
+
+        /// Build the tree for the given report step.
+        ///
+        /// The well state indices are taken from the well map of
+        /// wellState, the tree can therefore be used with all well
+        /// states of the report step sharing that well map.
+        GroupTree(const Schedule& schedule,
+                  const int reportStepIdx,
+                  const WellStateFullyImplicitBlackoil& wellState);
+
+        int reportStep() const { return report_step_; }
+        bool empty() const { return groups_.empty(); }
+
+        int numGroups() const { return groups_.size(); }
+        int numWells() const { return wells_.size(); }
+
+        /// Index of a group, -1 if there is no group with that name.
+        int groupIndex(const std::string& name) const;
+        /// Index of a well, -1 if there is no well with that name.
+        int wellIndex(const std::string& name) const;
+
+        const GroupNode& group(const int g) const { return groups_[g]; }
+        const WellNode& well(const int w) const { return wells_[w]; }
+
+        IndexRange childGroups(const int g) const
+        {
+            return range(child_groups_, child_group_start_, g);
+        }
+
+        IndexRange childWells(const int g) const
+        {
+            return range(child_wells_, child_well_start_, g);
+        }
+
+        /// The groups from the group of well w up to and including FIELD.
+        IndexRange groupPath(const int w) const
+        {
+            return range(group_paths_, group_path_start_, w);
+        }
+
+        /// All groups ordered such that every group comes after its subgroups.
+        const std::vector<int>& bottomUpOrder() const { return bottom_up_order_; }
+
+    private:
+        static IndexRange range(const std::vector<int>& values, const std::vector<int>& start, const int i)
+        {
+            return IndexRange(values.data() + start[i], values.data() + start[i + 1]);
+        }
+
+        void addGroup(const Schedule& schedule,
+                      const int reportStepIdx,
+                      const std::string& name,
+                      const int parent,
+                      std::vector<std::vector<int>>& childGroups,
+                      std::vector<std::vector<int>>& childWells);
+
+        int report_step_;
+        std::vector<GroupNode> groups_;
+        std::vector<WellNode> wells_;
+        std::unordered_map<std::string, int> group_index_;
+        std::unordered_map<std::string, int> well_index_;
+        std::vector<int> child_group_start_;
+        std::vector<int> child_groups_;
+        std::vector<int> child_well_start_;
+        std::vector<int> child_wells_;
+        std::vector<int> group_path_start_;
+        std::vector<int> group_paths_;
+        std::vector<int> bottom_up_order_;
+    };
+
+} // namespace WellGroupHelpers
+
+} // namespace Opm
+
+#endif
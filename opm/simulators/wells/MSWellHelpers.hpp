@@ -30,12 +30,259 @@
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
 #endif // HAVE_UMFPACK
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <stdexcept>
+#include <vector>
 
 namespace Opm {
 
 namespace mswellhelpers
 {
+    // Direct solver for the well matrix D which keeps its UMFPACK factorization
+    // between the solves. The symbolic analysis is only redone when the sparsity
+    // pattern of D changes (i.e. the segment topology changes), while the numeric
+    // factorization is redone every time factorize() is called, which should be
+    // once after each assembly of the well equations.
+    template <typename MatrixType, typename VectorType>
+    class WellMatrixFactorization
+    {
+    public:
+        static constexpr int blocksize = MatrixType::block_type::rows;
+
+        WellMatrixFactorization() = default;
+
+        // The UMFPACK objects are not copied, the copy will redo the
+        // factorization from the stored values when it is first used.
+        WellMatrixFactorization(const WellMatrixFactorization& other)
+            : block_row_start_(other.block_row_start_)
+            , block_cols_(other.block_cols_)
+            , col_start_(other.col_start_)
+            , row_index_(other.row_index_)
+            , value_pos_(other.value_pos_)
+            , values_(other.values_)
+        {
+        }
+
+        WellMatrixFactorization& operator=(const WellMatrixFactorization& other)
+        {
+            if (this != &other) {
+                freeFactors();
+                block_row_start_ = other.block_row_start_;
+                block_cols_ = other.block_cols_;
+                col_start_ = other.col_start_;
+                row_index_ = other.row_index_;
+                value_pos_ = other.value_pos_;
+                values_ = other.values_;
+            }
+            return *this;
+        }
+
+        ~WellMatrixFactorization()
+        {
+            freeFactors();
+        }
+
+        // compute the factorization of D, reusing the symbolic analysis when possible
+        void factorize(const MatrixType& D)
+        {
+            if (!samePattern(D)) {
+                freeFactors();
+                setupPattern(D);
+            }
+
+            std::size_t k = 0;
+            for (auto row = D.begin(); row != D.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    for (int i = 0; i < blocksize; ++i) {
+                        for (int j = 0; j < blocksize; ++j) {
+                            values_[value_pos_[k++]] = (*col)[i][j];
+                        }
+                    }
+                }
+            }
+
+            numericFactorization();
+        }
+
+        bool isFactorized() const
+        {
+            return !values_.empty();
+        }
+
+        // obtain y = D^-1 * x with the stored factorization
+        VectorType solve(const VectorType& x) const
+        {
+#if HAVE_UMFPACK
+            if (values_.empty()) {
+                OPM_THROW(std::logic_error, "The well matrix has to be factorized before solving with it");
+            }
+            if (numeric_ == nullptr) {
+                numericFactorization();
+            }
+
+            VectorType y(x.size());
+            y = 0.;
+
+            umfpack_di_solve(UMFPACK_A, col_start_.data(), row_index_.data(), values_.data(),
+                             reinterpret_cast<double*>(&y[0]), reinterpret_cast<const double*>(&x[0]),
+                             numeric_, nullptr, nullptr);
+
+            // Checking if there is any inf or nan in y
+            // it will be the solution before we find a way to catch the singularity of the matrix
+            for (size_t i_block = 0; i_block < y.size(); ++i_block) {
+                for (size_t i_elem = 0; i_elem < y[i_block].size(); ++i_elem) {
+                    if (std::isinf(y[i_block][i_elem]) || std::isnan(y[i_block][i_elem]) ) {
+                        OPM_THROW(Opm::NumericalIssue, "nan or inf value found in WellMatrixFactorization::solve() due to singular matrix");
+                    }
+                }
+            }
+
+            return y;
+#else
+            static_cast<void>(x);
+            OPM_THROW(std::runtime_error, "Cannot use WellMatrixFactorization without UMFPACK. "
+                      "Reconfigure opm-simulator with SuiteSparse/UMFPACK support and recompile.");
+#endif // HAVE_UMFPACK
+        }
+
+    private:
+        // block sparsity pattern of the factorized matrix
+        std::vector<int> block_row_start_;
+        std::vector<int> block_cols_;
+
+        // the scalar matrix in compressed column format
+        std::vector<int> col_start_;
+        std::vector<int> row_index_;
+        // position in values_ of each scalar entry, in the row-wise order of the block matrix
+        std::vector<int> value_pos_;
+        mutable std::vector<double> values_;
+
+        mutable void* symbolic_ = nullptr;
+        mutable void* numeric_ = nullptr;
+
+        bool samePattern(const MatrixType& D) const
+        {
+            if (block_row_start_.size() != D.N() + 1 || block_cols_.size() != D.nonzeroes()) {
+                return false;
+            }
+            std::size_t k = 0;
+            for (auto row = D.begin(); row != D.end(); ++row) {
+                if (block_row_start_[row.index()] != static_cast<int>(k)) {
+                    return false;
+                }
+                for (auto col = row->begin(); col != row->end(); ++col, ++k) {
+                    if (block_cols_[k] != static_cast<int>(col.index())) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        void setupPattern(const MatrixType& D)
+        {
+            const int num_block_rows = D.N();
+            const int n = num_block_rows * blocksize;
+
+            block_row_start_.assign(1, 0);
+            block_cols_.clear();
+            block_row_start_.reserve(num_block_rows + 1);
+            block_cols_.reserve(D.nonzeroes());
+            std::vector<int> col_count(n, 0);
+            for (auto row = D.begin(); row != D.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    block_cols_.push_back(col.index());
+                    for (int j = 0; j < blocksize; ++j) {
+                        col_count[col.index() * blocksize + j] += blocksize;
+                    }
+                }
+                block_row_start_.push_back(block_cols_.size());
+            }
+
+            col_start_.assign(n + 1, 0);
+            for (int c = 0; c < n; ++c) {
+                col_start_[c + 1] = col_start_[c] + col_count[c];
+            }
+
+            // the rows are visited in increasing order, which gives sorted row indices within each column
+            std::vector<int> next(col_start_.begin(), col_start_.end() - 1);
+            row_index_.resize(col_start_[n]);
+            value_pos_.clear();
+            value_pos_.reserve(col_start_[n]);
+            for (auto row = D.begin(); row != D.end(); ++row) {
+                for (int i = 0; i < blocksize; ++i) {
+                    for (auto col = row->begin(); col != row->end(); ++col) {
+                        for (int j = 0; j < blocksize; ++j) {
+                            const int pos = next[col.index() * blocksize + j]++;
+                            row_index_[pos] = row.index() * blocksize + i;
+                        }
+                    }
+                }
+            }
+            // value_pos_ follows the order in which factorize() reads the blocks
+            for (auto row = D.begin(); row != D.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    for (int i = 0; i < blocksize; ++i) {
+                        for (int j = 0; j < blocksize; ++j) {
+                            const int c = col.index() * blocksize + j;
+                            value_pos_.push_back(findEntry(c, row.index() * blocksize + i));
+                        }
+                    }
+                }
+            }
+            values_.assign(col_start_[n], 0.0);
+        }
+
+        int findEntry(const int col, const int row) const
+        {
+            const auto begin = row_index_.begin() + col_start_[col];
+            const auto end = row_index_.begin() + col_start_[col + 1];
+            const auto it = std::lower_bound(begin, end, row);
+            assert(it != end && *it == row);
+            return it - row_index_.begin();
+        }
+
+        void numericFactorization() const
+        {
+#if HAVE_UMFPACK
+            const int n = col_start_.size() - 1;
+            if (symbolic_ == nullptr) {
+                const int status = umfpack_di_symbolic(n, n, col_start_.data(), row_index_.data(), values_.data(),
+                                                       &symbolic_, nullptr, nullptr);
+                if (status != UMFPACK_OK) {
+                    OPM_THROW(Opm::NumericalIssue, "Symbolic factorization of the well matrix failed with UMFPACK status " << status);
+                }
+            }
+            if (numeric_ != nullptr) {
+                umfpack_di_free_numeric(&numeric_);
+            }
+            // a singular matrix is only a warning here, it will be caught by the check in solve()
+            const int status = umfpack_di_numeric(col_start_.data(), row_index_.data(), values_.data(),
+                                                  symbolic_, &numeric_, nullptr, nullptr);
+            if (status < UMFPACK_OK) {
+                OPM_THROW(Opm::NumericalIssue, "Numeric factorization of the well matrix failed with UMFPACK status " << status);
+            }
+#endif // HAVE_UMFPACK
+        }
+
+        void freeFactors()
+        {
+#if HAVE_UMFPACK
+            if (numeric_ != nullptr) {
+                umfpack_di_free_numeric(&numeric_);
+            }
+            if (symbolic_ != nullptr) {
+                umfpack_di_free_symbolic(&symbolic_);
+            }
+#endif // HAVE_UMFPACK
+            numeric_ = nullptr;
+            symbolic_ = nullptr;
+        }
+    };
+
+
     // obtain y = D^-1 * x with a direct solver
     template <typename MatrixType, typename VectorType>
     VectorType
@@ -24,6 +24,7 @@
 
 
 #include <opm/simulators/wells/WellInterface.hpp>
+#include <opm/simulators/wells/MSWellHelpers.hpp>
 
 namespace Opm
 {
@@ -135,10 +136,8 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA
         /// add the contribution (C, D, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
-#endif
 
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
@@ -183,6 +182,7 @@ namespace Opm
         // protected member variables from the Base class
         using Base::well_ecl_;
         using Base::vfp_properties_;
+        using Base::vfp_prod_slice_;
         using Base::ref_depth_;
         using Base::number_of_perforations_; // TODO: can use well_ecl_?
         using Base::current_step_;
@@ -236,6 +236,8 @@ namespace Opm
         mutable OffDiagMatWell duneC_;
         // diagonal matrix for the well
         mutable DiagMatWell duneD_;
+        // factorization of duneD_, updated after each assembly of the well equations
+        mutable mswellhelpers::WellMatrixFactorization<DiagMatWell, BVectorWell> duneDSolver_;
 
         // residuals of the well equations
         mutable BVectorWell resWell_;
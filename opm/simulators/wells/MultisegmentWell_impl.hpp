@@ -621,7 +621,7 @@ namespace Opm
         duneB_.mv(x, Bx);
 
         // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::invDXDirect(duneD_, Bx);
+        const BVectorWell invDBx = duneDSolver_.solve(Bx);
 
         // Ax = Ax - duneC_^T * invDBx
         duneC_.mmtv(invDBx,Ax);
@@ -637,19 +637,19 @@ namespace Opm
     apply(BVector& r) const
     {
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::invDXDirect(duneD_, resWell_);
+        const BVectorWell invDrw = duneDSolver_.solve(resWell_);
         // r = r - duneC_^T * invDrw
         duneC_.mmtv(invDrw, r);
     }
 
 
 
-#if HAVE_CUDA
     template<typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
     addWellContribution(WellContributions& wellContribs) const
     {
+#if HAVE_UMFPACK
         unsigned int Nb = duneB_.M();       // number of blockrows in matrix A
         unsigned int Mb = duneB_.N();       // number of blockrows in duneB_, duneC_ and duneD_
         unsigned int BnumBlocks = duneB_.nonzeroes();
@@ -702,8 +702,10 @@ namespace Opm
         }
 
         wellContribs.addMultisegmentWellContribution(numEq, numWellEq, Nb, Mb, BnumBlocks, Bvals, Bcols, Brows, DnumBlocks, Dvals, Dcols, Drows, Cvals);
+#else
+        OPM_THROW(std::runtime_error, "Cannot add the contribution of multisegment well " << name() << " without UMFPACK");
+#endif // HAVE_UMFPACK
     }
-#endif
 
 
     template <typename TypeTag>
@@ -995,7 +997,7 @@ namespace Opm
         // resWell = resWell - B * x
         duneB_.mmv(x, resWell);
         // xw = D^-1 * resWell
-        xw = mswellhelpers::invDXDirect(duneD_, resWell);
+        xw = duneDSolver_.solve(resWell);
     }
 
 
@@ -1009,7 +1011,7 @@ namespace Opm
     {
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::invDXDirect(duneD_, resWell_);
+        const BVectorWell dx_well = duneDSolver_.solve(resWell_);
 
         updateWellState(dx_well, well_state, deferred_logger);
     }
@@ -1989,7 +1991,7 @@ namespace Opm
             const double vfp_ref_depth = vfp_properties_->getProd()->getTable(table_id)->getDatumDepth();
             const double dp = wellhelpers::computeHydrostaticCorrection(ref_depth_, vfp_ref_depth, rho, gravity_);
 
-            thp = vfp_properties_->getProd()->thp(table_id, aqua, liquid, vapour, bhp + dp, alq);
+            thp = vfp_properties_->getProd()->thp(table_id, aqua, liquid, vapour, bhp + dp, alq, vfp_prod_slice_);
         }
         else {
             OPM_DEFLOG_THROW(std::logic_error, "Expected INJECTOR or PRODUCER well", deferred_logger);
@@ -2035,7 +2037,7 @@ namespace Opm
              const auto& controls = well.productionControls(summaryState);
              const double vfp_ref_depth = vfp_properties_->getProd()->getTable(controls.vfp_table_number)->getDatumDepth();
              const double dp = wellhelpers::computeHydrostaticCorrection(ref_depth_, vfp_ref_depth, rho, gravity_);
-             return vfp_properties_->getProd()->bhp(controls.vfp_table_number, aqua, liquid, vapour, controls.thp_limit, controls.alq_value) - dp;
+             return vfp_properties_->getProd()->bhp(controls.vfp_table_number, aqua, liquid, vapour, controls.thp_limit, controls.alq_value, vfp_prod_slice_) - dp;
          }
          else {
              OPM_DEFLOG_THROW(std::logic_error, "Expected INJECTOR or PRODUCER well", deferred_logger);
@@ -2382,7 +2384,7 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, deferred_logger);
 
-            const BVectorWell dx_well = mswellhelpers::invDXDirect(duneD_, resWell_);
+            const BVectorWell dx_well = duneDSolver_.solve(resWell_);
 
             if (it > param_.strict_inner_iter_ms_wells_)
                 relax_convergence = true;
@@ -2633,6 +2635,9 @@ namespace Opm
                                              well_state.segPressDropFriction()[seg] +
                                              well_state.segPressDropAcceleration()[seg];
         }
+
+        // the factorization is reused until the next assembly of the well equations
+        duneDSolver_.factorize(duneD_);
     }
 
 
@@ -3260,7 +3265,7 @@ namespace Opm
         auto fbhp = [this, &controls, dp](const std::vector<double>& rates) {
             assert(rates.size() == 3);
             return this->vfp_properties_->getProd()
-            ->bhp(controls.vfp_table_number, rates[Water], rates[Oil], rates[Gas], controls.thp_limit, controls.alq_value) - dp;
+            ->bhp(controls.vfp_table_number, rates[Water], rates[Oil], rates[Gas], controls.thp_limit, controls.alq_value, vfp_prod_slice_) - dp;
         };
 
         // Make the flo() function.
@@ -25,6 +25,7 @@
 #include <opm/core/props/BlackoilPhases.hpp>
 #include <opm/grid/utility/RegionMapping.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
+#include <opm/simulators/utils/RegionAggregator.hpp>
 
 #include <dune/grid/common/gridenums.hh>
 #include <algorithm>
@@ -433,93 +434,62 @@ namespace Opm {
             void defineState(const EbosSimulator& simulator)
             {
 
-                // create map from cell to region
-                // and set all attributes to zero
+                // create map from cell to the position of its region
+                // among the active regions
                 const auto& grid = simulator.vanguard().grid();
                 const unsigned numCells = grid.size(/*codim=*/0);
                 std::vector<int> cell2region(numCells, -1);
+                std::vector<RegionId> regions;
                 for (const auto& reg : rmap_.activeRegions()) {
                     for (const auto& cell : rmap_.cells(reg)) {
-                        cell2region[cell] = reg;
+                        cell2region[cell] = regions.size();
                     }
-                    auto& ra = attr_.attributes(reg);
-                    ra.pressure = 0.0;
-                    ra.temperature = 0.0;
-                    ra.rs = 0.0;
-                    ra.rv = 0.0;
-                    ra.pv = 0.0;
-
+                    regions.push_back(reg);
                 }
 
-                ElementContext elemCtx( simulator );
-                const auto& gridView = simulator.gridView();
-                const auto& comm = gridView.comm();
+                // sum p, rs, rv, T and the hydrocarbon pore volume of all
+                // regions in one sweep and one reduction.
+                enum { Pressure, Temperature, Rs, Rv, PoreVolume, NumFields };
+                RegionAggregator aggregator(NumFields);
+                aggregator.addRegionMap(std::move(cell2region), regions.size());
 
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
-                     elemIt != elemEndIt;
-                     ++elemIt)
+                const auto& pu = phaseUsage_;
+                const auto& model = simulator.model();
+                aggregator.template accumulateIntensiveQuantities<ElementContext>(simulator,
+                    [&pu, &model](unsigned cellIdx, const auto& intQuants, double* values)
                 {
-
-                    const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity)
-                        continue;
-
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
                     const auto& fs = intQuants.fluidState();
                     // use pore volume weighted averages.
                     const double pv_cell =
-                            simulator.model().dofTotalVolume(cellIdx)
+                            model.dofTotalVolume(cellIdx)
                             * intQuants.porosity().value();
 
                     // only count oil and gas filled parts of the domain
                     double hydrocarbon = 1.0;
-                    const auto& pu = phaseUsage_;
                     if (Details::PhaseUsed::water(pu)) {
                         hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
                     }
 
-                    int reg = cell2region[cellIdx];
-                    assert(reg >= 0);
-                    auto& ra = attr_.attributes(reg);
-                    auto& p  = ra.pressure;
-                    auto& T  = ra.temperature;
-                    auto& rs  = ra.rs;
-                    auto& rv  = ra.rv;
-                    auto& pv  = ra.pv;
-
-                    // sum p, rs, rv, and T.
+                    std::fill(values, values + NumFields, 0.0);
                     double hydrocarbonPV = pv_cell*hydrocarbon;
                     if (hydrocarbonPV > 0) {
-                        pv += hydrocarbonPV;
-                        p += fs.pressure(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
-                        rs += fs.Rs().value()*hydrocarbonPV;
-                        rv += fs.Rv().value()*hydrocarbonPV;
-                        T += fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+                        values[PoreVolume] = hydrocarbonPV;
+                        values[Pressure] = fs.pressure(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+                        values[Rs] = fs.Rs().value()*hydrocarbonPV;
+                        values[Rv] = fs.Rv().value()*hydrocarbonPV;
+                        values[Temperature] = fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
                     }
-                }
-
-                for (const auto& reg : rmap_.activeRegions()) {
-                      auto& ra = attr_.attributes(reg);
-                      auto& p  = ra.pressure;
-                      auto& T  = ra.temperature;
-                      auto& rs  = ra.rs;
-                      auto& rv  = ra.rv;
-                      auto& pv  = ra.pv;
-                      // communicate sums
-                      p = comm.sum(p);
-                      T = comm.sum(T);
-                      rs = comm.sum(rs);
-                      rv = comm.sum(rv);
-                      pv = comm.sum(pv);
-                      // compute average
-                      p /= pv;
-                      T /= pv;
-                      rs /= pv;
-                      rv /= pv;
+                });
+                aggregator.reduce(simulator.gridView().comm());
+
+                // compute average
+                for (std::size_t i = 0; i < regions.size(); ++i) {
+                    auto& ra = attr_.attributes(regions[i]);
+                    ra.pv = aggregator.sum(0, i, PoreVolume);
+                    ra.pressure = aggregator.sum(0, i, Pressure) / ra.pv;
+                    ra.temperature = aggregator.sum(0, i, Temperature) / ra.pv;
+                    ra.rs = aggregator.sum(0, i, Rs) / ra.pv;
+                    ra.rv = aggregator.sum(0, i, Rv) / ra.pv;
                 }
             }
 
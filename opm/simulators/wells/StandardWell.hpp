@@ -185,13 +185,11 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
-#if HAVE_CUDA
         /// add the contribution (C, D^-1, B matrices) of this Well to the WellContributions object
         void addWellContribution(WellContributions& wellContribs) const;
 
         /// get the number of blocks of the C and B matrices, used to allocate memory in a WellContributions object
         void getNumBlocks(unsigned int& _nnzs) const;
-#endif
 
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
@@ -241,6 +239,7 @@ namespace Opm
         using Base::current_step_;
         using Base::well_ecl_;
         using Base::vfp_properties_;
+        using Base::vfp_prod_slice_;
         using Base::gravity_;
         using Base::param_;
         using Base::well_efficiency_factor_;
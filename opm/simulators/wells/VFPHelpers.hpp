@@ -24,6 +24,7 @@
 #include <opm/common/OpmLog/OpmLog.hpp>
 
 #include <cmath>
+#include <vector>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPInjTable.hpp>
@@ -273,6 +274,41 @@ inline InterpData findInterpData(const double& value_in, const std::vector<doubl
 
 
 
+/**
+ * Helper function to update the interpolation factor of interp for a new value,
+ * provided findInterpData() would select the same segment for it.
+ *  @param value_in Value to find in values
+ *  @param values Sorted list of values to search for value in.
+ *  @param interp Data of a previous call of findInterpData() for values
+ *  @return False if the value lies in a different segment, interp is unchanged then.
+ */
+inline bool updateInterpData(const double& value_in, const std::vector<double>& values, InterpData& interp) {
+    const int nvalues = values.size();
+    if (nvalues == 1) {
+        return true;
+    }
+
+    const double value = value_in < 0.? 0. : value_in;
+
+    // The first and last segments are also used for extrapolation
+    const int lower = interp.ind_[0];
+    const int upper = interp.ind_[1];
+    if ((lower > 0 && value <= values[lower]) || (upper < nvalues-1 && value > values[upper])) {
+        return false;
+    }
+
+    interp.factor_ = (value - values[lower]) * interp.inv_dist_;
+    if (interp.factor_ > 3.0) {
+        interp.factor_ = 3.0;
+    }
+    return true;
+}
+
+
+
+
+
+
 /**
  * An "ADB-like" structure with a single value and a set of derivatives
  */
@@ -329,45 +365,18 @@ inline VFPEvaluation operator*(
 
 
 /**
- * Helper function which interpolates data using the indices etc. given in the inputs.
+ * Helper function which interpolates the values of the nearest neighbours nn,
+ * indexed as [thp][wfr][gfr][alq][flo], using the factors given in the inputs.
+ * Overwrites nn.
  */
 inline VFPEvaluation interpolate(
-        const VFPProdTable& table,
+        VFPEvaluation (&nn)[2][2][2][2][2],
         const InterpData& flo_i,
         const InterpData& thp_i,
         const InterpData& wfr_i,
         const InterpData& gfr_i,
         const InterpData& alq_i) {
 
-    //Values and derivatives in a 5D hypercube
-    VFPEvaluation nn[2][2][2][2][2];
-
-
-    //Pick out nearest neighbors (nn) to our evaluation point
-    //This is not really required, but performance-wise it may pay off, since the 32-elements
-    //we copy to (nn) will fit better in cache than the full original table for the
-    //interpolation below.
-    //The following ladder of for loops will presumably be unrolled by a reasonable compiler.
-    for (int t=0; t<=1; ++t) {
-        for (int w=0; w<=1; ++w) {
-            for (int g=0; g<=1; ++g) {
-                for (int a=0; a<=1; ++a) {
-                    for (int f=0; f<=1; ++f) {
-                        //Shorthands for indexing
-                        const int ti = thp_i.ind_[t];
-                        const int wi = wfr_i.ind_[w];
-                        const int gi = gfr_i.ind_[g];
-                        const int ai = alq_i.ind_[a];
-                        const int fi = flo_i.ind_[f];
-
-                        //Copy element
-                        nn[t][w][g][a][f].value = table(ti,wi,gi,ai,fi);
-                    }
-                }
-            }
-        }
-    }
-
     //Calculate derivatives
     //Note that the derivative of the two end points of a line aligned with the
     //"axis of the derivative" are equal
@@ -444,6 +453,156 @@ inline VFPEvaluation interpolate(
 
 
 
+/**
+ * Helper function which interpolates data using the indices etc. given in the inputs.
+ */
+inline VFPEvaluation interpolate(
+        const VFPProdTable& table,
+        const InterpData& flo_i,
+        const InterpData& thp_i,
+        const InterpData& wfr_i,
+        const InterpData& gfr_i,
+        const InterpData& alq_i) {
+
+    //Values and derivatives in a 5D hypercube
+    VFPEvaluation nn[2][2][2][2][2];
+
+
+    //Pick out nearest neighbors (nn) to our evaluation point
+    //This is not really required, but performance-wise it may pay off, since the 32-elements
+    //we copy to (nn) will fit better in cache than the full original table for the
+    //interpolation below.
+    //The following ladder of for loops will presumably be unrolled by a reasonable compiler.
+    for (int t=0; t<=1; ++t) {
+        for (int w=0; w<=1; ++w) {
+            for (int g=0; g<=1; ++g) {
+                for (int a=0; a<=1; ++a) {
+                    for (int f=0; f<=1; ++f) {
+                        //Shorthands for indexing
+                        const int ti = thp_i.ind_[t];
+                        const int wi = wfr_i.ind_[w];
+                        const int gi = gfr_i.ind_[g];
+                        const int ai = alq_i.ind_[a];
+                        const int fi = flo_i.ind_[f];
+
+                        //Copy element
+                        nn[t][w][g][a][f].value = table(ti,wi,gi,ai,fi);
+                    }
+                }
+            }
+        }
+    }
+
+    return interpolate(nn, flo_i, thp_i, wfr_i, gfr_i, alq_i);
+}
+
+
+
+
+
+/**
+ * The values of a production table for all THP and FLO values in the cell
+ * of the WFR, GFR and ALQ axes containing given fractions and artificial
+ * lift. The values of a cell are stored contiguously such that lookups with
+ * fractions and lift inside the cell only search the THP and FLO axes. The
+ * slice is rebuilt when they leave the cell or another table is used.
+ *
+ * The results are identical to those of interpolate(VFPProdTable, ...).
+ * A slice is meant to be owned by a single well and is not thread safe.
+ */
+class VFPProdSlice {
+public:
+    /**
+     * Interpolates the table, see interpolate(VFPProdTable, ...).
+     * @param flo Rate, positive for producers as in the table
+     */
+    VFPEvaluation interpolate(const VFPProdTable& table,
+                              const double& flo,
+                              const double& thp,
+                              const double& wfr,
+                              const double& gfr,
+                              const double& alq) {
+        if (!contains(table, wfr, gfr, alq)) {
+            rebuild(table, wfr, gfr, alq);
+        }
+
+        const auto flo_i = findInterpData(flo, table.getFloAxis());
+        const auto thp_i = findInterpData(thp, table.getTHPAxis());
+
+        VFPEvaluation nn[2][2][2][2][2];
+        for (int t=0; t<=1; ++t) {
+            for (int f=0; f<=1; ++f) {
+                const double* cell = &values_[(thp_i.ind_[t]*num_flo_ + flo_i.ind_[f]) * 8];
+                for (int w=0; w<=1; ++w) {
+                    for (int g=0; g<=1; ++g) {
+                        for (int a=0; a<=1; ++a) {
+                            nn[t][w][g][a][f].value = cell[4*w + 2*g + a];
+                        }
+                    }
+                }
+            }
+        }
+
+        return detail::interpolate(nn, flo_i, thp_i, wfr_i_, gfr_i_, alq_i_);
+    }
+
+    /**
+     * Forget the cached values.
+     */
+    void clear() {
+        table_ = nullptr;
+        values_.clear();
+    }
+
+private:
+    bool contains(const VFPProdTable& table,
+                  const double& wfr,
+                  const double& gfr,
+                  const double& alq) {
+        return &table == table_
+            && updateInterpData(wfr, table.getWFRAxis(), wfr_i_)
+            && updateInterpData(gfr, table.getGFRAxis(), gfr_i_)
+            && updateInterpData(alq, table.getALQAxis(), alq_i_);
+    }
+
+    void rebuild(const VFPProdTable& table,
+                 const double& wfr,
+                 const double& gfr,
+                 const double& alq) {
+        table_ = &table;
+        wfr_i_ = findInterpData(wfr, table.getWFRAxis());
+        gfr_i_ = findInterpData(gfr, table.getGFRAxis());
+        alq_i_ = findInterpData(alq, table.getALQAxis());
+
+        const int num_thp = table.getTHPAxis().size();
+        num_flo_ = table.getFloAxis().size();
+        values_.resize(num_thp * num_flo_ * 8);
+        for (int ti=0; ti<num_thp; ++ti) {
+            for (int fi=0; fi<num_flo_; ++fi) {
+                double* cell = &values_[(ti*num_flo_ + fi) * 8];
+                for (int w=0; w<=1; ++w) {
+                    for (int g=0; g<=1; ++g) {
+                        for (int a=0; a<=1; ++a) {
+                            cell[4*w + 2*g + a] = table(ti, wfr_i_.ind_[w], gfr_i_.ind_[g], alq_i_.ind_[a], fi);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    const VFPProdTable* table_ = nullptr;
+    InterpData wfr_i_;
+    InterpData gfr_i_;
+    InterpData alq_i_;
+    int num_flo_ = 0;
+    std::vector<double> values_;
+};
+
+
+
+
+
 /**
  * This basically models interpolate(VFPProdTable::array_type, ...)
  * which performs 5D interpolation, but here for the 2D case only
@@ -111,6 +111,56 @@ double VFPProdProperties::bhp(int table_id,
 }
 
 
+double VFPProdProperties::thp(int table_id,
+                              const double& aqua,
+                              const double& liquid,
+                              const double& vapour,
+                              const double& bhp_arg,
+                              const double& alq,
+                              detail::VFPProdSlice& slice) const {
+    const VFPProdTable* table = detail::getTable(m_tables, table_id);
+
+    // Find interpolation variables, see thp() above.
+    double flo = 0.0;
+    double wfr = 0.0;
+    double gfr = 0.0;
+    if (aqua == 0.0 && liquid == 0.0 && vapour == 0.0) {
+        flo = table->getFloAxis().front();
+    } else {
+        flo = -detail::getFlo(aqua, liquid, vapour, table->getFloType());
+        wfr = detail::getWFR(aqua, liquid, vapour, table->getWFRType());
+        gfr = detail::getGFR(aqua, liquid, vapour, table->getGFRType());
+    }
+
+    const std::vector<double>& thp_array = table->getTHPAxis();
+    const int nthp = thp_array.size();
+    std::vector<double> bhp_array(nthp);
+    for (int i=0; i<nthp; ++i) {
+        bhp_array[i] = slice.interpolate(*table, flo, thp_array[i], wfr, gfr, alq).value;
+    }
+
+    return detail::findTHP(bhp_array, thp_array, bhp_arg);
+}
+
+
+double VFPProdProperties::bhp(int table_id,
+                              const double& aqua,
+                              const double& liquid,
+                              const double& vapour,
+                              const double& thp_arg,
+                              const double& alq,
+                              detail::VFPProdSlice& slice) const {
+    const VFPProdTable* table = detail::getTable(m_tables, table_id);
+
+    // Recall that production rate is negative in Opm, so switch the sign.
+    const double flo = -detail::getFlo(aqua, liquid, vapour, table->getFloType());
+    const double wfr = detail::getWFR(aqua, liquid, vapour, table->getWFRType());
+    const double gfr = detail::getGFR(aqua, liquid, vapour, table->getGFRType());
+
+    return slice.interpolate(*table, flo, thp_arg, wfr, gfr, alq).value;
+}
+
+
 const VFPProdTable* VFPProdProperties::getTable(const int table_id) const {
     return detail::getTable(m_tables, table_id);
 }
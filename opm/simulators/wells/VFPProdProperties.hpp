@@ -113,6 +113,37 @@ public:
         return bhp;
     }
 
+    /**
+     * Linear interpolation of bhp as above, using and updating a slice of
+     * the table cached by the caller for repeated evaluations with similar
+     * fractions, e.g., the slice of a well.
+     * @param slice Cached values of the table, see detail::VFPProdSlice
+     */
+    template <class EvalWell>
+    EvalWell bhp(const int table_id,
+                 const EvalWell& aqua,
+                 const EvalWell& liquid,
+                 const EvalWell& vapour,
+                 const double& thp,
+                 const double& alq,
+                 detail::VFPProdSlice& slice) const {
+
+        //Get the table
+        const VFPProdTable* table = detail::getTable(m_tables, table_id);
+
+        //Find interpolation variables
+        EvalWell flo = detail::getFlo(aqua, liquid, vapour, table->getFloType());
+        EvalWell wfr = detail::getWFR(aqua, liquid, vapour, table->getWFRType());
+        EvalWell gfr = detail::getGFR(aqua, liquid, vapour, table->getGFRType());
+
+        //Value of FLO is negative in OPM for producers, but positive in VFP table
+        detail::VFPEvaluation bhp_val = slice.interpolate(*table, -flo.value(), thp, wfr.value(), gfr.value(), alq);
+
+        EvalWell bhp = (bhp_val.dwfr * wfr) + (bhp_val.dgfr * gfr) - (bhp_val.dflo * flo);
+        bhp.setValue(bhp_val.value);
+        return bhp;
+    }
+
     /**
      * Linear interpolation of bhp as a function of the input parameters
      * @param table_id Table number to use
@@ -132,6 +163,18 @@ public:
             const double& thp,
             const double& alq) const;
 
+    /**
+     * Linear interpolation of bhp as above, using and updating a slice of
+     * the table cached by the caller.
+     */
+    double bhp(int table_id,
+            const double& aqua,
+            const double& liquid,
+            const double& vapour,
+            const double& thp,
+            const double& alq,
+            detail::VFPProdSlice& slice) const;
+
     /**
      * Linear interpolation of thp as a function of the input parameters
      * @param table_id Table number to use
@@ -151,6 +194,18 @@ public:
             const double& bhp,
             const double& alq) const;
 
+    /**
+     * Linear interpolation of thp as above, using and updating a slice of
+     * the table cached by the caller.
+     */
+    double thp(int table_id,
+            const double& aqua,
+            const double& liquid,
+            const double& vapour,
+            const double& bhp,
+            const double& alq,
+            detail::VFPProdSlice& slice) const;
+
     /**
      * Returns the table associated with the ID, or throws an exception if
      * the table does not exist
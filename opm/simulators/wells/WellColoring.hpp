@@ -0,0 +1,69 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_WELLCOLORING_HEADER_INCLUDED
+#define OPM_WELLCOLORING_HEADER_INCLUDED
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Group wells into colours such that no two wells of the same colour
+    /// perforate the same cell.
+    ///
+    /// Greedy colouring in the order of the wells: every well gets the
+    /// lowest colour which is not used by any well perforating one of its
+    /// cells.
+    /// \param wellCells  the perforated cells of every well
+    /// \return the indices of the wells of every colour, in increasing order
+    inline std::vector<std::vector<int>>
+    colorWellsByCells(const std::vector<std::vector<int>>& wellCells)
+    {
+        std::vector<std::vector<int>> colors;
+        std::unordered_map<int, std::vector<int>> cellColors;
+        std::vector<bool> usedColors;
+        const int nw = wellCells.size();
+        for (int w = 0; w < nw; ++w) {
+            usedColors.assign(colors.size() + 1, false);
+            for (const int cell : wellCells[w]) {
+                const auto it = cellColors.find(cell);
+                if (it != cellColors.end()) {
+                    for (const int color : it->second) {
+                        usedColors[color] = true;
+                    }
+                }
+            }
+            const int color = std::find(usedColors.begin(), usedColors.end(), false) - usedColors.begin();
+            if (color == static_cast<int>(colors.size())) {
+                colors.emplace_back();
+            }
+            colors[color].push_back(w);
+            for (const int cell : wellCells[w]) {
+                cellColors[cell].push_back(color);
+            }
+        }
+        return colors;
+    }
+
+} // namespace Opm
+
+#endif // OPM_WELLCOLORING_HEADER_INCLUDED
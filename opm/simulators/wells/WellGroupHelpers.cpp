@@ -151,6 +151,95 @@ namespace WellGroupHelpers
             wellState.wellReservoirRates(), group, schedule, wellState, reportStepIdx, phasePos, injector);
     }
 
+    namespace {
+        // Add the rates of the wells directly below group g to rate, in
+        // the same order as sumWellPhaseRates() does.
+        double addChildWellRates(double rate,
+                                 const std::vector<double>& rates,
+                                 const GroupTree& tree,
+                                 const int g,
+                                 const int numPhases,
+                                 const int phasePos,
+                                 const bool injector)
+        {
+            for (const int w : tree.childWells(g)) {
+                const auto& well = tree.well(w);
+                if (well.well_state_index < 0) // the well is not found
+                    continue;
+
+                // only count producers or injectors
+                if ((well.is_producer && injector) || (well.is_injector && !injector))
+                    continue;
+
+                if (well.is_shut)
+                    continue;
+
+                const double wellRate = well.efficiency_factor * rates[well.well_state_index * numPhases + phasePos];
+                if (injector)
+                    rate += wellRate;
+                else
+                    rate -= wellRate;
+            }
+            return rate;
+        }
+    } // anonymous namespace
+
+    double sumWellPhaseRates(const std::vector<double>& rates,
+                             const GroupTree& tree,
+                             const int groupIdx,
+                             const WellStateFullyImplicitBlackoil& wellState,
+                             const int phasePos,
+                             const bool injector)
+    {
+        double rate = 0.0;
+        for (const int child : tree.childGroups(groupIdx)) {
+            rate += tree.group(child).efficiency_factor
+                * sumWellPhaseRates(rates, tree, child, wellState, phasePos, injector);
+        }
+        return addChildWellRates(rate, rates, tree, groupIdx, wellState.numPhases(), phasePos, injector);
+    }
+
+    std::vector<double> sumWellPhaseRatesAllGroups(const std::vector<double>& rates,
+                                                   const GroupTree& tree,
+                                                   const WellStateFullyImplicitBlackoil& wellState,
+                                                   const bool injector)
+    {
+        const int np = wellState.numPhases();
+        std::vector<double> groupRates(tree.numGroups() * np, 0.0);
+        for (const int g : tree.bottomUpOrder()) {
+            for (int phasePos = 0; phasePos < np; ++phasePos) {
+                double rate = 0.0;
+                for (const int child : tree.childGroups(g)) {
+                    rate += tree.group(child).efficiency_factor * groupRates[child * np + phasePos];
+                }
+                groupRates[g * np + phasePos] = addChildWellRates(rate, rates, tree, g, np, phasePos, injector);
+            }
+        }
+        return groupRates;
+    }
+
+    double sumWellRates(const GroupTree& tree,
+                        const Group& group,
+                        const WellStateFullyImplicitBlackoil& wellState,
+                        const int phasePos,
+                        const bool injector)
+    {
+        const int g = tree.groupIndex(group.name());
+        assert(g >= 0);
+        return sumWellPhaseRates(wellState.wellRates(), tree, g, wellState, phasePos, injector);
+    }
+
+    double sumWellResRates(const GroupTree& tree,
+                           const Group& group,
+                           const WellStateFullyImplicitBlackoil& wellState,
+                           const int phasePos,
+                           const bool injector)
+    {
+        const int g = tree.groupIndex(group.name());
+        assert(g >= 0);
+        return sumWellPhaseRates(wellState.wellReservoirRates(), tree, g, wellState, phasePos, injector);
+    }
+
     double sumSolventRates(const Group& group,
                            const Schedule& schedule,
                            const WellStateFullyImplicitBlackoil& wellState,
@@ -305,6 +394,216 @@ namespace WellGroupHelpers
             wellState.setCurrentProductionGroupReductionRates(group.name(), groupTargetReduction);
     }
 
+    void updateGroupTargetReduction(const GroupTree& tree,
+                                    const bool isInjector,
+                                    const PhaseUsage& pu,
+                                    const GuideRate& guide_rate,
+                                    const WellStateFullyImplicitBlackoil& wellStateNupcol,
+                                    WellStateFullyImplicitBlackoil& wellState)
+    {
+        const int np = wellState.numPhases();
+        const int ng = tree.numGroups();
+        std::vector<double> reductions(ng * np, 0.0);
+
+        // Rates of all groups, used for subgroups under individual control.
+        const std::vector<double> groupRates
+            = sumWellPhaseRatesAllGroups(wellStateNupcol.wellRates(), tree, wellStateNupcol, isInjector);
+
+        // Number of group controlled wells below each group, see groupControlledWells().
+        std::vector<int> numGroupControlledWells(ng, 0);
+        if (!isInjector) {
+            for (const int g : tree.bottomUpOrder()) {
+                int num_wells = 0;
+                for (const int child : tree.childGroups(g)) {
+                    const auto ctrl = wellStateNupcol.currentProductionGroupControl(tree.group(child).name);
+                    if (ctrl == Group::ProductionCMode::FLD || ctrl == Group::ProductionCMode::NONE) {
+                        num_wells += numGroupControlledWells[child];
+                    }
+                }
+                for (const int w : tree.childWells(g)) {
+                    if (wellStateNupcol.isProductionGrup(tree.well(w).name)) {
+                        ++num_wells;
+                    }
+                }
+                numGroupControlledWells[g] = num_wells;
+            }
+        }
+
+        for (const int g : tree.bottomUpOrder()) {
+            double* groupTargetReduction = reductions.data() + g * np;
+            for (const int subGroup : tree.childGroups(g)) {
+                const std::string& subGroupName = tree.group(subGroup).name;
+                const double* subGroupTargetReduction = reductions.data() + subGroup * np;
+                const double* subGroupRates = groupRates.data() + subGroup * np;
+
+                // accumulate group contribution from sub group
+                if (isInjector) {
+                    const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
+                    for (Phase phase : all) {
+                        const Group::InjectionCMode& currentGroupControl
+                            = wellState.currentInjectionGroupControl(phase, subGroupName);
+                        int phasePos;
+                        if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
+                            phasePos = pu.phase_pos[BlackoilPhases::Vapour];
+                        else if (phase == Phase::OIL && pu.phase_used[BlackoilPhases::Liquid])
+                            phasePos = pu.phase_pos[BlackoilPhases::Liquid];
+                        else if (phase == Phase::WATER && pu.phase_used[BlackoilPhases::Aqua])
+                            phasePos = pu.phase_pos[BlackoilPhases::Aqua];
+                        else
+                            continue;
+
+                        if (currentGroupControl != Group::InjectionCMode::FLD
+                            && currentGroupControl != Group::InjectionCMode::NONE) {
+                            // Subgroup is under individual control.
+                            groupTargetReduction[phasePos] += subGroupRates[phasePos];
+                        } else {
+                            groupTargetReduction[phasePos] += subGroupTargetReduction[phasePos];
+                        }
+                    }
+                } else {
+                    const Group::ProductionCMode& currentGroupControl
+                        = wellState.currentProductionGroupControl(subGroupName);
+                    const bool individual_control = (currentGroupControl != Group::ProductionCMode::FLD
+                                                     && currentGroupControl != Group::ProductionCMode::NONE);
+                    if (individual_control || numGroupControlledWells[subGroup] == 0) {
+                        for (int phase = 0; phase < np; phase++) {
+                            groupTargetReduction[phase] += subGroupRates[phase];
+                        }
+                    } else {
+                        // The subgroup may participate in group control.
+                        if (!guide_rate.has(subGroupName)) {
+                            // Accumulate from this subgroup only if no group guide rate is set for it.
+                            for (int phase = 0; phase < np; phase++) {
+                                groupTargetReduction[phase] += subGroupTargetReduction[phase];
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (const int w : tree.childWells(g)) {
+                const auto& well = tree.well(w);
+
+                if (well.is_producer && isInjector)
+                    continue;
+
+                if (well.is_injector && !isInjector)
+                    continue;
+
+                if (well.is_shut)
+                    continue;
+
+                const int well_index = well.well_state_index;
+                if (well_index < 0) // the well is not found
+                    continue;
+
+                const auto wellrate_index = well_index * np;
+                // add contribution from wells not under group control
+                if (isInjector) {
+                    if (wellState.currentInjectionControls()[well_index] != Well::InjectorCMode::GRUP)
+                        for (int phase = 0; phase < np; phase++) {
+                            groupTargetReduction[phase] += wellStateNupcol.wellRates()[wellrate_index + phase] * well.efficiency_factor;
+                        }
+                } else {
+                    if (wellState.currentProductionControls()[well_index] != Well::ProducerCMode::GRUP)
+                        for (int phase = 0; phase < np; phase++) {
+                            groupTargetReduction[phase] -= wellStateNupcol.wellRates()[wellrate_index + phase] * well.efficiency_factor;
+                        }
+                }
+            }
+
+            const double groupEfficiency = tree.group(g).efficiency_factor;
+            for (int phase = 0; phase < np; phase++) {
+                groupTargetReduction[phase] *= groupEfficiency;
+            }
+
+            const std::vector<double> groupReduction(groupTargetReduction, groupTargetReduction + np);
+            if (isInjector)
+                wellState.setCurrentInjectionGroupReductionRates(tree.group(g).name, groupReduction);
+            else
+                wellState.setCurrentProductionGroupReductionRates(tree.group(g).name, groupReduction);
+        }
+    }
+
+    void accumulateGroupPotentials(const Group& group,
+                                   const Schedule& schedule,
+                                   const PhaseUsage& pu,
+                                   const int reportStepIdx,
+                                   const bool isInjector,
+                                   WellStateFullyImplicitBlackoil& wellState,
+                                   std::vector<std::string>& groupNames,
+                                   std::vector<double>& groupPotentials,
+                                   std::vector<double>& pot)
+    {
+        const int np = pu.num_phases;
+        for (const std::string& groupName : group.groups()) {
+            std::vector<double> thisPot(np, 0.0);
+            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
+            accumulateGroupPotentials(
+                groupTmp, schedule, pu, reportStepIdx, isInjector, wellState, groupNames, groupPotentials, thisPot);
+
+            // accumulate group contribution from sub group unconditionally
+            if (isInjector) {
+                const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
+                for (Phase phase : all) {
+                    int phasePos;
+                    if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
+                        phasePos = pu.phase_pos[BlackoilPhases::Vapour];
+                    else if (phase == Phase::OIL && pu.phase_used[BlackoilPhases::Liquid])
+                        phasePos = pu.phase_pos[BlackoilPhases::Liquid];
+                    else if (phase == Phase::WATER && pu.phase_used[BlackoilPhases::Aqua])
+                        phasePos = pu.phase_pos[BlackoilPhases::Aqua];
+                    else
+                        continue;
+
+                    pot[phasePos] += thisPot[phasePos];
+                }
+            } else {
+                const Group::ProductionCMode& currentGroupControl = wellState.currentProductionGroupControl(groupName);
+                if (currentGroupControl != Group::ProductionCMode::FLD
+                    && currentGroupControl != Group::ProductionCMode::NONE) {
+                    continue;
+                }
+                for (int phase = 0; phase < np; phase++) {
+                    pot[phase] += thisPot[phase];
+                }
+            }
+        }
+        for (const std::string& wellName : group.wells()) {
+            const auto& wellTmp = schedule.getWell(wellName, reportStepIdx);
+
+            if (wellTmp.isProducer() && isInjector)
+                continue;
+
+            if (wellTmp.isInjector() && !isInjector)
+                continue;
+
+            if (wellTmp.getStatus() == Well::Status::SHUT)
+                continue;
+            const auto& end = wellState.wellMap().end();
+            const auto& it = wellState.wellMap().find(wellName);
+            if (it == end) // the well is not found
+                continue;
+
+            int well_index = it->second[0];
+            const auto wellrate_index = well_index * wellState.numPhases();
+            // add contribution from wells unconditionally
+            for (int phase = 0; phase < np; phase++) {
+                pot[phase] += wellState.wellPotentials()[wellrate_index + phase];
+            }
+        }
+
+        if (isInjector) {
+            wellState.setCurrentGroupInjectionPotentials(group.name(), pot);
+            return;
+        }
+
+        groupNames.push_back(group.name());
+        groupPotentials.push_back(pu.phase_used[BlackoilPhases::Liquid] ? pot[pu.phase_pos[BlackoilPhases::Liquid]] : 0.0);
+        groupPotentials.push_back(pu.phase_used[BlackoilPhases::Vapour] ? pot[pu.phase_pos[BlackoilPhases::Vapour]] : 0.0);
+        groupPotentials.push_back(pu.phase_used[BlackoilPhases::Aqua] ? pot[pu.phase_pos[BlackoilPhases::Aqua]] : 0.0);
+    }
+
 
     /*
         template <class Comm>
@@ -700,19 +999,48 @@ namespace WellGroupHelpers
     }
 
 
+    int groupControlledWells(const GroupTree& tree,
+                             const WellStateFullyImplicitBlackoil& well_state,
+                             const int groupIdx,
+                             const std::string& always_included_child)
+    {
+        int num_wells = 0;
+        for (const int child : tree.childGroups(groupIdx)) {
+            const std::string& child_group = tree.group(child).name;
+            const auto ctrl = well_state.currentProductionGroupControl(child_group);
+            const bool included = (ctrl == Group::ProductionCMode::FLD) || (ctrl == Group::ProductionCMode::NONE)
+                || (child_group == always_included_child);
+            if (included) {
+                num_wells += groupControlledWells(tree, well_state, child, always_included_child);
+            }
+        }
+        for (const int child : tree.childWells(groupIdx)) {
+            const std::string& child_well = tree.well(child).name;
+            const bool included = (well_state.isProductionGrup(child_well)) || (child_well == always_included_child);
+            if (included) {
+                ++num_wells;
+            }
+        }
+        return num_wells;
+    }
+
+
     FractionCalculator::FractionCalculator(const Schedule& schedule,
                                            const WellStateFullyImplicitBlackoil& well_state,
                                            const int report_step,
                                            const GuideRate* guide_rate,
                                            const GuideRateModel::Target target,
-                                           const PhaseUsage& pu)
+                                           const PhaseUsage& pu,
+                                           const GroupTree* tree)
         : schedule_(schedule)
         , well_state_(well_state)
         , report_step_(report_step)
         , guide_rate_(guide_rate)
         , target_(target)
         , pu_(pu)
+        , tree_(tree)
     {
+        assert(!tree_ || tree_->reportStep() == report_step_);
     }
     double FractionCalculator::fraction(const std::string& name,
                                         const std::string& control_group_name,
@@ -729,42 +1057,67 @@ namespace WellGroupHelpers
     double FractionCalculator::localFraction(const std::string& name, const std::string& always_included_child)
     {
         const double my_guide_rate = guideRate(name, always_included_child);
-        const Group& parent_group = schedule_.getGroup(parent(name), report_step_);
-        const double total_guide_rate = guideRateSum(parent_group, always_included_child);
+        const double total_guide_rate = guideRateSum(parent(name), always_included_child);
         assert(total_guide_rate >= my_guide_rate);
         const double guide_rate_epsilon = 1e-12;
         return (total_guide_rate > guide_rate_epsilon) ? my_guide_rate / total_guide_rate : 0.0;
     }
     std::string FractionCalculator::parent(const std::string& name)
     {
+        if (tree_) {
+            const int w = tree_->wellIndex(name);
+            const int g = (w >= 0) ? tree_->well(w).group : tree_->group(tree_->groupIndex(name)).parent;
+            return tree_->group(g).name;
+        }
         if (schedule_.hasWell(name)) {
             return schedule_.getWell(name, report_step_).groupName();
         } else {
             return schedule_.getGroup(name, report_step_).parent();
         }
     }
-    double FractionCalculator::guideRateSum(const Group& group, const std::string& always_included_child)
+    bool FractionCalculator::isWell(const std::string& name)
+    {
+        return tree_ ? (tree_->wellIndex(name) >= 0) : schedule_.hasWell(name, report_step_);
+    }
+    double FractionCalculator::guideRateSum(const std::string& group_name, const std::string& always_included_child)
     {
         double total_guide_rate = 0.0;
-        for (const std::string& child_group : group.groups()) {
+        auto addGroup = [&](const std::string& child_group) {
             const auto ctrl = well_state_.currentProductionGroupControl(child_group);
             const bool included = (ctrl == Group::ProductionCMode::FLD) || (ctrl == Group::ProductionCMode::NONE)
                 || (child_group == always_included_child);
             if (included) {
                 total_guide_rate += guideRate(child_group, always_included_child);
             }
-        }
-        for (const std::string& child_well : group.wells()) {
+        };
+        auto addWell = [&](const std::string& child_well) {
             const bool included = (well_state_.isProductionGrup(child_well)) || (child_well == always_included_child);
             if (included) {
                 total_guide_rate += guideRate(child_well, always_included_child);
             }
+        };
+        if (tree_) {
+            const int g = tree_->groupIndex(group_name);
+            for (const int child : tree_->childGroups(g)) {
+                addGroup(tree_->group(child).name);
+            }
+            for (const int child : tree_->childWells(g)) {
+                addWell(tree_->well(child).name);
+            }
+        } else {
+            const Group& group = schedule_.getGroup(group_name, report_step_);
+            for (const std::string& child_group : group.groups()) {
+                addGroup(child_group);
+            }
+            for (const std::string& child_well : group.wells()) {
+                addWell(child_well);
+            }
         }
         return total_guide_rate;
     }
     double FractionCalculator::guideRate(const std::string& name, const std::string& always_included_child)
     {
-        if (schedule_.hasWell(name, report_step_)) {
+        if (isWell(name)) {
             return guide_rate_->get(name, target_, getRateVector(well_state_, pu_, name));
         } else {
             if (groupControlledWells(name, always_included_child) > 0) {
@@ -773,8 +1126,7 @@ namespace WellGroupHelpers
                 } else {
                     // We are a group, with default guide rate.
                     // Compute guide rate by accumulating our children's guide rates.
-                    const Group& group = schedule_.getGroup(name, report_step_);
-                    return guideRateSum(group, always_included_child);
+                    return guideRateSum(name, always_included_child);
                 }
             } else {
                 // No group-controlled subordinate wells.
@@ -785,6 +1137,10 @@ namespace WellGroupHelpers
     int FractionCalculator::groupControlledWells(const std::string& group_name,
                                                  const std::string& always_included_child)
     {
+        if (tree_) {
+            return ::Opm::WellGroupHelpers::groupControlledWells(
+                *tree_, well_state_, tree_->groupIndex(group_name), always_included_child);
+        }
         return ::Opm::WellGroupHelpers::groupControlledWells(
             schedule_, well_state_, report_step_, group_name, always_included_child);
     }
@@ -26,10 +26,12 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/simulators/utils/DeferredLogger.hpp>
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -75,6 +77,33 @@ namespace WellGroupHelpers
                            const int phasePos,
                            const bool injector);
 
+    /// Same as sumWellPhaseRates(), but using the compiled group tree.
+    double sumWellPhaseRates(const std::vector<double>& rates,
+                             const GroupTree& tree,
+                             const int groupIdx,
+                             const WellStateFullyImplicitBlackoil& wellState,
+                             const int phasePos,
+                             const bool injector);
+
+    /// The rates of all groups of the tree in one bottom-up pass.
+    /// The rate of phase p in group g is stored at g*numPhases + p.
+    std::vector<double> sumWellPhaseRatesAllGroups(const std::vector<double>& rates,
+                                                   const GroupTree& tree,
+                                                   const WellStateFullyImplicitBlackoil& wellState,
+                                                   const bool injector);
+
+    double sumWellRates(const GroupTree& tree,
+                        const Group& group,
+                        const WellStateFullyImplicitBlackoil& wellState,
+                        const int phasePos,
+                        const bool injector);
+
+    double sumWellResRates(const GroupTree& tree,
+                           const Group& group,
+                           const WellStateFullyImplicitBlackoil& wellState,
+                           const int phasePos,
+                           const bool injector);
+
     double sumSolventRates(const Group& group,
                            const Schedule& schedule,
                            const WellStateFullyImplicitBlackoil& wellState,
@@ -91,6 +120,31 @@ namespace WellGroupHelpers
                                     WellStateFullyImplicitBlackoil& wellState,
                                     std::vector<double>& groupTargetReduction);
 
+    /// Same as updateGroupTargetReduction() called for FIELD, but
+    /// computed for all groups in one bottom-up pass over the tree.
+    void updateGroupTargetReduction(const GroupTree& tree,
+                                    const bool isInjector,
+                                    const PhaseUsage& pu,
+                                    const GuideRate& guide_rate,
+                                    const WellStateFullyImplicitBlackoil& wellStateNupcol,
+                                    WellStateFullyImplicitBlackoil& wellState);
+
+    /// Accumulate the local potentials of group and its subgroups in pot.
+    ///
+    /// For production groups the name and the local oil, gas and water
+    /// potentials of every group are appended to groupNames and
+    /// groupPotentials, subgroups before their parents. For injection
+    /// groups the local potentials are stored in the well state.
+    void accumulateGroupPotentials(const Group& group,
+                                   const Schedule& schedule,
+                                   const PhaseUsage& pu,
+                                   const int reportStepIdx,
+                                   const bool isInjector,
+                                   WellStateFullyImplicitBlackoil& wellState,
+                                   std::vector<std::string>& groupNames,
+                                   std::vector<double>& groupPotentials,
+                                   std::vector<double>& pot);
+
     template <class Comm>
     void updateGuideRateForGroups(const Group& group,
                                   const Schedule& schedule,
@@ -103,86 +157,24 @@ namespace WellGroupHelpers
                                   GuideRate* guideRate,
                                   std::vector<double>& pot)
     {
-        const int np = pu.num_phases;
-        for (const std::string& groupName : group.groups()) {
-            std::vector<double> thisPot(np, 0.0);
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateGuideRateForGroups(
-                groupTmp, schedule, pu, reportStepIdx, simTime, isInjector, wellState, comm, guideRate, thisPot);
-
-            // accumulate group contribution from sub group unconditionally
-            if (isInjector) {
-                const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
-                for (Phase phase : all) {
-                    int phasePos;
-                    if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
-                        phasePos = pu.phase_pos[BlackoilPhases::Vapour];
-                    else if (phase == Phase::OIL && pu.phase_used[BlackoilPhases::Liquid])
-                        phasePos = pu.phase_pos[BlackoilPhases::Liquid];
-                    else if (phase == Phase::WATER && pu.phase_used[BlackoilPhases::Aqua])
-                        phasePos = pu.phase_pos[BlackoilPhases::Aqua];
-                    else
-                        continue;
-
-                    pot[phasePos] += thisPot[phasePos];
-                }
-            } else {
-                const Group::ProductionCMode& currentGroupControl = wellState.currentProductionGroupControl(groupName);
-                if (currentGroupControl != Group::ProductionCMode::FLD
-                    && currentGroupControl != Group::ProductionCMode::NONE) {
-                    continue;
-                }
-                for (int phase = 0; phase < np; phase++) {
-                    pot[phase] += thisPot[phase];
-                }
-            }
-        }
-        for (const std::string& wellName : group.wells()) {
-            const auto& wellTmp = schedule.getWell(wellName, reportStepIdx);
-
-            if (wellTmp.isProducer() && isInjector)
-                continue;
-
-            if (wellTmp.isInjector() && !isInjector)
-                continue;
+        std::vector<std::string> groupNames;
+        std::vector<double> groupPotentials;
+        accumulateGroupPotentials(
+            group, schedule, pu, reportStepIdx, isInjector, wellState, groupNames, groupPotentials, pot);
 
-            if (wellTmp.getStatus() == Well::Status::SHUT)
-                continue;
-            const auto& end = wellState.wellMap().end();
-            const auto& it = wellState.wellMap().find(wellName);
-            if (it == end) // the well is not found
-                continue;
-
-            int well_index = it->second[0];
-            const auto wellrate_index = well_index * wellState.numPhases();
-            // add contribution from wells unconditionally
-            for (int phase = 0; phase < np; phase++) {
-                pot[phase] += wellState.wellPotentials()[wellrate_index + phase];
-            }
+        if (isInjector) {
+            return;
         }
 
-        double oilPot = 0.0;
-        if (pu.phase_used[BlackoilPhases::Liquid])
-            oilPot = pot[pu.phase_pos[BlackoilPhases::Liquid]];
-
-        double gasPot = 0.0;
-        if (pu.phase_used[BlackoilPhases::Vapour])
-            gasPot = pot[pu.phase_pos[BlackoilPhases::Vapour]];
+        // sum the potentials of all groups over all nodes at once
+        comm.sum(groupPotentials.data(), groupPotentials.size());
 
-        double waterPot = 0.0;
-        if (pu.phase_used[BlackoilPhases::Aqua])
-            waterPot = pot[pu.phase_pos[BlackoilPhases::Aqua]];
-
-        const double gefac = group.getGroupEfficiencyFactor();
-
-        oilPot = comm.sum(oilPot) * gefac;
-        gasPot = comm.sum(gasPot) * gefac;
-        waterPot = comm.sum(waterPot) * gefac;
-
-        if (isInjector) {
-            wellState.setCurrentGroupInjectionPotentials(group.name(), pot);
-        } else {
-            guideRate->compute(group.name(), reportStepIdx, simTime, oilPot, gasPot, waterPot);
+        for (std::size_t i = 0; i < groupNames.size(); ++i) {
+            const double gefac = schedule.getGroup(groupNames[i], reportStepIdx).getGroupEfficiencyFactor();
+            const double oilPot = groupPotentials[3 * i] * gefac;
+            const double gasPot = groupPotentials[3 * i + 1] * gefac;
+            const double waterPot = groupPotentials[3 * i + 2] * gefac;
+            guideRate->compute(groupNames[i], reportStepIdx, simTime, oilPot, gasPot, waterPot);
         }
     }
 
@@ -195,33 +187,38 @@ namespace WellGroupHelpers
                                   const Comm& comm,
                                   GuideRate* guideRate)
     {
+        const auto wells = schedule.getWells(reportStepIdx);
 
+        // oil, gas and water potential of every well
+        std::vector<double> wellPotentials(3 * wells.size(), 0.0);
         const auto& end = wellState.wellMap().end();
-        for (const auto& well : schedule.getWells(reportStepIdx)) {
-            double oilpot = 0.0;
-            double gaspot = 0.0;
-            double waterpot = 0.0;
-
-            const auto& it = wellState.wellMap().find(well.name());
-            if (it != end) { // the well is found
-
-                int well_index = it->second[0];
-
-                const auto wpot = wellState.wellPotentials().data() + well_index * wellState.numPhases();
-                if (pu.phase_used[BlackoilPhases::Liquid] > 0)
-                    oilpot = wpot[pu.phase_pos[BlackoilPhases::Liquid]];
-
-                if (pu.phase_used[BlackoilPhases::Vapour] > 0)
-                    gaspot = wpot[pu.phase_pos[BlackoilPhases::Vapour]];
-
-                if (pu.phase_used[BlackoilPhases::Aqua] > 0)
-                    waterpot = wpot[pu.phase_pos[BlackoilPhases::Aqua]];
-            }
-            const double wefac = well.getEfficiencyFactor();
-            oilpot = comm.sum(oilpot) * wefac;
-            gaspot = comm.sum(gaspot) * wefac;
-            waterpot = comm.sum(waterpot) * wefac;
-            guideRate->compute(well.name(), reportStepIdx, simTime, oilpot, gaspot, waterpot);
+        for (std::size_t i = 0; i < wells.size(); ++i) {
+            const auto& it = wellState.wellMap().find(wells[i].name());
+            if (it == end) // the well is not found
+                continue;
+
+            int well_index = it->second[0];
+
+            const auto wpot = wellState.wellPotentials().data() + well_index * wellState.numPhases();
+            if (pu.phase_used[BlackoilPhases::Liquid] > 0)
+                wellPotentials[3 * i] = wpot[pu.phase_pos[BlackoilPhases::Liquid]];
+
+            if (pu.phase_used[BlackoilPhases::Vapour] > 0)
+                wellPotentials[3 * i + 1] = wpot[pu.phase_pos[BlackoilPhases::Vapour]];
+
+            if (pu.phase_used[BlackoilPhases::Aqua] > 0)
+                wellPotentials[3 * i + 2] = wpot[pu.phase_pos[BlackoilPhases::Aqua]];
+        }
+
+        // sum the potentials of all wells over all nodes at once
+        comm.sum(wellPotentials.data(), wellPotentials.size());
+
+        for (std::size_t i = 0; i < wells.size(); ++i) {
+            const double wefac = wells[i].getEfficiencyFactor();
+            const double oilpot = wellPotentials[3 * i] * wefac;
+            const double gaspot = wellPotentials[3 * i + 1] * wefac;
+            const double waterpot = wellPotentials[3 * i + 2] * wefac;
+            guideRate->compute(wells[i].name(), reportStepIdx, simTime, oilpot, gaspot, waterpot);
         }
     }
 
@@ -287,22 +284,31 @@ namespace WellGroupHelpers
                              const std::string& group_name,
                              const std::string& always_included_child);
 
+    int groupControlledWells(const GroupTree& tree,
+                             const WellStateFullyImplicitBlackoil& well_state,
+                             const int groupIdx,
+                             const std::string& always_included_child);
+
 
     class FractionCalculator
     {
     public:
+        /// If a group tree of the report step is given, the group
+        /// hierarchy is traversed through it instead of the schedule.
         FractionCalculator(const Schedule& schedule,
                            const WellStateFullyImplicitBlackoil& well_state,
                            const int report_step,
                            const GuideRate* guide_rate,
                            const GuideRateModel::Target target,
-                           const PhaseUsage& pu);
+                           const PhaseUsage& pu,
+                           const GroupTree* tree = nullptr);
         double fraction(const std::string& name, const std::string& control_group_name, const bool always_include_this);
         double localFraction(const std::string& name, const std::string& always_included_child);
 
     private:
         std::string parent(const std::string& name);
-        double guideRateSum(const Group& group, const std::string& always_included_child);
+        bool isWell(const std::string& name);
+        double guideRateSum(const std::string& group_name, const std::string& always_included_child);
         double guideRate(const std::string& name, const std::string& always_included_child);
         int groupControlledWells(const std::string& group_name, const std::string& always_included_child);
         GuideRate::RateVector getGroupRateVector(const std::string& group_name);
@@ -312,6 +318,7 @@ namespace WellGroupHelpers
         const GuideRate* guide_rate_;
         GuideRateModel::Target target_;
         PhaseUsage pu_;
+        const GroupTree* tree_;
     };
 
     GuideRate::RateVector getGroupRateVector(const std::string& group_name);
@@ -150,6 +150,8 @@ namespace Opm
 
         void setGuideRate(const GuideRate* guide_rate_arg);
 
+        void setGroupTree(const WellGroupHelpers::GroupTree* group_tree_arg);
+
         virtual void init(const PhaseUsage* phase_usage_arg,
                           const std::vector<double>& depth_arg,
                           const double gravity_arg,
@@ -347,8 +349,14 @@ namespace Opm
 
         const VFPProperties<VFPInjProperties,VFPProdProperties>* vfp_properties_;
 
+        // values of the production VFP table around the current fractions of the well,
+        // reused by the repeated bhp/thp evaluations of the THP control
+        mutable detail::VFPProdSlice vfp_prod_slice_;
+
         const GuideRate* guide_rate_;
 
+        const WellGroupHelpers::GroupTree* group_tree_ = nullptr;
+
         double gravity_;
 
         // For the conversion between the surface volume rate and resrevoir voidage rate
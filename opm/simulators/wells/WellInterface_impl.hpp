@@ -177,6 +177,16 @@ namespace Opm
     }
 
 
+
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    setGroupTree(const WellGroupHelpers::GroupTree* group_tree_arg)
+    {
+        group_tree_ = group_tree_arg;
+    }
+
+
     template<typename TypeTag>
     const std::string&
     WellInterface<TypeTag>::
@@ -2253,7 +2263,7 @@ namespace Opm
             gratTargetFromSales = well_state.currentGroupGratTargetFromSales(group.name());
 
         WellGroupHelpers::TargetCalculator tcalc(currentGroupControl, pu, resv_coeff, gratTargetFromSales);
-        WellGroupHelpers::FractionCalculator fcalc(schedule, well_state, current_step_, guide_rate_, tcalc.guideTargetMode(), pu);
+        WellGroupHelpers::FractionCalculator fcalc(schedule, well_state, current_step_, guide_rate_, tcalc.guideTargetMode(), pu, group_tree_);
 
         auto localFraction = [&](const std::string& child) {
             return fcalc.localFraction(child, "");
@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <cassert>
+#include <cmath>
 #include <string>
 #include <utility>
 #include <map>
@@ -1019,6 +1020,78 @@ namespace Opm
             comm.sum(globalIsProductionGrup_.data(), globalIsProductionGrup_.size());
         }
 
+        /// Extrapolate the bottom hole pressures and surface rates of the
+        /// single segment wells from converged states of previous time steps.
+        /// The change sum_i weights[i] * states[i] - states[0] is added, where
+        /// states[0] is the state this one was started from. Wells missing in
+        /// one of the states, under a different control or with rates changing
+        /// sign are left unchanged. The change of the bhp is limited to dbhp_max_rel
+        /// times the bhp, the rates are scaled by the same factor.
+        void extrapolate(const std::vector<const WellStateFullyImplicitBlackoil*>& states,
+                         const std::vector<double>& weights,
+                         const double dbhp_max_rel)
+        {
+            assert(!states.empty() && states.size() == weights.size());
+            const int np = numPhases();
+            for (const auto& entry : wellMap()) {
+                const int w = entry.second[0];
+                if (numSegments(w) != 1) {
+                    continue;
+                }
+
+                // the indices of the well in all states
+                std::vector<int> indices;
+                for (const auto* state : states) {
+                    const auto it = state->wellMap().find(entry.first);
+                    if (it == state->wellMap().end()) {
+                        break;
+                    }
+                    const int idx = it->second[0];
+                    if (state->currentProductionControls()[idx] != currentProductionControls()[w]
+                        || state->currentInjectionControls()[idx] != currentInjectionControls()[w]) {
+                        break;
+                    }
+                    indices.push_back(idx);
+                }
+                if (indices.size() != states.size()) {
+                    continue;
+                }
+
+                double dbhp = -states[0]->bhp()[indices[0]];
+                std::vector<double> drates(np);
+                for (int p = 0; p < np; ++p) {
+                    drates[p] = -states[0]->wellRates()[np * indices[0] + p];
+                }
+                for (std::size_t i = 0; i < states.size(); ++i) {
+                    dbhp += weights[i] * states[i]->bhp()[indices[i]];
+                    for (int p = 0; p < np; ++p) {
+                        drates[p] += weights[i] * states[i]->wellRates()[np * indices[i] + p];
+                    }
+                }
+
+                const double max_dbhp = dbhp_max_rel * bhp()[w];
+                const double factor = std::abs(dbhp) > max_dbhp ? max_dbhp / std::abs(dbhp) : 1.0;
+                bool sign_change = false;
+                for (int p = 0; p < np; ++p) {
+                    const double rate = wellRates()[np * w + p];
+                    sign_change = sign_change || rate * (rate + factor * drates[p]) < 0.0;
+                }
+                if (sign_change) {
+                    continue;
+                }
+
+                bhp()[w] += factor * dbhp;
+                for (int p = 0; p < np; ++p) {
+                    wellRates()[np * w + p] += factor * drates[p];
+                }
+                const int top_segment = topSegmentIndex(w);
+                segPress()[top_segment] = bhp()[w];
+                for (int p = 0; p < np; ++p) {
+                    segRates()[np * top_segment + p] = wellRates()[np * w + p];
+                }
+            }
+        }
+
         bool isInjectionGrup(const std::string& name) const {
 
             auto it = wellNameToGlobalIdx_.find(name);
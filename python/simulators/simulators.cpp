@@ -5,15 +5,29 @@
 #include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
 #define FLOW_BLACKOIL_ONLY
 #include <opm/simulators/flow/Main.hpp>
+#include <opm/simulators/flow/FlowMainEbos.hpp>
 #include <pybind11/pybind11.h>
 #include <pybind11/embed.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace py = pybind11;
 
 class BlackOilSimulator
 {
+private:
+    using TypeTag = TTAG(EclFlowProblem);
+    using FlowMainEbosType = Opm::FlowMainEbos<TypeTag>;
+    using EbosSimulator = FlowMainEbosType::EbosSimulator;
+    using PrimaryVariables = GET_PROP_TYPE(TypeTag, PrimaryVariables);
+    using Scalar = GET_PROP_TYPE(TypeTag, Scalar);
+
 public:
 
     BlackOilSimulator( const std::string &deckFilename) : deckFilename_(deckFilename)
@@ -25,14 +39,119 @@ public:
         auto mainObject = Opm::Main( deckFilename_ );
         return mainObject.runDynamic();
     }
-    
+
+    // Initialize the simulation, the report steps are then run by step().
+    int setup()
+    {
+        main_ = std::make_unique<Opm::Main>( deckFilename_ );
+        int exitCode = EXIT_SUCCESS;
+        mainEbos_ = main_->initFlowEbosBlackoil(exitCode);
+        if (mainEbos_) {
+            exitCode = mainEbos_->executeInitStep();
+        }
+        return exitCode;
+    }
+
+    // Run the next report step.
+    int step()
+    {
+        return flowMain_()->executeStep();
+    }
+
+    bool done()
+    {
+        return flowMain_()->done();
+    }
+
+    // Finish the simulation started by setup(), all views returned by
+    // this object are invalid afterwards.
+    int cleanup()
+    {
+        const int exitCode = flowMain_()->executeStepsCleanup();
+        mainEbos_.reset();
+        main_.reset();
+        return exitCode;
+    }
+
+    int currentStep()
+    {
+        return flowMain_()->getSimTimer()->currentStepNum();
+    }
+
+    // The primary variables of the local cells, one row per cell. The
+    // array is a view of the simulator's solution, it stays valid until
+    // cleanup() is called.
+    static py::array primaryVariables(py::object self)
+    {
+        auto& solution = self.cast<BlackOilSimulator&>().ebosSimulator().model().solution(/*timeIdx=*/0);
+        static_assert(std::is_same<Scalar, double>::value, "The NumPy views assume double precision");
+        const py::ssize_t numCells = solution.size();
+        const py::ssize_t numEq = PrimaryVariables::dimension;
+        const Scalar* data = numCells > 0 ? &solution[0][0] : nullptr;
+        return py::array_t<double>({numCells, numEq},
+                                   {static_cast<py::ssize_t>(sizeof(PrimaryVariables)),
+                                    static_cast<py::ssize_t>(sizeof(Scalar))},
+                                   data,
+                                   self);
+    }
+
+    // The surface rates of the local wells, one row per well in the order
+    // of wellNames(). The array is a read-only view of the well state, it
+    // stays valid until the next call of step().
+    static py::array wellRates(py::object self)
+    {
+        const auto& wellState = self.cast<BlackOilSimulator&>().ebosSimulator().problem().wellModel().wellState();
+        const auto& rates = wellState.wellRates();
+        const py::ssize_t numPhases = wellState.numPhases();
+        const py::ssize_t numWells = numPhases > 0 ? rates.size() / numPhases : 0;
+        py::array_t<double> view({numWells, numPhases},
+                                 {static_cast<py::ssize_t>(numPhases * sizeof(double)),
+                                  static_cast<py::ssize_t>(sizeof(double))},
+                                 rates.data(),
+                                 self);
+        view.attr("setflags")(py::arg("write") = false);
+        return view;
+    }
+
+    std::vector<std::string> wellNames()
+    {
+        const auto& wellMap = ebosSimulator().problem().wellModel().wellState().wellMap();
+        std::vector<std::string> names(wellMap.size());
+        for (const auto& well : wellMap) {
+            names[well.second[0]] = well.first;
+        }
+        return names;
+    }
+
 private:
+    FlowMainEbosType* flowMain_()
+    {
+        if (!mainEbos_)
+            throw std::logic_error("The simulation has not been set up, call setup() first");
+        return mainEbos_.get();
+    }
+
+    EbosSimulator& ebosSimulator()
+    {
+        return *flowMain_()->getSimulatorPtr();
+    }
+
     const std::string deckFilename_;
+    std::unique_ptr<Opm::Main> main_;
+    std::unique_ptr<FlowMainEbosType> mainEbos_;
 };
 
 PYBIND11_MODULE(simulators, m)
 {
     py::class_<BlackOilSimulator>(m, "BlackOilSimulator")
         .def(py::init< const std::string& >())
-        .def("run", &BlackOilSimulator::run);
+        .def("run", &BlackOilSimulator::run)
+        .def("setup", &BlackOilSimulator::setup)
+        .def("step", &BlackOilSimulator::step)
+        .def("done", &BlackOilSimulator::done)
+        .def("cleanup", &BlackOilSimulator::cleanup)
+        .def("current_step", &BlackOilSimulator::currentStep)
+        .def("get_primary_variables", &BlackOilSimulator::primaryVariables)
+        .def("get_well_rates", &BlackOilSimulator::wellRates)
+        .def("get_well_names", &BlackOilSimulator::wellNames);
 }
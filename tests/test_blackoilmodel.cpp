@@ -0,0 +1,322 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE BlackoilModelTest
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <boost/test/unit_test.hpp>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <opm/simulators/flow/FlowMainEbos.hpp>
+#include <opm/simulators/flow/BlackoilModelEbos.hpp>
+#include <opm/simulators/flow/NonlinearSolverEbos.hpp>
+#include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
+#include <opm/simulators/timestepping/SimulatorTimer.hpp>
+
+#include <ebos/eclproblem.hh>
+#include <opm/models/utils/start.hh>
+
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/Parser/ErrorGuard.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using TypeTag = TTAG(EclFlowProblem);
+using Simulator = GET_PROP_TYPE(TypeTag, Simulator);
+using Vanguard = GET_PROP_TYPE(TypeTag, Vanguard);
+using ElementContext = GET_PROP_TYPE(TypeTag, ElementContext);
+using FluidSystem = GET_PROP_TYPE(TypeTag, FluidSystem);
+using IntensiveQuantities = GET_PROP_TYPE(TypeTag, IntensiveQuantities);
+using Model = Opm::BlackoilModelEbos<TypeTag>;
+using Solver = Opm::NonlinearSolverEbos<TypeTag, Model>;
+
+struct GlobalFixture {
+    GlobalFixture()
+    {
+        const char *tmp[] = {"test_blackoilmodel",
+                             "--ecl-deck-file-name=SUMMARY_DECK_NON_CONSTANT_POROSITY.DATA",
+                             "--enable-ecl-output=false"};
+        int argcDummy = sizeof(tmp)/sizeof(tmp[0]);
+        char **argvDummy = const_cast<char**>(tmp);
+
+        // MPI setup.
+#if HAVE_DUNE_FEM
+        Dune::Fem::MPIManager::initialize(argcDummy, argvDummy);
+#else
+        Dune::MPIHelper::instance(argcDummy, argvDummy);
+#endif
+
+        Opm::FlowMainEbos<TypeTag>::setupParameters_(argcDummy, argvDummy);
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(GlobalFixture);
+
+namespace {
+    const std::string defaultDeck = "SUMMARY_DECK_NON_CONSTANT_POROSITY.DATA";
+
+    Opm::Deck parseDeck(const std::string& deckFile)
+    {
+        Opm::Parser parser;
+        Opm::ParseContext parseContext;
+        Opm::ErrorGuard errorGuard;
+        return parser.parseFile(deckFile, parseContext, errorGuard);
+    }
+
+    // A simulator of the given deck at the start of the first report step
+    // together with a nonlinear solver owning the model to test.
+    struct SetupModel
+    {
+        SetupModel(const bool enableStepCheckpoint, const int extrapolationOrder,
+                   const std::string& deckFile = defaultDeck)
+            : deck(parseDeck(deckFile))
+        {
+            Vanguard::setExternalDeck(&deck);
+            simulator = std::make_unique<Simulator>();
+            simulator->model().applyInitialSolution();
+
+            Opm::BlackoilModelParametersEbos<TypeTag> param;
+            param.enable_step_checkpoint_ = enableStepCheckpoint;
+            param.initial_guess_extrapolation_order_ = extrapolationOrder;
+            auto model = std::make_unique<Model>(*simulator, param,
+                                                 simulator->problem().wellModel(),
+                                                 /*terminal_output=*/false);
+            solver = std::make_unique<Solver>(typename Solver::SolverParameters(), std::move(model));
+
+            timer.init(simulator->vanguard().schedule().getTimeMap());
+            simulator->startNextEpisode(simulator->startTime(), timer.currentStepLength());
+            simulator->setEpisodeIndex(timer.currentStepNum());
+            solver->model().beginReportStep();
+        }
+
+        Opm::Deck deck;
+        std::unique_ptr<Simulator> simulator;
+        std::unique_ptr<Solver> solver;
+        Opm::SimulatorTimer timer;
+    };
+
+    // The values of the intensive quantities compared by the tests.
+    std::vector<double> intensiveValues(const IntensiveQuantities& intQuants)
+    {
+        std::vector<double> values;
+        const auto& fs = intQuants.fluidState();
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                continue;
+            }
+            values.push_back(Opm::getValue(fs.pressure(phaseIdx)));
+            values.push_back(Opm::getValue(fs.saturation(phaseIdx)));
+            values.push_back(Opm::getValue(fs.invB(phaseIdx)));
+            values.push_back(Opm::getValue(fs.density(phaseIdx)));
+            values.push_back(Opm::getValue(intQuants.mobility(phaseIdx)));
+        }
+        values.push_back(Opm::getValue(fs.Rs()));
+        values.push_back(Opm::getValue(intQuants.porosity()));
+        return values;
+    }
+
+    // Run the given number of time steps, then chop the next one after a
+    // few Newton iterations. Check that the model is back at the start of
+    // the step with the intensive quantities updateFailed() computes.
+    void checkChoppedStep(const int extrapolationOrder, const int numSteps)
+    {
+        SetupModel setup(/*enableStepCheckpoint=*/true, extrapolationOrder);
+        auto& solver = *setup.solver;
+        auto& model = solver.model();
+        auto& ebosModel = setup.simulator->model();
+
+        const double dt = 1.0*Opm::unit::day;
+        Opm::AdaptiveSimulatorTimer subTimer(setup.timer, dt);
+        for (int step = 0; step < numSteps; ++step) {
+            const auto report = solver.step(subTimer);
+            BOOST_REQUIRE(report.converged);
+            subTimer.provideTimeStepEstimate(dt);
+            ++subTimer;
+        }
+
+        model.prepareStep(subTimer);
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            model.nonlinearIteration(iteration, subTimer, solver);
+        }
+
+        const auto& solution = ebosModel.solution(/*timeIdx=*/0);
+        const auto& start = ebosModel.solution(/*timeIdx=*/1);
+        const unsigned numDof = solution.size();
+        int numChanged = 0;
+        for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            if (solution[dofIdx] != start[dofIdx]) {
+                ++numChanged;
+            }
+        }
+        BOOST_REQUIRE(numChanged > 0);
+
+        // chop the step
+        subTimer.setLastStepFailed(true);
+        model.prepareStep(subTimer);
+
+        std::vector<std::vector<double>> restored(numDof);
+        for (unsigned dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            BOOST_CHECK(solution[dofIdx] == start[dofIdx]);
+            BOOST_CHECK_EQUAL(solution[dofIdx].primaryVarsMeaning(), start[dofIdx].primaryVarsMeaning());
+            const auto* intQuants = ebosModel.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/0);
+            BOOST_REQUIRE(intQuants);
+            restored[dofIdx] = intensiveValues(*intQuants);
+        }
+
+        // recompute all intensive quantities from the start of the step
+        ebosModel.updateFailed();
+        ElementContext elemCtx(*setup.simulator);
+        for (const auto& elem : elements(setup.simulator->gridView())) {
+            elemCtx.updatePrimaryStencil(elem);
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            const unsigned dofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+            const auto expected = intensiveValues(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0));
+            BOOST_CHECK_EQUAL_COLLECTIONS(restored[dofIdx].begin(), restored[dofIdx].end(),
+                                          expected.begin(), expected.end());
+        }
+    }
+
+    // Run the given number of time steps, then chop the next one after a
+    // few Newton iterations and redo it with half the step size. Return the
+    // solution at the end of the redone step.
+    std::vector<double> redoChoppedStep(const bool enableStepCheckpoint, const std::string& deckFile,
+                                        const int numSteps)
+    {
+        SetupModel setup(enableStepCheckpoint, /*extrapolationOrder=*/0, deckFile);
+        auto& solver = *setup.solver;
+        auto& model = solver.model();
+
+        const double dt = 1.0*Opm::unit::day;
+        Opm::AdaptiveSimulatorTimer subTimer(setup.timer, dt);
+        for (int step = 0; step < numSteps; ++step) {
+            const auto report = solver.step(subTimer);
+            BOOST_REQUIRE(report.converged);
+            subTimer.provideTimeStepEstimate(dt);
+            ++subTimer;
+        }
+
+        model.prepareStep(subTimer);
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            model.nonlinearIteration(iteration, subTimer, solver);
+        }
+
+        subTimer.provideTimeStepEstimate(0.5*dt);
+        subTimer.setLastStepFailed(true);
+        const auto report = solver.step(subTimer);
+        BOOST_REQUIRE(report.converged);
+
+        std::vector<double> values;
+        for (const auto& priVars : setup.simulator->model().solution(/*timeIdx=*/0)) {
+            values.push_back(static_cast<double>(priVars.primaryVarsMeaning()));
+            for (const auto& value : priVars) {
+                values.push_back(value);
+            }
+        }
+        return values;
+    }
+} // Anonymous namespace
+
+BOOST_AUTO_TEST_CASE(RestoreChoppedStep)
+{
+    checkChoppedStep(/*extrapolationOrder=*/0, /*numSteps=*/1);
+}
+
+BOOST_AUTO_TEST_CASE(RestoreChoppedStepWithExtrapolation)
+{
+    // Enough converged steps for the extrapolation to be applied in the
+    // chopped step. Whether the extrapolated guess is kept or rejected by
+    // rejectPrediction_(), the checkpoint has to undo it.
+    checkChoppedStep(/*extrapolationOrder=*/1, /*numSteps=*/2);
+    checkChoppedStep(/*extrapolationOrder=*/2, /*numSteps=*/3);
+}
+
+BOOST_AUTO_TEST_CASE(RedoChoppedStepWithDRSDT)
+{
+    // The gas dissolution limit of DRSDT depends on the step size and on
+    // the Rs of the previous step. A chopped step redone with half the step
+    // size has to give the same solution with and without the checkpoint.
+    const std::string deckFile = "DRSDT_CHOP.DATA";
+    const auto expected = redoChoppedStep(/*enableStepCheckpoint=*/false, deckFile, /*numSteps=*/2);
+    const auto values = redoChoppedStep(/*enableStepCheckpoint=*/true, deckFile, /*numSteps=*/2);
+    BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(ExtrapolationWeights)
+{
+    // linear through the states at the times 2 and 1, newest first
+    {
+        const auto weights = Model::extrapolationWeights({ 2.0, 1.0 }, 3.0);
+        BOOST_REQUIRE_EQUAL(weights.size(), 2U);
+        BOOST_CHECK_CLOSE(weights[0], 2.0, 1.0e-10);
+        BOOST_CHECK_CLOSE(weights[1], -1.0, 1.0e-10);
+    }
+
+    // quadratic through the states at the times 3, 2 and 1
+    {
+        const auto weights = Model::extrapolationWeights({ 3.0, 2.0, 1.0 }, 4.0);
+        BOOST_REQUIRE_EQUAL(weights.size(), 3U);
+        BOOST_CHECK_CLOSE(weights[0], 3.0, 1.0e-10);
+        BOOST_CHECK_CLOSE(weights[1], -3.0, 1.0e-10);
+        BOOST_CHECK_CLOSE(weights[2], 1.0, 1.0e-10);
+    }
+
+    // unevenly spaced times, the weights reproduce a quadratic exactly
+    {
+        const std::vector<double> times = { 10.0, 4.0, 1.0 };
+        const double t = 25.0;
+        const auto weights = Model::extrapolationWeights(times, t);
+        double predicted = 0.0;
+        double sum = 0.0;
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            predicted += weights[i] * (times[i] * times[i] - 3.0 * times[i] + 2.0);
+            sum += weights[i];
+        }
+        BOOST_CHECK_CLOSE(predicted, t * t - 3.0 * t + 2.0, 1.0e-10);
+        BOOST_CHECK_CLOSE(sum, 1.0, 1.0e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AcceptPrediction)
+{
+    const double previous_residual = 0.5;
+
+    // a smaller largest residual norm keeps the prediction
+    BOOST_CHECK(Model::acceptPrediction(false, { 0.1, 0.4, 0.2 }, previous_residual));
+    BOOST_CHECK(Model::acceptPrediction(false, { 0.5 }, previous_residual));
+
+    // a larger one rejects it, even if only a single norm increased
+    BOOST_CHECK(!Model::acceptPrediction(false, { 0.1, 0.6, 0.2 }, previous_residual));
+
+    // a converged prediction is always kept
+    BOOST_CHECK(Model::acceptPrediction(true, { 0.1, 0.6, 0.2 }, previous_residual));
+}
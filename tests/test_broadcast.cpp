@@ -0,0 +1,126 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestBroadcast
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <ebos/eclmpiserializer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Item
+{
+    std::string name;
+    std::vector<double> values;
+
+    template<class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(name);
+        serializer(values);
+    }
+
+    bool operator==(const Item& other) const
+    {
+        return name == other.name && values == other.values;
+    }
+};
+
+struct Data
+{
+    int id = 0;
+    std::vector<Item> items;
+    std::map<std::string, std::vector<int>> groups;
+
+    template<class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(id);
+        serializer.vector(items);
+        serializer.template map<decltype(groups), false>(groups);
+    }
+
+    bool operator==(const Data& other) const
+    {
+        return id == other.id && items == other.items && groups == other.groups;
+    }
+};
+
+Data makeData()
+{
+    Data data;
+    data.id = 42;
+    for (int i = 0; i < 50; ++i) {
+        Item item;
+        item.name = "ITEM" + std::to_string(i);
+        item.values.assign(i * 7, 0.5 * i);
+        data.items.push_back(item);
+        data.groups["G" + std::to_string(i % 7)].push_back(i);
+    }
+    return data;
+}
+
+void checkBroadcast(const std::size_t chunkSize)
+{
+    auto comm = Dune::MPIHelper::getCollectiveCommunication();
+    Data data;
+    if (comm.rank() == 0)
+        data = makeData();
+
+    Opm::EclMpiSerializer ser(comm, chunkSize);
+    ser.broadcast(data);
+    BOOST_CHECK(data == makeData());
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(SingleChunk)
+{
+    checkBroadcast(64*1024*1024);
+}
+
+BOOST_AUTO_TEST_CASE(ManyChunks)
+{
+    checkBroadcast(256);
+}
+
+BOOST_AUTO_TEST_CASE(ChunksSmallerThanValues)
+{
+    checkBroadcast(1);
+}
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
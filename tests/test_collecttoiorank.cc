@@ -0,0 +1,177 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+#include "config.h"
+
+#include <ebos/eclproblem.hh>
+#include <ebos/collecttoiorank.hh>
+#include <opm/models/utils/start.hh>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define CHECK(value, expected)             \
+    {                                      \
+         if ((value) != (expected)) {      \
+             std::cerr << "Test failure: ";     \
+             std::cerr << "expected value " << expected << " != " << value << std::endl; \
+             throw std::runtime_error("Test failed"); \
+         }                                 \
+    }
+
+BEGIN_PROPERTIES
+
+NEW_TYPE_TAG(TestCollectToIORankTypeTag, INHERITS_FROM(BlackOilModel, EclBaseProblem));
+SET_BOOL_PROP(TestCollectToIORankTypeTag, EnableGravity, false);
+SET_BOOL_PROP(TestCollectToIORankTypeTag, EnableAsyncEclOutput, false);
+
+END_PROPERTIES
+
+namespace {
+template <class TypeTag>
+std::unique_ptr<typename GET_PROP_TYPE(TypeTag, Simulator)>
+initSimulator(const char *filename)
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+
+    std::string filenameArg = "--ecl-deck-file-name=";
+    filenameArg += filename;
+
+    const char* argv[] = {
+        "test_collecttoiorank",
+        filenameArg.c_str()
+    };
+
+    Opm::setupParameters_<TypeTag>(/*argc=*/sizeof(argv)/sizeof(argv[0]), argv, /*registerParams=*/false);
+
+    return std::unique_ptr<Simulator>(new Simulator);
+}
+
+// Cell data holding the Cartesian index of every local cell and one well
+// per rank, the values differ between the calls by offset.
+template <class Vanguard>
+void localData(const Vanguard& vanguard,
+               double offset,
+               Opm::data::Solution& cellData,
+               Opm::data::Wells& wellData)
+{
+    const int rank = vanguard.grid().comm().rank();
+    const std::size_t numCells = vanguard.grid().size(0);
+    std::vector<double> cartIdx(numCells);
+    for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        cartIdx[cellIdx] = vanguard.cartesianIndex(cellIdx) + offset;
+
+    cellData = {};
+    cellData.insert("PRESSURE", Opm::UnitSystem::measure::pressure,
+                    std::move(cartIdx), Opm::data::TargetType::RESTART_SOLUTION);
+
+    Opm::data::Well well;
+    well.bhp = rank + offset;
+    well.thp = 0.0;
+    well.temperature = 0.0;
+    well.control = 0;
+    wellData.clear();
+    wellData["W_" + std::to_string(rank)] = well;
+}
+
+// The split collection has to give the same global data as the blocking
+// one, also when it is started again before being finished.
+void test_startFinishCollect()
+{
+    typedef typename TTAG(TestCollectToIORankTypeTag) TypeTag;
+    typedef typename GET_PROP_TYPE(TypeTag, Vanguard) Vanguard;
+    typedef Opm::CollectDataToIORank<Vanguard> CollectDataToIORankType;
+
+    auto simulator = initSimulator<TypeTag>("SUMMARY_DECK_NON_CONSTANT_POROSITY.DATA");
+    const auto& vanguard = simulator->vanguard();
+    CollectDataToIORankType collectToIORank(vanguard);
+    const int numRanks = vanguard.grid().comm().size();
+
+    const std::vector<int> noSlots;
+    const std::vector<double> noValues;
+    const Opm::data::Group noGroups;
+    Opm::data::Solution cellData;
+    Opm::data::Wells wellData;
+
+    for (double offset : {0.0, 0.5}) {
+        localData(vanguard, offset, cellData, wellData);
+        collectToIORank.collect(cellData, noSlots, noValues, wellData, noGroups);
+        Opm::data::Solution blockingCellData;
+        Opm::data::Wells blockingWellData;
+        if (collectToIORank.isIORank()) {
+            blockingCellData = collectToIORank.globalCellData();
+            blockingWellData = collectToIORank.globalWellData();
+        }
+
+        // start a collection which is superseded without being waited for
+        localData(vanguard, offset + 1.0, cellData, wellData);
+        collectToIORank.startCollect(cellData, noSlots, noValues, wellData, noGroups);
+
+        localData(vanguard, offset, cellData, wellData);
+        collectToIORank.startCollect(cellData, noSlots, noValues, wellData, noGroups);
+        // the local data may change once the collection has been started
+        localData(vanguard, offset + 2.0, cellData, wellData);
+        collectToIORank.progressCollect();
+        CHECK(collectToIORank.collectPending(), collectToIORank.isParallel());
+        collectToIORank.finishCollect();
+        CHECK(collectToIORank.collectPending(), false);
+
+        if (!collectToIORank.isIORank() || !collectToIORank.isParallel())
+            continue;
+
+        const auto& global = collectToIORank.globalCellData().data("PRESSURE");
+        const auto& expected = blockingCellData.data("PRESSURE");
+        CHECK(global.size(), expected.size());
+        CHECK(global.size(), collectToIORank.numCells());
+        for (std::size_t cellIdx = 0; cellIdx < global.size(); ++cellIdx) {
+            CHECK(global[cellIdx], expected[cellIdx]);
+            const int cartIdx = vanguard.equilCartesianIndexMapper().cartesianIndex(cellIdx);
+            CHECK(global[cellIdx], cartIdx + offset);
+        }
+
+        const auto& globalWells = collectToIORank.globalWellData();
+        CHECK(globalWells.size(), static_cast<std::size_t>(numRanks));
+        CHECK(blockingWellData.size(), globalWells.size());
+        for (int rank = 0; rank < numRanks; ++rank) {
+            const std::string name = "W_" + std::to_string(rank);
+            CHECK(globalWells.at(name).bhp, rank + offset);
+            CHECK(blockingWellData.at(name).bhp, rank + offset);
+        }
+    }
+}
+} // Anonymous namespace
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    typedef TTAG(TestCollectToIORankTypeTag) TypeTag;
+    Opm::registerAllParameters_<TypeTag>();
+    test_startFinishCollect();
+
+    return 0;
+}
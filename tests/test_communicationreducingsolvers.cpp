@@ -0,0 +1,218 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestCommunicationReducingSolvers
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/GlobalDotProducts.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+#if HAVE_MPI
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+using Comm = Dune::OwnerOverlapCopyCommunication<int, int>;
+
+namespace
+{
+
+double exactSolution(const int globalIndex)
+{
+    return 1.0 + std::sin(0.1 * globalIndex);
+}
+
+// The 1D Laplacian with Dirichlet boundaries, distributed in contiguous
+// blocks of numOwned cells with one overlap cell on each side of a
+// block. The overlap rows only have a unit diagonal.
+struct DistributedLaplacian
+{
+    explicit DistributedLaplacian(const int numOwned)
+        : comm(MPI_COMM_WORLD)
+    {
+        const int rank = comm.communicator().rank();
+        const int numGlobal = numOwned * comm.communicator().size();
+        start = rank * numOwned;
+        end = start + numOwned;
+        first = std::max(start - 1, 0);
+        const int last = std::min(end + 1, numGlobal);
+        const int numLocal = last - first;
+
+        using LocalIndex = Comm::ParallelIndexSet::LocalIndex;
+        auto& indexSet = comm.indexSet();
+        indexSet.beginResize();
+        for (int g = first; g < last; ++g) {
+            const auto attribute = isOwned(g) ? Dune::OwnerOverlapCopyAttributeSet::owner
+                                              : Dune::OwnerOverlapCopyAttributeSet::copy;
+            indexSet.add(g, LocalIndex(g - first, attribute, true));
+        }
+        indexSet.endResize();
+        comm.remoteIndices().rebuild<false>();
+
+        matrix.setSize(numLocal, numLocal, 3 * numLocal);
+        matrix.setBuildMode(Matrix::row_wise);
+        for (auto row = matrix.createbegin(); row != matrix.createend(); ++row) {
+            const int i = row.index();
+            row.insert(i);
+            if (isOwned(i + first)) {
+                if (i > 0) {
+                    row.insert(i - 1);
+                }
+                if (i + 1 < numLocal) {
+                    row.insert(i + 1);
+                }
+            }
+        }
+        matrix = 0.0;
+
+        rhs.resize(numLocal);
+        for (int i = 0; i < numLocal; ++i) {
+            const int g = i + first;
+            if (isOwned(g)) {
+                matrix[i][i] = 2.0;
+                rhs[i] = 2.0 * exactSolution(g);
+                if (i > 0) {
+                    matrix[i][i - 1] = -1.0;
+                    rhs[i] -= exactSolution(g - 1);
+                }
+                if (i + 1 < numLocal) {
+                    matrix[i][i + 1] = -1.0;
+                    rhs[i] -= exactSolution(g + 1);
+                }
+            } else {
+                matrix[i][i] = 1.0;
+                rhs[i] = exactSolution(g);
+            }
+        }
+    }
+
+    bool isOwned(const int globalIndex) const
+    {
+        return globalIndex >= start && globalIndex < end;
+    }
+
+    Comm comm;
+    Matrix matrix;
+    Vector rhs;
+    int start = 0;
+    int end = 0;
+    int first = 0;
+};
+
+void testSolver(const std::string& solverType)
+{
+    DistributedLaplacian problem(20);
+
+    boost::property_tree::ptree prm;
+    prm.put("solver", solverType);
+    prm.put("tol", 1e-12);
+    prm.put("maxiter", 1000);
+    prm.put("verbosity", 0);
+    prm.put("preconditioner.type", "ILU0");
+
+    Dune::FlexibleSolver<Matrix, Vector> solver(prm, problem.matrix, std::function<Vector()>(), problem.comm);
+    Vector x(problem.rhs.size());
+    x = 0.0;
+    Vector rhs(problem.rhs);
+    Dune::InverseOperatorResult res;
+    solver.apply(x, rhs, res);
+
+    BOOST_CHECK(res.converged);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const int g = i + problem.first;
+        if (problem.isOwned(g)) {
+            BOOST_CHECK_CLOSE(x[i][0], exactSolution(g), 1e-6);
+        }
+    }
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(PipelinedBiCGSTAB)
+{
+    testSolver("pipelinedbicgstab");
+}
+
+BOOST_AUTO_TEST_CASE(SStepGMRes)
+{
+    testSolver("sstepgmres");
+}
+
+BOOST_AUTO_TEST_CASE(DotProductsOfUnindexedEntries)
+{
+    DistributedLaplacian problem(20);
+    const int numProcs = problem.comm.communicator().size();
+    const int numLocal = problem.rhs.size();
+    Dune::GlobalDotProducts dots(problem.comm);
+
+    // Every cell is owned once.
+    Vector ones(numLocal);
+    ones = 1.0;
+    std::vector<double> values = { dots.local(ones, ones) };
+    dots.sum(values);
+    BOOST_CHECK_EQUAL(values[0], 20.0 * numProcs);
+
+    // An entry missing in the index set counts as owned.
+    Vector longer(numLocal + 1);
+    longer = 1.0;
+    values = { dots.local(longer, longer) };
+    dots.sum(values);
+    BOOST_CHECK_EQUAL(values[0], 21.0 * numProcs);
+
+    // And the owned entries beyond a shorter vector are left out.
+    Vector shorter(numLocal - 1);
+    shorter = 1.0;
+    values = { dots.local(shorter, shorter), dots.local(ones, ones) };
+    dots.sum(values);
+    const double lastOwned = problem.isOwned(problem.first + numLocal - 1) ? 1.0 : 0.0;
+    BOOST_CHECK_EQUAL(values[0], 20.0 * numProcs - problem.comm.communicator().sum(lastOwned));
+    BOOST_CHECK_EQUAL(values[1], 20.0 * numProcs);
+}
+
+#endif // HAVE_MPI
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
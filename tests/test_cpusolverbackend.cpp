@@ -0,0 +1,179 @@
+/*
+  Copyright 2020 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE CpuSolverBackendTest
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opm/simulators/linalg/bda/cpuSolverBackend.hpp>
+#include <opm/simulators/linalg/bda/WellContributions.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+
+// block-CSR matrix of a 1D Laplacian with diagonal dominant blocks
+struct BsrSystem
+{
+    int Nb;
+    int bs;
+    std::vector<int> rows;
+    std::vector<int> cols;
+    std::vector<double> vals;
+    std::vector<double> b;
+
+    BsrSystem(int Nb_, int bs_)
+        : Nb(Nb_), bs(bs_)
+    {
+        rows.push_back(0);
+        for (int row = 0; row < Nb; ++row) {
+            for (int col = std::max(row - 1, 0); col <= std::min(row + 1, Nb - 1); ++col) {
+                cols.push_back(col);
+                for (int i = 0; i < bs; ++i) {
+                    for (int j = 0; j < bs; ++j) {
+                        double val = 0.0;
+                        if (row == col) {
+                            val = (i == j) ? 4.0 : 0.1 * (i + 1) / (j + 2);
+                        } else if (i == j) {
+                            val = -1.0;
+                        }
+                        vals.push_back(val);
+                    }
+                }
+            }
+            rows.push_back(cols.size());
+        }
+        for (int i = 0; i < Nb * bs; ++i) {
+            b.push_back(1.0 + 0.01 * i);
+        }
+    }
+
+    // y = A * x
+    std::vector<double> mv(const std::vector<double>& x) const
+    {
+        std::vector<double> y(Nb * bs, 0.0);
+        for (int row = 0; row < Nb; ++row) {
+            for (int ij = rows[row]; ij < rows[row + 1]; ++ij) {
+                for (int i = 0; i < bs; ++i) {
+                    for (int j = 0; j < bs; ++j) {
+                        y[row * bs + i] += vals[(ij * bs + i) * bs + j] * x[cols[ij] * bs + j];
+                    }
+                }
+            }
+        }
+        return y;
+    }
+};
+
+double relativeResidual(const std::vector<double>& Ax, const std::vector<double>& b)
+{
+    double res = 0.0, norm = 0.0;
+    for (unsigned int i = 0; i < b.size(); ++i) {
+        res += (b[i] - Ax[i]) * (b[i] - Ax[i]);
+        norm += b[i] * b[i];
+    }
+    return std::sqrt(res / norm);
+}
+
+void testSolve(int bs)
+{
+    BsrSystem sys(50, bs);
+    const int N = sys.Nb * bs;
+    const int nnz = sys.vals.size();
+
+    Opm::cpuSolverBackend solver(0, 200, 1e-10);
+    Opm::WellContributions wellContribs(false);
+    Opm::BdaResult res;
+    auto vals = sys.vals;
+    auto b = sys.b;
+    const auto status = solver.solve_system(N, nnz, bs, vals.data(), sys.rows.data(), sys.cols.data(), b.data(), wellContribs, res);
+    BOOST_CHECK(status == Opm::cpuSolverBackend::cpuSolverStatus::CPU_SOLVER_SUCCESS);
+    BOOST_CHECK(res.converged);
+
+    std::vector<double> x(N);
+    solver.post_process(x.data());
+    BOOST_CHECK_SMALL(relativeResidual(sys.mv(x), sys.b), 1e-8);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(SolveBlockSize3)
+{
+    testSolve(3);
+}
+
+BOOST_AUTO_TEST_CASE(SolveBlockSize4)
+{
+    testSolve(4);
+}
+
+BOOST_AUTO_TEST_CASE(SolveWithStandardWell)
+{
+    const int bs = 3;
+    const int dim_wells = 4;
+    BsrSystem sys(20, bs);
+    const int N = sys.Nb * bs;
+    const int nnz = sys.vals.size();
+
+    // a well perforating cells 3, 4 and 5
+    std::vector<int> wellCols = {3, 4, 5};
+    std::vector<double> Bvals, Cvals, Dvals;
+    for (unsigned int k = 0; k < wellCols.size(); ++k) {
+        for (int i = 0; i < dim_wells; ++i) {
+            for (int j = 0; j < bs; ++j) {
+                Bvals.push_back(0.1 * (i + j + k + 1));
+                Cvals.push_back(0.05 * (i + 1) * (j + 1));
+            }
+        }
+    }
+    for (int i = 0; i < dim_wells; ++i) {
+        for (int j = 0; j < dim_wells; ++j) {
+            Dvals.push_back(i == j ? 0.5 : 0.0);
+        }
+    }
+
+    Opm::cpuSolverBackend solver(0, 200, 1e-10);
+    Opm::WellContributions wellContribs(false);
+    wellContribs.setBlockSize(bs, dim_wells);
+    wellContribs.addNumBlocks(wellCols.size());
+    wellContribs.alloc();
+    wellContribs.addMatrix(Opm::WellContributions::MatrixType::C, wellCols.data(), Cvals.data(), wellCols.size());
+    wellContribs.addMatrix(Opm::WellContributions::MatrixType::D, wellCols.data(), Dvals.data(), 1);
+    wellContribs.addMatrix(Opm::WellContributions::MatrixType::B, wellCols.data(), Bvals.data(), wellCols.size());
+
+    Opm::BdaResult res;
+    auto vals = sys.vals;
+    auto b = sys.b;
+    const auto status = solver.solve_system(N, nnz, bs, vals.data(), sys.rows.data(), sys.cols.data(), b.data(), wellContribs, res);
+    BOOST_CHECK(status == Opm::cpuSolverBackend::cpuSolverStatus::CPU_SOLVER_SUCCESS);
+    BOOST_CHECK(res.converged);
+
+    std::vector<double> x(N);
+    solver.post_process(x.data());
+
+    // (A - C^T D^-1 B) x
+    auto Ax = sys.mv(x);
+    wellContribs.apply_cpu(x.data(), Ax.data());
+    BOOST_CHECK_SMALL(relativeResidual(Ax, sys.b), 1e-8);
+}
@@ -0,0 +1,192 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestDeckCache
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/DeckCache.hpp>
+
+#include <opm/common/utility/FileSystem.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
+#include <opm/parser/eclipse/Parser/ErrorGuard.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Python/Python.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace {
+
+const std::string deckText = R"(
+RUNSPEC
+OIL
+WATER
+DIMENS
+ 2 2 2 /
+GRID
+DXV
+ 2*100 /
+DYV
+ 2*100 /
+DZV
+ 2*10 /
+TOPS
+ 4*2000 /
+INCLUDE
+ 'PERMX.INC' /
+COPY
+ PERMX PERMY /
+ PERMX PERMZ /
+/
+PORO
+ 8*0.3 /
+SUMMARY
+FOPR
+SCHEDULE
+TSTEP
+ 10 /
+END
+)";
+
+const std::string permText = "PERMX\n 8*100 /\n";
+// Same size as permText, different content.
+const std::string editedPermText = "PERMX\n 8*200 /\n";
+
+void writeFile(const Opm::filesystem::path& name, const std::string& content)
+{
+    std::ofstream os(name.string(), std::ios::binary | std::ios::trunc);
+    os << content;
+}
+
+// A case with an included file in a temporary directory, and the
+// cached objects of it.
+struct CachedCase
+{
+    CachedCase()
+    {
+        char dirTemplate[] = "/tmp/opm-deckcache-XXXXXX";
+        BOOST_REQUIRE(mkdtemp(dirTemplate) != nullptr);
+        dir = dirTemplate;
+        deckFile = (dir / "CASE.DATA").string();
+        includeFile = (dir / "PERMX.INC").string();
+        writeFile(deckFile, deckText);
+        writeFile(includeFile, permText);
+    }
+
+    ~CachedCase()
+    {
+        Opm::filesystem::remove_all(dir);
+    }
+
+    void store(const Opm::DeckCache& cache)
+    {
+        Opm::Parser parser;
+        Opm::ParseContext parseContext;
+        Opm::ErrorGuard errorGuard;
+        Opm::Deck deck = parser.parseFile(deckFile, parseContext, errorGuard);
+        Opm::EclipseState eclState(deck);
+        Opm::Schedule schedule(deck, eclState, parseContext, errorGuard, python);
+        Opm::SummaryConfig summaryConfig(deck, schedule, eclState.getTableManager(), parseContext, errorGuard);
+        cache.store(deck, schedule, summaryConfig);
+        numKeywords = deck.size();
+    }
+
+    bool load(const Opm::DeckCache& cache)
+    {
+        Opm::Deck deck;
+        Opm::Schedule schedule(python);
+        Opm::SummaryConfig summaryConfig;
+        const bool loaded = cache.load(deck, schedule, summaryConfig);
+        if (loaded) {
+            BOOST_CHECK_EQUAL(deck.size(), numKeywords);
+            BOOST_CHECK(deck.hasKeyword("PERMX"));
+            BOOST_CHECK(summaryConfig.hasKeyword("FOPR"));
+        }
+        return loaded;
+    }
+
+    Opm::filesystem::path dir;
+    std::string deckFile;
+    std::string includeFile;
+    std::shared_ptr<Opm::Python> python = std::make_shared<Opm::Python>();
+    std::size_t numKeywords = 0;
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(StoreAndLoad)
+{
+    CachedCase c;
+    const Opm::DeckCache cache((c.dir / "cache").string(), c.deckFile, "options");
+    BOOST_CHECK(!c.load(cache));
+
+    c.store(cache);
+    BOOST_CHECK(Opm::filesystem::exists(cache.fileName()));
+    BOOST_CHECK(c.load(cache));
+}
+
+BOOST_AUTO_TEST_CASE(EditedIncludeFile)
+{
+    CachedCase c;
+    const Opm::DeckCache cache((c.dir / "cache").string(), c.deckFile, "options");
+    c.store(cache);
+
+    // The size is unchanged, only the hash detects the edit.
+    writeFile(c.includeFile, editedPermText);
+    BOOST_CHECK(!c.load(cache));
+
+    writeFile(c.includeFile, permText);
+    BOOST_CHECK(c.load(cache));
+}
+
+BOOST_AUTO_TEST_CASE(DifferentOptions)
+{
+    CachedCase c;
+    const std::string cacheDir = (c.dir / "cache").string();
+    const Opm::DeckCache cache(cacheDir, c.deckFile, "EclStrictParsing=0 SchedRestart=0");
+    c.store(cache);
+
+    const Opm::DeckCache otherCache(cacheDir, c.deckFile, "EclStrictParsing=1 SchedRestart=0");
+    BOOST_CHECK_EQUAL(otherCache.fileName(), cache.fileName());
+    BOOST_CHECK(!c.load(otherCache));
+    BOOST_CHECK(c.load(cache));
+}
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
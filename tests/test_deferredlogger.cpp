@@ -98,3 +98,26 @@ BOOST_AUTO_TEST_CASE(deferredlogger)
     BOOST_CHECK_EQUAL(log_stream.str(), expected);
 
 }
+
+BOOST_AUTO_TEST_CASE(appendmessages)
+{
+    const std::string expected = Log::prefixMessage(Log::MessageType::Info, "info 1") + "\n"
+        + Log::prefixMessage(Log::MessageType::Warning, "warning 1") + "\n"
+        + Log::prefixMessage(Log::MessageType::Info, "info 2") + "\n";
+
+    std::ostringstream log_stream;
+    initLogger(log_stream);
+    auto deferred_logger = Opm::DeferredLogger();
+    auto other_logger = Opm::DeferredLogger();
+    deferred_logger.info("info 1");
+    other_logger.warning("warning 1");
+    other_logger.info("info 2");
+
+    deferred_logger.appendMessages(other_logger);
+    deferred_logger.logMessages();
+    BOOST_CHECK_EQUAL(log_stream.str(), expected);
+
+    // The messages were moved, logging the other logger adds nothing.
+    other_logger.logMessages();
+    BOOST_CHECK_EQUAL(log_stream.str(), expected);
+}
@@ -126,6 +126,35 @@ BOOST_AUTO_TEST_CASE(TestFlexibleSolver)
     }
 }
 
+BOOST_AUTO_TEST_CASE(TestCommunicationReducingSolvers)
+{
+    namespace pt = boost::property_tree;
+    pt::ptree prm;
+
+    // Read parameters.
+    {
+        std::ifstream file("options_flexiblesolver.json");
+        pt::read_json(file, prm);
+    }
+    prm.put("tol", 1e-8);
+    prm.put("maxiter", 200);
+    prm.put("verbosity", 0);
+    prm.put("preconditioner.verbosity", 0);
+
+    // The solutions of the system in matr33.txt and rhs3.txt, as above.
+    const std::vector<double> expected {-1.62493, -458.542, -1.48005};
+
+    for (const std::string solver : {"pipelinedbicgstab", "sstepgmres"}) {
+        prm.put("solver", solver);
+        const int bz = 3;
+        auto sol = testSolver<bz>(prm, "matr33.txt", "rhs3.txt");
+        BOOST_REQUIRE_EQUAL(sol.size(), expected.size());
+        for (size_t i = 0; i < sol.size(); ++i) {
+            BOOST_CHECK_CLOSE(sol[i][0], expected[i], 1e-3);
+        }
+    }
+}
+
 #else
 
 // Do nothing if we do not have at least Dune 2.6.
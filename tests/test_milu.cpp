@@ -196,3 +196,119 @@ BOOST_AUTO_TEST_CASE(MILULaplace4)
 {
     test<4>();
 }
+
+//! Apply two preconditioners to the same right hand side and compare the
+//! results entry by entry.
+template<class Vector, class Prec1, class Prec2, class Compare>
+void compareApply(Prec1& prec1, Prec2& prec2, std::size_t n, Compare compare)
+{
+    const int bsize = Vector::block_type::dimension;
+    Vector d(n), v1(n), v2(n);
+    for ( std::size_t i = 0; i < d.size(); ++i )
+    {
+        for ( int j = 0; j < bsize; ++j )
+        {
+            d[i][j] = 1.0 + 0.1 * ((i * bsize + j) % 7);
+        }
+    }
+    v1 = 0;
+    v2 = 0;
+    prec1.apply(v1, d);
+    prec2.apply(v2, d);
+
+    for ( std::size_t i = 0; i < d.size(); ++i )
+    {
+        for ( int j = 0; j < bsize; ++j )
+        {
+            compare(v1[i][j], v2[i][j]);
+        }
+    }
+}
+
+template<int bsize>
+void testLevelScheduling(bool redblack)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize> >;
+    std::size_t N = 32;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> serial(A, 0, 1.0, Opm::MILU_VARIANT::ILU, redblack, true, false);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> levels(A, 0, 1.0, Opm::MILU_VARIANT::ILU, redblack, true, true);
+
+    // Each row is computed in the same way, hence the results have to be identical.
+    compareApply<Vector>(serial, levels, A.N(),
+                         [](double v1, double v2) { BOOST_CHECK_EQUAL(v1, v2); });
+}
+
+BOOST_AUTO_TEST_CASE(ILULevelScheduling)
+{
+    testLevelScheduling<1>(false);
+    testLevelScheduling<3>(false);
+    testLevelScheduling<3>(true);
+}
+
+template<int bsize>
+void testSinglePrecision(bool levelScheduling)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize> >;
+    std::size_t N = 32;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> dbl(A, 0, 1.0, Opm::MILU_VARIANT::ILU, false, true, levelScheduling, false);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> flt(A, 0, 1.0, Opm::MILU_VARIANT::ILU, false, true, levelScheduling, true);
+
+    // Only the factors are rounded to single precision.
+    compareApply<Vector>(dbl, flt, A.N(),
+                         [](double v1, double v2) { BOOST_CHECK_CLOSE(v1, v2, 1e-3); });
+}
+
+BOOST_AUTO_TEST_CASE(ILUSinglePrecision)
+{
+    testSinglePrecision<1>(false);
+    testSinglePrecision<3>(false);
+    testSinglePrecision<3>(true);
+}
+
+template<int bsize>
+void testSinglePrecisionSmoother()
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize> >;
+    using Smoother = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector>;
+    std::size_t N = 32;
+    Matrix A;
+    setupLaplacian(A, N);
+
+    // Construct the smoother the way the AMG hierarchy does for every level.
+    typename Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+    smootherArgs.relaxationFactor = 1.0;
+    smootherArgs.setSinglePrecision(true);
+    Dune::Amg::SequentialInformation info;
+    typename Dune::Amg::ConstructionTraits<Smoother>::Arguments args;
+    args.setMatrix(A);
+    args.setArgs(smootherArgs);
+    args.setComm(info);
+    auto smoother = Dune::Amg::ConstructionTraits<Smoother>::construct(args);
+
+    // The smoother has to store its factors in single precision.
+    Smoother flt(A, 0, 1.0, Opm::MILU_VARIANT::ILU, false, true, false, true);
+    compareApply<Vector>(*smoother, flt, A.N(),
+                         [](double v1, double v2) { BOOST_CHECK_EQUAL(v1, v2); });
+    Smoother dbl(A, 0, 1.0, Opm::MILU_VARIANT::ILU, false, true, false, false);
+    compareApply<Vector>(*smoother, dbl, A.N(),
+                         [](double v1, double v2) { BOOST_CHECK_CLOSE(v1, v2, 1e-3); });
+
+#if ! DUNE_VERSION_NEWER(DUNE_ISTL, 2, 7)
+    Dune::Amg::ConstructionTraits<Smoother>::deconstruct(smoother);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(AMGSmootherSinglePrecision)
+{
+    testSinglePrecisionSmoother<1>();
+    testSinglePrecisionSmoother<3>();
+}
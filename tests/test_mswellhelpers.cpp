@@ -0,0 +1,162 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE MSWellHelpersTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/wells/MSWellHelpers.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <set>
+#include <vector>
+
+#if HAVE_UMFPACK
+
+namespace
+{
+
+constexpr int bz = 3;
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bz, bz>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, bz>>;
+
+// A non-symmetric block pattern with off-diagonal blocks on both sides
+// of the diagonal, similar to the segment matrix of a branched well.
+Matrix createMatrix(const std::vector<std::set<int>>& pattern, const double shift)
+{
+    const int n = pattern.size();
+    int nnz = 0;
+    for (const auto& row : pattern) {
+        nnz += row.size();
+    }
+    Matrix D(n, n, nnz, Matrix::row_wise);
+    for (auto row = D.createbegin(); row != D.createend(); ++row) {
+        for (const int col : pattern[row.index()]) {
+            row.insert(col);
+        }
+    }
+    for (int r = 0; r < n; ++r) {
+        for (const int c : pattern[r]) {
+            for (int i = 0; i < bz; ++i) {
+                for (int j = 0; j < bz; ++j) {
+                    D[r][c][i][j] = 0.1 * (1 + r + 2 * c) + 0.05 * (i - 2 * j) + shift;
+                }
+            }
+        }
+        // diagonally dominant
+        for (int i = 0; i < bz; ++i) {
+            D[r][r][i][i] += 10.0 + r + i;
+        }
+    }
+    return D;
+}
+
+Vector createRhs(const int n)
+{
+    Vector x(n);
+    for (int r = 0; r < n; ++r) {
+        for (int i = 0; i < bz; ++i) {
+            x[r][i] = 1.0 + 0.3 * r - 0.7 * i;
+        }
+    }
+    return x;
+}
+
+void checkSolve(const Opm::mswellhelpers::WellMatrixFactorization<Matrix, Vector>& factorization,
+                const Matrix& D)
+{
+    const Vector x = createRhs(D.N());
+    const Vector expected = Opm::mswellhelpers::invDXDirect(D, x);
+    const Vector y = factorization.solve(x);
+    BOOST_REQUIRE_EQUAL(y.size(), expected.size());
+    for (std::size_t r = 0; r < y.size(); ++r) {
+        for (int i = 0; i < bz; ++i) {
+            BOOST_CHECK_CLOSE(y[r][i], expected[r][i], 1e-10);
+        }
+    }
+}
+
+const std::vector<std::set<int>> pattern = {
+    {0, 1},
+    {0, 1, 2},
+    {2, 3},
+    {1, 3, 4},
+    {0, 4},
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(SolveMatchesUMFPack)
+{
+    const Matrix D = createMatrix(pattern, 0.0);
+    Opm::mswellhelpers::WellMatrixFactorization<Matrix, Vector> factorization;
+    BOOST_CHECK(!factorization.isFactorized());
+    factorization.factorize(D);
+    BOOST_CHECK(factorization.isFactorized());
+    checkSolve(factorization, D);
+}
+
+BOOST_AUTO_TEST_CASE(RefactorizeWithNewValuesAndPattern)
+{
+    Opm::mswellhelpers::WellMatrixFactorization<Matrix, Vector> factorization;
+    factorization.factorize(createMatrix(pattern, 0.0));
+
+    // same pattern, the symbolic analysis is reused
+    const Matrix D1 = createMatrix(pattern, 0.5);
+    factorization.factorize(D1);
+    checkSolve(factorization, D1);
+
+    // a segment added to the well
+    auto extended = pattern;
+    extended[4].insert(5);
+    extended.push_back({2, 4, 5});
+    const Matrix D2 = createMatrix(extended, 0.2);
+    factorization.factorize(D2);
+    checkSolve(factorization, D2);
+}
+
+BOOST_AUTO_TEST_CASE(CopyRefactorizes)
+{
+    const Matrix D = createMatrix(pattern, 0.3);
+    Opm::mswellhelpers::WellMatrixFactorization<Matrix, Vector> factorization;
+    factorization.factorize(D);
+
+    const auto copy = factorization;
+    checkSolve(copy, D);
+
+    Opm::mswellhelpers::WellMatrixFactorization<Matrix, Vector> assigned;
+    assigned.factorize(createMatrix(pattern, 0.0));
+    assigned = factorization;
+    checkSolve(assigned, D);
+}
+
+#else
+
+// Do nothing if we do not have UMFPACK.
+BOOST_AUTO_TEST_CASE(DummyTest)
+{
+    BOOST_REQUIRE(true);
+}
+
+#endif // HAVE_UMFPACK
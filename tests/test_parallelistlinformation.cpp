@@ -100,4 +100,24 @@ BOOST_AUTO_TEST_CASE(singleContainerReductionTest)
     comm.computeReduction(x,Opm::Reduction::makeGlobalSumFunctor<int>(),value);
     BOOST_CHECK(value==oldvalue+((N-1)*N)/2);
 }
+
+BOOST_AUTO_TEST_CASE(copyOwnerToAllTest)
+{
+    const int N=100;
+    int start, end, istart, iend;
+    std::tie(start,istart,iend,end) = computeRegions(N);
+    Opm::ParallelISTLInformation comm(MPI_COMM_WORLD);
+    auto mat = create1DLaplacian(*comm.indexSet(), N, start, end, istart, iend);
+    // Repeat the exchange to reuse the plan and the buffers.
+    for(int offset=0; offset<3; ++offset)
+    {
+        std::vector<double> x(end-start, -1.0);
+        for(auto it=comm.indexSet()->begin(), itend=comm.indexSet()->end(); it!=itend; ++it)
+            if(it->local().attribute()==Dune::OwnerOverlapCopyAttributeSet::owner)
+                x[it->local()]=it->global()+offset;
+        comm.copyOwnerToAll(x,x);
+        for(auto it=comm.indexSet()->begin(), itend=comm.indexSet()->end(); it!=itend; ++it)
+            BOOST_CHECK_EQUAL(x[it->local()], it->global()+offset);
+    }
+}
 #endif
@@ -0,0 +1,81 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestRegionAggregator
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/RegionAggregator.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <vector>
+
+using namespace Opm;
+
+BOOST_AUTO_TEST_CASE(SumsOverRegionMaps)
+{
+    // ten cells, two regions in the first map, three in the second
+    const std::vector<int> coarse = {0, 0, 0, 0, 0, 1, 1, 1, 1, 1};
+    const std::vector<int> fine = {0, 0, 1, 1, -1, -1, 2, 2, 2, 2};
+
+    RegionAggregator aggregator(2);
+    const int coarseMap = aggregator.addRegionMap(coarse, 2);
+    const int fineMap = aggregator.addRegionMap(fine, 3);
+    BOOST_CHECK_EQUAL(aggregator.numRegionMaps(), 2);
+    BOOST_CHECK_EQUAL(aggregator.numRegions(coarseMap), 2);
+    BOOST_CHECK_EQUAL(aggregator.numRegions(fineMap), 3);
+
+    // field 0 counts the cells, field 1 is the cell index
+    aggregator.accumulate(coarse.size(), [](std::size_t cellIdx, double* values) {
+        values[0] = 1.0;
+        values[1] = cellIdx;
+    });
+
+    const auto comm = Dune::MPIHelper::getCollectiveCommunication();
+    aggregator.reduce(comm);
+    const double procs = comm.size();
+
+    BOOST_CHECK_EQUAL(aggregator.sum(coarseMap, 0, 0), 5.0 * procs);
+    BOOST_CHECK_EQUAL(aggregator.sum(coarseMap, 1, 0), 5.0 * procs);
+    BOOST_CHECK_EQUAL(aggregator.sum(coarseMap, 0, 1), 10.0 * procs);
+    BOOST_CHECK_EQUAL(aggregator.sum(coarseMap, 1, 1), 35.0 * procs);
+
+    const std::vector<double> counts = aggregator.sums(fineMap, 0);
+    const std::vector<double> expected = {2.0 * procs, 2.0 * procs, 4.0 * procs};
+    BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(aggregator.sum(fineMap, 2, 1), 30.0 * procs);
+
+    aggregator.clear();
+    BOOST_CHECK_EQUAL(aggregator.sum(coarseMap, 1, 1), 0.0);
+}
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
@@ -0,0 +1,131 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestTimingRegistry
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/TimingRegistry.hpp>
+
+#include <sstream>
+
+using namespace Opm;
+
+namespace {
+
+void assembleAndSolve()
+{
+    OPM_TIMEBLOCK(newton);
+    {
+        OPM_TIMEBLOCK(assembly);
+    }
+    {
+        OPM_TIMEBLOCK(linear_solve);
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(Tree)
+{
+    auto& registry = TimingRegistry::instance();
+    registry.clear();
+
+    assembleAndSolve();
+    assembleAndSolve();
+    {
+        OPM_TIMEBLOCK(output);
+    }
+
+    const auto& nodes = registry.nodes();
+    BOOST_REQUIRE_EQUAL(nodes.size(), 5U);
+    BOOST_CHECK_EQUAL(nodes[0].children.size(), 2U);
+
+    BOOST_CHECK_EQUAL(registry.path(1), "newton");
+    BOOST_CHECK_EQUAL(registry.path(2), "newton/assembly");
+    BOOST_CHECK_EQUAL(registry.path(3), "newton/linear_solve");
+    BOOST_CHECK_EQUAL(registry.path(4), "output");
+
+    BOOST_CHECK_EQUAL(nodes[1].calls, 2U);
+    BOOST_CHECK_EQUAL(nodes[2].calls, 2U);
+    BOOST_CHECK_EQUAL(nodes[3].calls, 2U);
+    BOOST_CHECK_EQUAL(nodes[4].calls, 1U);
+    BOOST_CHECK_GE(nodes[1].seconds, nodes[2].seconds + nodes[3].seconds);
+}
+
+BOOST_AUTO_TEST_CASE(Trace)
+{
+    auto& registry = TimingRegistry::instance();
+    registry.clear();
+
+    // nothing is recorded unless enabled
+    assembleAndSolve();
+    std::ostringstream empty;
+    registry.writeTrace(empty, 0);
+    BOOST_CHECK_EQUAL(empty.str().find("\"ph\":\"X\""), std::string::npos);
+
+    registry.setTraceEnabled(true);
+    assembleAndSolve();
+    std::ostringstream trace;
+    registry.writeTrace(trace, 3);
+    registry.setTraceEnabled(false);
+
+    const auto str = trace.str();
+    BOOST_CHECK_EQUAL(str.compare(0, 15, "{\"traceEvents\":"), 0);
+    BOOST_CHECK(str.find("\"name\":\"linear_solve\",\"cat\":\"newton/linear_solve\"") != std::string::npos);
+    BOOST_CHECK(str.find("\"pid\":3") != std::string::npos);
+
+    // the events are forgotten once written
+    std::ostringstream again;
+    registry.writeTrace(again, 3);
+    BOOST_CHECK_EQUAL(again.str().find("\"ph\":\"X\""), std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Report)
+{
+    auto& registry = TimingRegistry::instance();
+    registry.clear();
+
+    assembleAndSolve();
+
+    const auto comm = Dune::MPIHelper::getCollectiveCommunication();
+    std::ostringstream report;
+    registry.report(report, comm);
+
+    if (comm.rank() == 0) {
+        const auto str = report.str();
+        BOOST_CHECK(str.find("\nnewton ") != std::string::npos);
+        BOOST_CHECK(str.find("\n  assembly ") != std::string::npos);
+        BOOST_CHECK(str.find("\n  linear_solve ") != std::string::npos);
+    }
+}
+
+bool init_unit_test_func()
+{
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
@@ -550,6 +550,51 @@ BOOST_AUTO_TEST_CASE(THPToBHPAndBackNonTrivial)
 
 
 
+/**
+ * Test that evaluations through a cached slice of the table agree with
+ * the direct evaluations, also when the fractions move between cells
+ */
+BOOST_AUTO_TEST_CASE(InterpolateSlice)
+{
+    fillDataRandom();
+    initProperties();
+
+    Opm::detail::VFPProdSlice slice;
+    const double thp = 0.3;
+    const double alq = 0.4;
+    const double liquid = -0.8;
+    int n=7;
+    for (int j=0; j<=n; ++j) {
+        const double aqua = -1.2 * j / n * (-liquid);
+        for (int k=0; k<=n; ++k) {
+            const double vapour = -1.2 * k / n * (-liquid);
+            for (int m=0; m<=n; ++m) {
+                const double flo = 1.2 * m / n;
+                const VFPEvaluation direct = Opm::detail::interpolate(*table,
+                        Opm::detail::findInterpData(flo, table->getFloAxis()),
+                        Opm::detail::findInterpData(thp, table->getTHPAxis()),
+                        Opm::detail::findInterpData(aqua/liquid, table->getWFRAxis()),
+                        Opm::detail::findInterpData(vapour/liquid, table->getGFRAxis()),
+                        Opm::detail::findInterpData(alq, table->getALQAxis()));
+                const VFPEvaluation cached = slice.interpolate(*table, flo, thp, aqua/liquid, vapour/liquid, alq);
+
+                BOOST_CHECK_EQUAL(cached.value, direct.value);
+                BOOST_CHECK_EQUAL(cached.dthp, direct.dthp);
+                BOOST_CHECK_EQUAL(cached.dwfr, direct.dwfr);
+                BOOST_CHECK_EQUAL(cached.dgfr, direct.dgfr);
+                BOOST_CHECK_EQUAL(cached.dalq, direct.dalq);
+                BOOST_CHECK_EQUAL(cached.dflo, direct.dflo);
+            }
+
+            const double bhp_val = properties->bhp(1, aqua, liquid, vapour, thp, alq);
+            BOOST_CHECK_EQUAL(properties->bhp(1, aqua, liquid, vapour, thp, alq, slice), bhp_val);
+            BOOST_CHECK_EQUAL(properties->thp(1, aqua, liquid, vapour, bhp_val, alq, slice),
+                              properties->thp(1, aqua, liquid, vapour, bhp_val, alq));
+        }
+    }
+}
+
+
 
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
 
@@ -0,0 +1,94 @@
+/*
+  Copyright 2020 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestWellColoring
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/wells/WellColoring.hpp>
+
+#include <set>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // Check that every well has exactly one colour and that the wells of a
+    // colour do not share cells.
+    void checkColoring(const std::vector<std::vector<int>>& wellCells,
+                       const std::vector<std::vector<int>>& colors)
+    {
+        std::vector<int> count(wellCells.size(), 0);
+        for (const auto& wells : colors) {
+            BOOST_CHECK(!wells.empty());
+            std::set<int> cells;
+            for (const int w : wells) {
+                ++count[w];
+                for (const int cell : wellCells[w]) {
+                    BOOST_CHECK_MESSAGE(cells.insert(cell).second,
+                                        "cell " << cell << " is shared by two wells of one colour");
+                }
+            }
+        }
+        for (const int c : count) {
+            BOOST_CHECK_EQUAL(c, 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DisjointWellsShareOneColor)
+{
+    const std::vector<std::vector<int>> wellCells = {{0, 1}, {2, 3}, {4}, {}};
+    const auto colors = colorWellsByCells(wellCells);
+    BOOST_REQUIRE_EQUAL(colors.size(), 1U);
+    const std::vector<int> expected = {0, 1, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(colors[0].begin(), colors[0].end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(WellsSharingCellsGetDifferentColors)
+{
+    // Wells 0, 1 and 2 share cell 5, well 3 only shares cell 7 with well 1.
+    const std::vector<std::vector<int>> wellCells = {{5, 6}, {5, 7}, {1, 5}, {7, 8}, {9}};
+    const auto colors = colorWellsByCells(wellCells);
+    checkColoring(wellCells, colors);
+
+    // Greedy in the order of the wells.
+    const std::vector<std::vector<int>> expected = {{0, 3, 4}, {1}, {2}};
+    BOOST_REQUIRE_EQUAL(colors.size(), expected.size());
+    for (std::size_t c = 0; c < expected.size(); ++c) {
+        BOOST_CHECK_EQUAL_COLLECTIONS(colors[c].begin(), colors[c].end(),
+                                      expected[c].begin(), expected[c].end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ChainOfWells)
+{
+    // Well w perforates the cells w and w + 1, so neighbouring wells
+    // conflict and two colours suffice.
+    std::vector<std::vector<int>> wellCells;
+    for (int w = 0; w < 20; ++w) {
+        wellCells.push_back({w, w + 1});
+    }
+    const auto colors = colorWellsByCells(wellCells);
+    checkColoring(wellCells, colors);
+    BOOST_CHECK_EQUAL(colors.size(), 2U);
+}
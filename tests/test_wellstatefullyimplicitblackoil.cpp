@@ -22,6 +22,9 @@
 #define BOOST_TEST_MODULE WellStateFIBOTest
 
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
+#include <opm/simulators/wells/GroupRates.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
+#include <opm/simulators/wells/WellGroupHelpers.hpp>
 #include <opm/parser/eclipse/Python/Python.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -38,6 +41,8 @@
 
 #include <opm/grid/GridManager.hpp>
 
+#include <dune/common/parallel/collectivecommunication.hh>
+
 #include <chrono>
 #include <cstddef>
 #include <string>
@@ -367,3 +372,341 @@ BOOST_AUTO_TEST_CASE(STOP_well)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+// ---------------------------------------------------------------------
+
+namespace {
+    void setWellValues(const std::string& name,
+                       const double bhp,
+                       const double rate,
+                       Opm::WellStateFullyImplicitBlackoil& wstate)
+    {
+        const auto w  = wstate.wellMap().at(name)[0];
+        const auto np = wstate.numPhases();
+
+        wstate.bhp()[w] = bhp;
+        for (auto p = 0*np; p < np; ++p) {
+            wstate.wellRates()[np*w + p] = rate;
+        }
+    }
+
+    void checkWellValues(const std::string& name,
+                         const double bhp,
+                         const double rate,
+                         const Opm::WellStateFullyImplicitBlackoil& wstate)
+    {
+        const auto w  = wstate.wellMap().at(name)[0];
+        const auto np = wstate.numPhases();
+
+        BOOST_CHECK_CLOSE(wstate.bhp()[w], bhp, 1.0e-10);
+        for (auto p = 0*np; p < np; ++p) {
+            BOOST_CHECK_CLOSE(wstate.wellRates()[np*w + p], rate, 1.0e-10);
+        }
+    }
+
+    // Two converged states, the newest first, and a copy of the newest one
+    // to extrapolate.
+    struct ExtrapolationStates
+    {
+        explicit ExtrapolationStates(const Setup& setup)
+            : newest(buildWellState(setup, 0))
+            , oldest(buildWellState(setup, 0))
+        {
+            setWellValues("INJE01", 200.0*Opm::unit::barsa, 10.0, newest);
+            setWellValues("INJE01", 190.0*Opm::unit::barsa, 8.0, oldest);
+            setWellValues("PROD01", 150.0*Opm::unit::barsa, -10.0, newest);
+            setWellValues("PROD01", 160.0*Opm::unit::barsa, -8.0, oldest);
+            current = newest;
+        }
+
+        void extrapolate(const double dbhp_max_rel)
+        {
+            // linear extrapolation to the next time, the states are one
+            // time unit apart
+            current.extrapolate({ &newest, &oldest }, { 2.0, -1.0 }, dbhp_max_rel);
+        }
+
+        Opm::WellStateFullyImplicitBlackoil newest;
+        Opm::WellStateFullyImplicitBlackoil oldest;
+        Opm::WellStateFullyImplicitBlackoil current;
+    };
+} // Anonymous
+
+BOOST_AUTO_TEST_SUITE(Extrapolation)
+
+BOOST_AUTO_TEST_CASE(Linear)
+{
+    const Setup setup{ "msw.data" };
+    ExtrapolationStates states(setup);
+
+    states.extrapolate(1.0);
+
+    checkWellValues("INJE01", 210.0*Opm::unit::barsa, 12.0, states.current);
+
+    // the top segment follows the well
+    const auto w      = states.current.wellMap().at("INJE01")[0];
+    const auto np     = states.current.numPhases();
+    const auto topSeg = states.current.topSegmentIndex(w);
+    BOOST_CHECK_CLOSE(states.current.segPress()[topSeg], 210.0*Opm::unit::barsa, 1.0e-10);
+    for (auto p = 0*np; p < np; ++p) {
+        BOOST_CHECK_CLOSE(states.current.segRates()[np*topSeg + p], 12.0, 1.0e-10);
+    }
+
+    // multisegment wells are not extrapolated
+    checkWellValues("PROD01", 150.0*Opm::unit::barsa, -10.0, states.current);
+}
+
+BOOST_AUTO_TEST_CASE(LimitedBhpChange)
+{
+    const Setup setup{ "msw.data" };
+    ExtrapolationStates states(setup);
+
+    // at most 5 bar instead of 10 bar, the rates are scaled alike
+    states.extrapolate(0.025);
+
+    checkWellValues("INJE01", 205.0*Opm::unit::barsa, 11.0, states.current);
+}
+
+BOOST_AUTO_TEST_CASE(RateSignChange)
+{
+    const Setup setup{ "msw.data" };
+    ExtrapolationStates states(setup);
+    setWellValues("INJE01", 190.0*Opm::unit::barsa, 30.0, states.oldest);
+
+    // the rates would be extrapolated to -10
+    states.extrapolate(1.0);
+
+    checkWellValues("INJE01", 200.0*Opm::unit::barsa, 10.0, states.current);
+}
+
+BOOST_AUTO_TEST_CASE(ControlChange)
+{
+    const Setup setup{ "msw.data" };
+    ExtrapolationStates states(setup);
+
+    const auto w = states.oldest.wellMap().at("INJE01")[0];
+    auto& controls = states.oldest.currentInjectionControls();
+    controls[w] = (controls[w] == Opm::Well::InjectorCMode::BHP)
+        ? Opm::Well::InjectorCMode::RATE
+        : Opm::Well::InjectorCMode::BHP;
+
+    states.extrapolate(1.0);
+
+    checkWellValues("INJE01", 200.0*Opm::unit::barsa, 10.0, states.current);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// ---------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(GroupTree)
+
+namespace {
+    // A well state of the multi-level group deck with group controls, and
+    // distinct rates for every well and phase. The NUPCOL state has
+    // different rates.
+    struct GroupTreeStates
+    {
+        explicit GroupTreeStates(const Setup& setup)
+            : current(buildWellState(setup, 0))
+        {
+            const auto& field = setup.sched.getGroup("FIELD", 0);
+            Opm::WellGroupHelpers::setCmodeGroup(field, setup.sched, setup.st, 0, current);
+
+            const auto np = current.numPhases();
+            for (const auto& entry : current.wellMap()) {
+                const auto w = entry.second[0];
+                const double sign = setup.sched.getWell(entry.first, 0).isProducer() ? -1.0 : 1.0;
+                for (auto p = 0*np; p < np; ++p) {
+                    current.wellRates()[np*w + p] = sign * (10.0*(w + 1) + p + 0.1);
+                    current.wellReservoirRates()[np*w + p] = sign * (12.0*(w + 1) + 2*p + 0.3);
+                }
+            }
+
+            Dune::CollectiveCommunication<Dune::No_Comm> comm;
+            current.updateGlobalIsGrup(setup.sched, 0, comm);
+
+            nupcol = current;
+            for (auto& rate : nupcol.wellRates()) {
+                rate *= 0.9;
+            }
+        }
+
+        Opm::WellStateFullyImplicitBlackoil current;
+        Opm::WellStateFullyImplicitBlackoil nupcol;
+    };
+
+    void checkRates(const Setup& setup,
+                    const Opm::WellStateFullyImplicitBlackoil& wstate,
+                    const bool injector)
+    {
+        namespace WGH = Opm::WellGroupHelpers;
+        const WGH::GroupTree tree(setup.sched, 0, wstate);
+        const auto np = wstate.numPhases();
+        const auto allRates = WGH::sumWellPhaseRatesAllGroups(wstate.wellRates(), tree, wstate, injector);
+
+        for (int g = 0; g < tree.numGroups(); ++g) {
+            const auto& group = setup.sched.getGroup(tree.group(g).name, 0);
+            for (int p = 0; p < np; ++p) {
+                const double expected = WGH::sumWellRates(group, setup.sched, wstate, 0, p, injector);
+                BOOST_CHECK_CLOSE(WGH::sumWellRates(tree, group, wstate, p, injector), expected, 1.0e-12);
+                BOOST_CHECK_CLOSE(allRates[g*np + p], expected, 1.0e-12);
+                BOOST_CHECK_CLOSE(WGH::sumWellResRates(tree, group, wstate, p, injector),
+                                  WGH::sumWellResRates(group, setup.sched, wstate, 0, p, injector), 1.0e-12);
+            }
+        }
+    }
+
+    void checkTargetReductions(const Setup& setup, const GroupTreeStates& states, const bool injector)
+    {
+        namespace WGH = Opm::WellGroupHelpers;
+        const Opm::GuideRate guideRate(setup.sched);
+        const auto np = states.current.numPhases();
+
+        auto fromSchedule = states.current;
+        std::vector<double> reduction(np, 0.0);
+        WGH::updateGroupTargetReduction(setup.sched.getGroup("FIELD", 0), setup.sched, 0, injector,
+                                        setup.pu, guideRate, states.nupcol, fromSchedule, reduction);
+
+        auto fromTree = states.current;
+        const WGH::GroupTree tree(setup.sched, 0, fromTree);
+        WGH::updateGroupTargetReduction(tree, injector, setup.pu, guideRate, states.nupcol, fromTree);
+
+        for (int g = 0; g < tree.numGroups(); ++g) {
+            const auto& name = tree.group(g).name;
+            const auto& expected = injector
+                ? fromSchedule.currentInjectionGroupReductionRates(name)
+                : fromSchedule.currentProductionGroupReductionRates(name);
+            const auto& actual = injector
+                ? fromTree.currentInjectionGroupReductionRates(name)
+                : fromTree.currentProductionGroupReductionRates(name);
+            BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+            for (std::size_t p = 0; p < expected.size(); ++p) {
+                BOOST_CHECK_CLOSE(actual[p], expected[p], 1.0e-12);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Structure)
+{
+    const Setup setup{ "wells_group_tree.data" };
+    const GroupTreeStates states(setup);
+    const Opm::WellGroupHelpers::GroupTree tree(setup.sched, 0, states.current);
+
+    BOOST_CHECK_EQUAL(tree.numGroups(), 5);
+    BOOST_CHECK_EQUAL(tree.numWells(), 7);
+    BOOST_CHECK_EQUAL(tree.groupIndex("FIELD"), 0);
+    BOOST_CHECK_EQUAL(tree.groupIndex("NOSUCHGROUP"), -1);
+
+    // every group comes after its subgroups
+    std::vector<int> position(tree.numGroups(), -1);
+    const auto& order = tree.bottomUpOrder();
+    BOOST_REQUIRE_EQUAL(order.size(), 5U);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
+    for (int g = 0; g < tree.numGroups(); ++g) {
+        for (const int child : tree.childGroups(g)) {
+            BOOST_CHECK_EQUAL(tree.group(child).parent, g);
+            BOOST_CHECK_LT(position[child], position[g]);
+        }
+    }
+
+    // P1 -> M1 -> PLAT -> FIELD
+    const auto path = tree.groupPath(tree.wellIndex("P1"));
+    const std::vector<std::string> expected = { "M1", "PLAT", "FIELD" };
+    BOOST_REQUIRE_EQUAL(path.size(), expected.size());
+    std::size_t i = 0;
+    for (const int g : path) {
+        BOOST_CHECK_EQUAL(tree.group(g).name, expected[i++]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GroupRates)
+{
+    const Setup setup{ "wells_group_tree.data" };
+    const GroupTreeStates states(setup);
+
+    checkRates(setup, states.current, false);
+    checkRates(setup, states.current, true);
+}
+
+BOOST_AUTO_TEST_CASE(GroupRatesTable)
+{
+    // The table has to give exactly the rates of the per-group sums
+    // followed by comm.sum() it replaces in the group constraint checks.
+    namespace WGH = Opm::WellGroupHelpers;
+    using Phases = Opm::BlackoilPhases;
+    const Setup setup{ "wells_group_tree.data" };
+    const GroupTreeStates states(setup);
+    const auto& wstate = states.current;
+    const WGH::GroupTree tree(setup.sched, 0, wstate);
+    Dune::CollectiveCommunication<Dune::No_Comm> comm;
+    const WGH::GroupRates rates(tree, wstate, setup.pu, comm);
+
+    const auto oil = setup.pu.phase_pos[Phases::Liquid];
+    const auto water = setup.pu.phase_pos[Phases::Aqua];
+    const auto gas = setup.pu.phase_pos[Phases::Vapour];
+    const auto np = wstate.numPhases();
+    for (int g = 0; g < tree.numGroups(); ++g) {
+        const auto& name = tree.group(g).name;
+        const auto& group = setup.sched.getGroup(name, 0);
+        for (const bool injector : { false, true }) {
+            for (int p = 0; p < np; ++p) {
+                BOOST_CHECK_EQUAL(rates.surfaceRate(name, p, injector),
+                                  comm.sum(WGH::sumWellRates(group, setup.sched, wstate, 0, p, injector)));
+                BOOST_CHECK_EQUAL(rates.reservoirRate(name, p, injector),
+                                  comm.sum(WGH::sumWellResRates(group, setup.sched, wstate, 0, p, injector)));
+            }
+
+            double resv = 0.0;
+            resv += WGH::sumWellResRates(group, setup.sched, wstate, 0, water, injector);
+            resv += WGH::sumWellResRates(group, setup.sched, wstate, 0, oil, injector);
+            resv += WGH::sumWellResRates(group, setup.sched, wstate, 0, gas, injector);
+            BOOST_CHECK_EQUAL(rates.totalReservoirRate(name, injector), comm.sum(resv));
+        }
+
+        double liquid = 0.0;
+        liquid += WGH::sumWellRates(group, setup.sched, wstate, 0, oil, false);
+        liquid += WGH::sumWellRates(group, setup.sched, wstate, 0, water, false);
+        BOOST_CHECK_EQUAL(rates.liquidRate(name), comm.sum(liquid));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TargetReductions)
+{
+    const Setup setup{ "wells_group_tree.data" };
+    GroupTreeStates states(setup);
+
+    checkTargetReductions(setup, states, false);
+    checkTargetReductions(setup, states, true);
+
+    // a subgroup under individual control contributes its full rate
+    states.current.setCurrentProductionGroupControl("M1", Opm::Group::ProductionCMode::ORAT);
+    states.nupcol.setCurrentProductionGroupControl("M1", Opm::Group::ProductionCMode::ORAT);
+    states.current.setCurrentInjectionGroupControl(Opm::Phase::WATER, "INJG", Opm::Group::InjectionCMode::FLD);
+    checkTargetReductions(setup, states, false);
+    checkTargetReductions(setup, states, true);
+}
+
+BOOST_AUTO_TEST_CASE(GroupControlledWells)
+{
+    namespace WGH = Opm::WellGroupHelpers;
+    const Setup setup{ "wells_group_tree.data" };
+    const GroupTreeStates states(setup);
+    const WGH::GroupTree tree(setup.sched, 0, states.current);
+
+    for (const std::string child : { "", "P2", "P4", "M2" }) {
+        for (int g = 0; g < tree.numGroups(); ++g) {
+            const auto& name = tree.group(g).name;
+            BOOST_CHECK_EQUAL(WGH::groupControlledWells(tree, states.current, g, child),
+                              WGH::groupControlledWells(setup.sched, states.current, 0, name, child));
+        }
+    }
+
+    // P1, P3 and P5 are group controlled, M2 is under individual control.
+    BOOST_CHECK_EQUAL(WGH::groupControlledWells(tree, states.current, 0, ""), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()